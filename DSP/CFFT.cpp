@@ -16,6 +16,53 @@ bool CFFT::Forward(complex *const Data, const unsigned int N)
    return true;
 }
 
+//   FORWARD FOURIER TRANSFORM, PRUNED INPLACE VERSION
+//     Data    - input data (first NonZero entries) and output
+//     N       - length of transform
+//     NonZero - number of input entries, the rest is treated as zero
+//     Outputs - number of result entries needed, the rest is undefined
+bool CFFT::ForwardPruned(complex *const Data, const unsigned int N,
+   const unsigned int NonZero, const unsigned int Outputs)
+{
+   //   Check input parameters
+   if (!Data || N < 1 || N & (N - 1) || NonZero < 1 || NonZero > N
+      || Outputs < 1 || Outputs > N)
+      return false;
+   //   Rearrange nonzero part and skip the stages which only copy it
+   const unsigned int FirstStep = Expand(Data, N, NonZero);
+   //   Call FFT implementation, only for the needed outputs
+   Perform(Data, N, false, FirstStep, Outputs);
+   //   Succeeded
+   return true;
+}
+
+//   Expand bit reversed nonzero input for pruned transform
+//   Input n < L lands at position reverse(n) * N / L. The butterflies of the
+//   first log2(N / L) stages have a zero second term, so they only copy the
+//   value through its block of N / L entries. This is done directly, the
+//   returned step is the first stage which has to be performed.
+unsigned int CFFT::Expand(complex *const Data, const unsigned int N,
+   const unsigned int NonZero)
+{
+   //   Nonzero length rounded up to power of 2, padding is cleared
+   unsigned int L = 1;
+   while (L < NonZero)
+      L <<= 1;
+   for (unsigned int Position = NonZero; Position < L; ++Position)
+      Data[Position] = 0.;
+   //   Bit reversal of the short part
+   Rearrange(Data, L);
+   //   Fill blocks from the end, so no input is overwritten before use
+   const unsigned int Block = N / L;
+   for (unsigned int Position = L; Position-- > 0; )
+   {
+      const complex Value(Data[Position]);
+      for (unsigned int Entry = 0; Entry < Block; ++Entry)
+         Data[Position * Block + Entry] = Value;
+   }
+   return Block;
+}
+
 //   Inplace version of rearrange function
 void CFFT::Rearrange(complex *const Data, const unsigned int N)
 {
@@ -45,11 +92,14 @@ void CFFT::Rearrange(complex *const Data, const unsigned int N)
 
 //   FFT implementation
 void CFFT::Perform(complex *const Data, const unsigned int N,
-   const bool Inverse /* = false */)
+   const bool Inverse /* = false */, const unsigned int FirstStep /* = 1 */,
+   const unsigned int Outputs /* = 0 */)
 {
    const double pi = Inverse ? 3.14159265358979323846 : -3.14159265358979323846;
+   //   All outputs if not given
+   const unsigned int Needed = Outputs ? Outputs : N;
    //   Iteration through dyads, quadruples, octads and so on...
-   for (unsigned int Step = 1; Step < N; Step <<= 1)
+   for (unsigned int Step = FirstStep; Step < N; Step <<= 1)
    {
       //   Jump to the next entry of the same transform factor
       const unsigned int Jump = Step << 1;
@@ -61,20 +111,32 @@ void CFFT::Perform(complex *const Data, const unsigned int N,
       const complex Multiplier(-2. * Sine * Sine, sin(delta));
       //   Start value for transform factor, fi = 0
       complex Factor(1.);
+      //   Only positions below Needed are used by the following stages,
+      //   groups above don't have to be transformed
+      const unsigned int Groups = Step < Needed ? Step : Needed;
       //   Iteration through groups of different transform factor
-      for (unsigned int Group = 0; Group < Step; ++Group)
+      for (unsigned int Group = 0; Group < Groups; ++Group)
       {
-         //   Iteration within group 
-         for (unsigned int Pair = Group; Pair < N; Pair += Jump)
+         //   Transform for fi + pi is not needed
+         if (Group + Step >= Needed)
+         {
+            for (unsigned int Pair = Group; Pair < N; Pair += Jump)
+               Data[Pair] += Factor * Data[Pair + Step];
+         }
+         else
          {
-            //   Match position
-            const unsigned int Match = Pair + Step;
-            //   Second term of two-point transform
-            const complex Product(Factor * Data[Match]);
-            //   Transform for fi + pi
-            Data[Match] = Data[Pair] - Product;
-            //   Transform for fi
-            Data[Pair] += Product;
+            //   Iteration within group 
+            for (unsigned int Pair = Group; Pair < N; Pair += Jump)
+            {
+               //   Match position
+               const unsigned int Match = Pair + Step;
+               //   Second term of two-point transform
+               const complex Product(Factor * Data[Match]);
+               //   Transform for fi + pi
+               Data[Match] = Data[Pair] - Product;
+               //   Transform for fi
+               Data[Pair] += Product;
+            }
          }
          //   Successive transform factor via trigonometric recurrence
          Factor = Multiplier * Factor + Factor;
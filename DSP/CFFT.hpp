@@ -20,6 +20,15 @@ public:
    //     N    - length of both input data and result
    static bool Forward(complex *const Data, const unsigned int N);
 
+   //   FORWARD FOURIER TRANSFORM, PRUNED INPLACE VERSION
+   //   For zero padded input and if only the lower bins are needed
+   //     Data    - input data (first NonZero entries) and output
+   //     N       - length of transform
+   //     NonZero - number of input entries, the rest is treated as zero
+   //     Outputs - number of result entries needed, the rest is undefined
+   static bool ForwardPruned(complex *const Data, const unsigned int N,
+      const unsigned int NonZero, const unsigned int Outputs);
+
    //   INVERSE FOURIER TRANSFORM
    //     Input  - input data
    //     Output - transform result
@@ -41,9 +50,16 @@ protected:
       const unsigned int N);
    static void Rearrange(complex *const Data, const unsigned int N);
 
+   //   Expand bit reversed nonzero input for pruned transform
+   static unsigned int Expand(complex *const Data, const unsigned int N,
+      const unsigned int NonZero);
+
    //   FFT implementation
+   //     FirstStep - first stage to perform (smaller stages are done)
+   //     Outputs   - number of result entries needed
    static void Perform(complex *const Data, const unsigned int N,
-      const bool Inverse = false);
+      const bool Inverse = false, const unsigned int FirstStep = 1,
+      const unsigned int Outputs = 0);
 
    //   Scaling of inverse FFT result
    static void Scale(complex *const Data, const unsigned int N);
@@ -0,0 +1,150 @@
+#include <cmath>
+#include <algorithm>
+#include "Filterbank.hpp"
+
+Filterbank::Filterbank()
+{
+	this->bins_used = 0;
+}
+
+void Filterbank::build(const std::vector<double>& edges, long fft_size, long sample_rate, eFilterbankShape shape, long bins)
+{
+	this->first.clear();
+	this->count.clear();
+	this->offset.clear();
+	this->weights.clear();
+	this->centers.clear();
+	this->bins_used = 0;
+
+	if (bins <= 0)
+		bins = fft_size / 2 + 1;
+	//Floating point - sample_rate / fft_size is not an integer in general
+	double freq_res = (double)sample_rate / fft_size;
+
+	if (shape == eFilterbankTriangle)
+	{
+		for (size_t b = 0; b + 2 < edges.size(); b++)
+			add_band(edges[b], edges[b + 1], edges[b + 2], freq_res, shape, bins);
+	}
+	else
+	{
+		for (size_t b = 0; b + 1 < edges.size(); b++)
+			add_band(edges[b], 0.5 * (edges[b] + edges[b + 1]), edges[b + 1], freq_res, shape, bins);
+	}
+}
+
+void Filterbank::build_octave(long fft_size, long sample_rate, double freq_min, double freq_max, int bands_per_octave, long bins)
+{
+	build(octave_edges(freq_min, freq_max, bands_per_octave), fft_size, sample_rate, eFilterbankRect, bins);
+}
+
+void Filterbank::build_mel(long fft_size, long sample_rate, double freq_min, double freq_max, int bands, long bins)
+{
+	build(mel_edges(freq_min, freq_max, bands), fft_size, sample_rate, eFilterbankTriangle, bins);
+}
+
+std::vector<double> Filterbank::octave_edges(double freq_min, double freq_max, int bands_per_octave)
+{
+	std::vector<double> edges;
+	if ((freq_min <= 0.0) || (bands_per_octave < 1))
+		return edges;
+
+	for (int i = 0; ; i++)
+	{
+		//Last band ends at freq_max
+		double freq = freq_min * pow(2.0, (double)i / bands_per_octave);
+		if (freq >= freq_max * (1.0 - 1e-9))
+		{
+			edges.push_back(freq_max);
+			break;
+		}
+		edges.push_back(freq);
+	}
+	return edges;
+}
+
+std::vector<double> Filterbank::mel_edges(double freq_min, double freq_max, int bands)
+{
+	//bands + 2 points - each triangle uses three of them
+	std::vector<double> edges;
+	double mel_min = 2595.0 * log10(1.0 + freq_min / 700.0);
+	double mel_max = 2595.0 * log10(1.0 + freq_max / 700.0);
+	for (int i = 0; i < bands + 2; i++)
+	{
+		double mel = mel_min + (mel_max - mel_min) * i / (bands + 1);
+		edges.push_back(700.0 * (pow(10.0, mel / 2595.0) - 1.0));
+	}
+	return edges;
+}
+
+void Filterbank::add_band(double freq_low, double freq_center, double freq_high, double freq_res, eFilterbankShape shape, long bins)
+{
+	//Bins with center frequency inside the band
+	long bin_low = (long)ceil(freq_low / freq_res);
+	long bin_high = (long)ceil(freq_high / freq_res) - 1;
+	bin_high = std::min(bin_high, bins - 1);
+
+	this->first.push_back(bin_low);
+	this->offset.push_back((int)this->weights.size());
+	this->centers.push_back(freq_center);
+
+	double sum = 0.0;
+	for (long k = bin_low; k <= bin_high; k++)
+	{
+		double w = 1.0;
+		if (shape == eFilterbankTriangle)
+		{
+			double freq = k * freq_res;
+			if (freq < freq_center)
+				w = (freq - freq_low) / (freq_center - freq_low);
+			else
+				w = (freq_high - freq) / (freq_high - freq_center);
+		}
+		this->weights.push_back(w);
+		sum += w;
+	}
+
+	//Band narrower than the bin spacing - take nearest bin
+	if (sum <= 0.0)
+	{
+		this->weights.resize(this->offset.back());
+		long bin = (long)floor(freq_center / freq_res + 0.5);
+		if (bin >= bins)
+		{
+			//Band is above the spectrum
+			this->count.push_back(0);
+			return;
+		}
+		this->first.back() = bin;
+		this->weights.push_back(1.0);
+		bin_low = bin_high = bin;
+		sum = 1.0;
+	}
+
+	for (size_t j = this->offset.back(); j < this->weights.size(); j++)
+		this->weights[j] /= sum;
+	this->count.push_back((int)(this->weights.size() - this->offset.back()));
+	this->bins_used = std::max(this->bins_used, bin_high + 1);
+}
+
+void Filterbank::apply(const double* in, double* out) const
+{
+	int bands = get_bands();
+	for (int b = 0; b < bands; b++)
+	{
+		const double* w = this->weights.data() + this->offset[b];
+		const double* x = in + this->first[b];
+		int n = this->count[b];
+
+		double sum = 0.0;
+		for (int j = 0; j < n; j++)
+			sum += w[j] * x[j];
+		out[b] = sum;
+	}
+}
+
+void Filterbank::apply(const std::vector<double>& in, std::vector<double>& out) const
+{
+	out.resize(get_bands());
+	apply(in.data(), out.data());
+}
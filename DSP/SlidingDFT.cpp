@@ -0,0 +1,102 @@
+#include <cmath>
+#include <algorithm>
+#include "SlidingDFT.hpp"
+
+SlidingDFT::SlidingDFT(long sample_rate, double damping)
+{
+	this->sample_rate = sample_rate;
+	this->damping = damping;
+	this->history.resize(1);
+	this->mask = 0;
+	this->position = 0;
+}
+
+int SlidingDFT::add_bin(double freq, long length)
+{
+	if (length < 1)
+		length = 1;
+
+	double w = 2.0 * M_PI * freq / this->sample_rate;
+
+	Bin_t bin;
+	bin.length = length;
+	bin.rotation = std::polar(this->damping, w);
+	bin.comb = std::polar(pow(this->damping, (double)length), w * length);
+	bin.value = 0.0;
+	this->bins.push_back(bin);
+
+	resize_history(length);
+	return (int)this->bins.size() - 1;
+}
+
+int SlidingDFT::add_band(double freq_low, double freq_high, long min_length, long max_length)
+{
+	//Main lobe of a bin with length N is about sample_rate / N wide
+	double width = std::max(freq_high - freq_low, 1.0);
+	long length = (long)(this->sample_rate / width);
+	length = std::min(std::max(length, min_length), max_length);
+
+	return add_bin(0.5 * (freq_low + freq_high), length);
+}
+
+void SlidingDFT::clear_bins()
+{
+	this->bins.clear();
+	this->history.resize(1);
+	this->mask = 0;
+	clear();
+}
+
+void SlidingDFT::resize_history(long length)
+{
+	if ((unsigned long)length <= this->history.size())
+		return;
+
+	unsigned long size = this->history.size();
+	while (size < (unsigned long)length)
+		size <<= 1;
+	this->history.resize(size);
+	this->mask = size - 1;
+
+	//Old samples are not in order anymore
+	clear();
+}
+
+void SlidingDFT::clear()
+{
+	std::fill(this->history.begin(), this->history.end(), 0.0);
+	this->position = 0;
+	for (Bin_t& bin : this->bins)
+		bin.value = 0.0;
+}
+
+void SlidingDFT::process(double value)
+{
+	for (Bin_t& bin : this->bins)
+	{
+		//Sample leaving the window of this bin - zero before it was filled
+		double old = this->history[(this->position - bin.length) & this->mask];
+		bin.value = bin.rotation * bin.value + value - bin.comb * old;
+	}
+
+	this->history[this->position & this->mask] = value;
+	this->position++;
+}
+
+void SlidingDFT::process(const buffer<double>& values)
+{
+	long size = values.get_size();
+	for (long i = 0; i < size; i++)
+		process(values[i]);
+}
+
+double SlidingDFT::get_power(int bin) const
+{
+	const Bin_t& b = this->bins[bin];
+	return std::norm(b.value) / b.length;
+}
+
+bool SlidingDFT::ready(int bin) const
+{
+	return this->position >= (unsigned long)this->bins[bin].length;
+}
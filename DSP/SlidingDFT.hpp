@@ -0,0 +1,66 @@
+#ifndef _SLIDING_DFT_H
+#define _SLIDING_DFT_H
+
+#include <vector>
+#include <complex>
+#include "buffer.hpp"
+
+//Default damping - keeps rounding errors of the recursion from accumulating
+#define SLIDING_DFT_DAMPING 0.999999
+
+//Bank of sliding DFT bins
+//Each bin is the DFT of the last N samples at one frequency, updated with every
+//sample by a recursion (cost per sample is one complex multiplication per bin):
+//  S[n] = r * e^(jw) * S[n-1] + x[n] - r^N * e^(jwN) * x[n-N]
+//Frequency and length can be chosen per bin, so a bin can cover a whole band
+//(constant Q). If only a few bins are needed, this is much cheaper than an FFT.
+class SlidingDFT
+{
+public:
+	SlidingDFT(long sample_rate, double damping = SLIDING_DFT_DAMPING);
+
+	//Add bin with frequency in Hz and length in samples - returns index of bin
+	int add_bin(double freq, long length);
+	//Add bin covering the band [freq_low, freq_high] - the length is limited
+	//to [min_length, max_length] samples. Returns index of bin
+	int add_band(double freq_low, double freq_high, long min_length = 32, long max_length = 4096);
+	//Remove all bins
+	void clear_bins();
+	int get_bins() const { return (int)this->bins.size(); }
+
+	//Add samples - all bins are updated
+	void process(const buffer<double>& values);
+	void process(double value);
+	//Reset history and bins
+	void clear();
+
+	//Power of bin, |S|^2 / N
+	double get_power(int bin) const;
+	//Bin has seen N samples
+	bool ready(int bin) const;
+
+private:
+	struct Bin_t
+	{
+		long length;
+		//r * e^(jw)
+		std::complex<double> rotation;
+		//r^N * e^(jwN)
+		std::complex<double> comb;
+		std::complex<double> value;
+	};
+
+	long sample_rate;
+	double damping;
+	std::vector<Bin_t> bins;
+
+	//History of the longest bin - positions count up, the slot is position & mask
+	std::vector<double> history;
+	unsigned long mask;
+	unsigned long position;
+
+	//Resize history for new maximum length
+	void resize_history(long length);
+};
+
+#endif
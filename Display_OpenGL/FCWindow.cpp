@@ -35,6 +35,11 @@ FCWindow::FCWindow(FCWindowParam_t& param)
 	
 	//Set keyboard callback
 	this->pKeyboard = nullptr;
+
+	//Initial draw, static content not yet built
+	this->dirty = true;
+	this->static_list = 0;
+	this->static_valid = false;
 }
 
 FCWindow::~FCWindow()
@@ -83,6 +88,33 @@ void FCWindow::reshape_(int width, int height)
   	glLoadIdentity();
   	gluOrtho2D(0, width, height, 0);
   	glMatrixMode(GL_MODELVIEW);
+	//Layout depends on window size
+	this->invalidate_static();
+	this->invalidate();
+}
+
+void FCWindow::invalidate()
+{
+	this->dirty = true;
+}
+
+void FCWindow::invalidate_static()
+{
+	this->static_valid = false;
+}
+
+void FCWindow::draw_static()
+{
+	//Rebuild list if layout has changed
+	if (this->static_valid.exchange(true) == false)
+	{
+		if (this->static_list == 0)
+			this->static_list = glGenLists(1);
+		glNewList(this->static_list, GL_COMPILE);
+		this->draw_static_();
+		glEndList();
+	}
+	glCallList(this->static_list);
 }
 
 void FCWindow::Keyboard_(unsigned char key, int x, int y)
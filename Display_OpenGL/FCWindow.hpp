@@ -4,6 +4,7 @@
 #include "FCWindowManager.hpp"
 
 #include <string>
+#include <atomic>
 
 //Forward declaration
 class FCWindow;
@@ -73,6 +74,17 @@ protected:
 	//Function pointer for enhancing Keyboard method
 	void (*pKeyboard)(unsigned char, int, int);
 
+	//Redraw handling
+	//Window is only redrawn if marked as dirty (or if GLUT requests it)
+	void invalidate();
+	//Static content (titles, axes) is cached in a display list
+	//Must be called if the layout has changed, the list is rebuilt on next draw
+	void invalidate_static();
+	//Draw static content - only callable from display_
+	void draw_static();
+	//Draw static content into the list - overridden by derived class
+	virtual void draw_static_() { }
+
 private:
 	//Handle for accessing window by ID
 	int handle;
@@ -84,6 +96,12 @@ private:
 	int x, y;
 	//Quit signal
 	bool quit;
+
+	//Redraw flag - set by update methods, cleared before display
+	std::atomic<bool> dirty;
+	//Display list with static content and validity flag
+	unsigned int static_list;
+	std::atomic<bool> static_valid;
 };
 
 #endif
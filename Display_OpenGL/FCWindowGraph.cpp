@@ -56,6 +56,9 @@ void FCWindowGraph::update(FCWindowData_t* data)
 	this->update_data(size, pWindowData);
 		
 	this->graph_mutex.unlock();
+
+	//Redraw with next display cycle
+	this->invalidate();
 }
 
 void FCWindowGraph::display_(void)
@@ -67,14 +70,12 @@ void FCWindowGraph::display_(void)
 	//Specific member callback (called from static base 'display')
 	glutSetWindow(this->get_handle());
 
+	//Clear window and draw cached title and axes
+	glClear(GL_COLOR_BUFFER_BIT);
+	this->draw_static();
+
 	//Protect data
   	this->graph_mutex.lock();
-  	//Specify window for clearance
-	glScissor(this->x_border, this->y_border_bottom, this->get_width() - 2 * this->x_border, this->y_diff);
-	glEnable(GL_SCISSOR_TEST);
-	glClear(GL_COLOR_BUFFER_BIT);
-	glScissor(0, 0, FCWindowManager::get_res_x(), FCWindowManager::get_res_y());
-	glDisable(GL_SCISSOR_TEST);
 	glLineWidth(1.0);
 
 	//Set some color to graph
@@ -86,17 +87,12 @@ void FCWindowGraph::display_(void)
 	for (int i = 0; i < this->data.size(); ++i)
 	{
 		FCWindowColor::set(color[i]);
-		draw_lines(this->data.at(i));
+		draw_lines(i);
 	}
 	
-	//Draw axes
-	FCWindowColor::set(FCWindowColor_e::ColorWhite);
-	this->draw_axes();
-	
 	this->graph_mutex.unlock();
 
   	glutSwapBuffers();
-	glutPostRedisplay();
 }
 
 void FCWindowGraph::reshape_(int width, int height)
@@ -121,14 +117,22 @@ void FCWindowGraph::output(int x, int y, std::string text)
 }
 
 void FCWindowGraph::init()
+{
+	//Calculate auxiliary parameters
+	this->calc_param();
+	
+	//Title and axes are drawn with next display cycle
+	this->invalidate_static();
+	this->invalidate();
+}
+
+void FCWindowGraph::draw_static_()
 {
 	//Display title
+	FCWindowColor::set(FCWindowColor_e::ColorWhite);
 	this->font = GLUT_BITMAP_TIMES_ROMAN_24;
 	this->output(50, 50, "* * * TEMPERATURE GRAPH * * *");
 
-	//Calculate auxiliary parameters
-	this->calc_param();
-	
 	//Draw axes
 	this->draw_axes();
 }
@@ -174,61 +178,80 @@ void FCWindowGraph::draw_axes(void)
 	y_axis.draw();
 }
 
-void FCWindowGraph::draw_lines(std::vector<double>& data)
+void FCWindowGraph::draw_lines(int series)
 {
-  	//Display graph - number of lines is number of points - 1
-  	int num_values = data.size() - 1;
-	for (int i = 0; i < num_values; ++i)
+	//Display graph - window coordinates: x = x_min + index * x_inc, y = y_min - (value * m + n)
+	//The index is the position in the history (0 = oldest value)
+	FCWindowGraphSeries_t& graph = this->data.at(series);
+	glPushMatrix();
+	glTranslatef(this->x_min, this->y_min - this->n, 0.0);
+	glScalef(this->x_inc, -this->m, 1.0);
+
+	if (graph.count < this->size)
 	{
-		//Get data from array and calculate coordinates
-		int x_left = (int)(this->x_min + i * this->x_inc);
-		int x_right = x_left + std::ceil(this->x_inc);
-
-		double lim_val_left = std::max(data.at(i), this->min_y_value);
-		double lim_val_right = std::max(data.at(i + 1), this->min_y_value);
-		lim_val_left = std::min(lim_val_left, this->max_y_value);
-		lim_val_right = std::min(lim_val_right, this->max_y_value);
-		int y_val_left = this->y_min - (int)(lim_val_left * m + n);
-		int y_val_right = this->y_min - (int)(lim_val_right * m + n);
-
-		//Draw line
-		glBegin(GL_LINES);
-		glVertex3f(x_left, y_val_left, 0.0);
-		glVertex3f(x_right, y_val_right, 0.0);
-		glEnd();
-	}	
+		//Ring not yet full - slots equal the index
+		graph.lines.draw(GL_LINE_STRIP, 0, graph.count);
+	}
+	else
+	{
+		//Oldest part: slots head...size-1, including the copy of slot 0 if it follows
+		int count_old = this->size - graph.head + ((graph.head > 0) ? 1 : 0);
+		glTranslatef(-graph.head, 0.0, 0.0);
+		graph.lines.draw(GL_LINE_STRIP, graph.head, count_old);
+		//Newest part: slots 0...head-1
+		glTranslatef(this->size, 0.0, 0.0);
+		graph.lines.draw(GL_LINE_STRIP, 0, graph.head);
+	}
+
+	glPopMatrix();
+}
+
+void FCWindowGraph::stage_slot(FCWindowGraphSeries_t& graph, int slot)
+{
+	//Values are limited to the y axis range
+	double lim_val = std::max(graph.values.at(slot), this->min_y_value);
+	lim_val = std::min(lim_val, this->max_y_value);
+	graph.lines.set(slot, (float)slot, (float)lim_val);
+	//Copy of slot 0 joins the newest and the oldest part of the ring
+	if (slot == 0)
+		graph.lines.set(this->size, (float)this->size, (float)lim_val);
+}
+
+void FCWindowGraph::stage_lines(int series)
+{
+	FCWindowGraphSeries_t& graph = this->data.at(series);
+	int used = std::min(graph.count, this->size);
+	for (int i = 0; i < used; ++i)
+		this->stage_slot(graph, i);
 }
 
 void FCWindowGraph::init_data(int size)
 {
-	//Initialize vector with data vectors
+	//Initialize vector with one history per graph
 	this->data_initialized = true;
-	std::vector<double> init;
+	this->data.resize(size);
 	for (int i = 0; i < size; ++i)
 	{
-		this->data.push_back(init);
-	}	
+		//One vertex per slot and the copy of slot 0
+		this->data.at(i).values.assign(this->size, 0.0);
+		this->data.at(i).lines.resize(this->size + 1);
+	}
 }
 
 void FCWindowGraph::update_data(int size, FCWindowGraphData_t* pData)
 {
 	//We got a few new values inside pData
-	//Add to existing data, if vectors are full, shift values
+	//Add to existing data, if rings are full, the oldest value is overwritten
 	for (int i = 0; i < size; ++i)
 	{
-		int data_size = this->data.at(i).size();
-		if (data_size >= this->size)
-		{
-			for (int j = 0; j < data_size - 1; ++j)
-			{
-				this->data.at(i).at(j) = this->data.at(i).at(j + 1);
-			}	
-			this->data.at(i).at(data_size - 1) = pData->values.at(i);	
-		}
-		else
-		{
-			this->data.at(i).push_back(pData->values.at(i));
-		}
+		FCWindowGraphSeries_t& graph = this->data.at(i);
+		int slot = graph.head;
+		graph.values.at(slot) = pData->values.at(i);
+		graph.head = (graph.head + 1) % this->size;
+		if (graph.count < this->size)
+			graph.count++;
+		//Only the vertices of the written slot change
+		this->stage_slot(graph, slot);
 	}	
 }
 
@@ -247,7 +270,12 @@ void FCWindowGraph::set_param(FCWindowSize_t* param)
 	this->max_y_value     = pParam->max_y_value;
 	this->min_y_value     = pParam->min_y_value;
 
-	//Redraw static content
-	glClear(GL_COLOR_BUFFER_BIT);
+	//Limits have changed - update vertices
+	this->graph_mutex.lock();
+	for (size_t i = 0; i < this->data.size(); ++i)
+		this->stage_lines(i);
+	this->graph_mutex.unlock();
+
+	//Recalculate and redraw static content
 	this->init();
 }
@@ -2,6 +2,7 @@
 #define _FC_WINDOWGRAPH
 
 #include "FCWindow.hpp"
+#include "FCWindowVertexBuffer.hpp"
 
 #include <string>
 #include <vector>
@@ -25,6 +26,17 @@ struct FCWindowGraphData_t : public FCWindowData_t
 	std::vector<double> values;
 };
 
+//History of one graph - ring with fixed capacity
+//Vertex i belongs to ring slot i (x = i). The last vertex is a copy of slot 0
+//with x = capacity, it joins the two parts of the ring when drawing.
+struct FCWindowGraphSeries_t
+{
+	std::vector<double> values;	//Ring of values
+	int head = 0;			//Slot for next value - oldest value if full
+	int count = 0;			//Number of values in ring
+	FCWindowVertexBuffer lines;	//Vertices of the graph lines
+};
+
 //Derived window classes
 //Graph display
 class FCWindowGraph : public FCWindow
@@ -48,8 +60,10 @@ private:
 	//Mutex for data protection
 	std::mutex graph_mutex;
 
-	//Data for graph
-	std::vector<std::vector<double>> data;
+	//Data for graph - one history per graph
+	//Vertices are stored with x = ring slot and y = limited value,
+	//scaling to window coordinates is done with the modelview matrix
+	std::vector<FCWindowGraphSeries_t> data;
 	//Flag indicates that params have been calculated
 	bool params_calculated;
 	//Flag indicates that data vector has been initialized
@@ -85,8 +99,14 @@ private:
 	void calc_param();
 	//Draw axes
 	void draw_axes();
+	//Draw title and axes into cached list
+	void draw_static_();
 	//Draw lines of one graph
-	void draw_lines(std::vector<double>&);
+	void draw_lines(int);
+	//Transfer value in ring slot to vertices
+	void stage_slot(FCWindowGraphSeries_t&, int);
+	//Transfer all values of one graph to its vertices
+	void stage_lines(int);
 	//Init data
 	void init_data(int);
 	//Update data
@@ -27,6 +27,9 @@ void FCWindowLabel::update(FCWindowData_t* data)
 	this->label_mutex.lock();
 	this->text_items.items = pWindowData->items;
 	this->label_mutex.unlock();
+
+	//Redraw with next display cycle
+	this->invalidate();
 }
 
 void FCWindowLabel::display_(void)
@@ -46,7 +49,6 @@ void FCWindowLabel::display_(void)
 	}
 	this->label_mutex.unlock();
   	glutSwapBuffers();
-	glutPostRedisplay();
 }
 
 void FCWindowLabel::output(float x, float y, std::string text)
@@ -120,9 +120,9 @@ void FCWindowManager::display(void)
 	//Check for valid pointer
 	if (current_instance == nullptr)
 		return;
+	//Clear flag first - updates during drawing trigger another redraw
+	current_instance->dirty = false;
 	current_instance->display_();
-	//Wait for a short amount of time - decreases processor usage
-	std::this_thread::sleep_for(std::chrono::milliseconds(FCWindowManager::static_data.sleep));
 }
 
 void FCWindowManager::reshape(int width, int height)
@@ -166,7 +166,22 @@ void FCWindowManager::close(void)
 
 void FCWindowManager::idle(void)
 {
+	//Request redraw of windows with changed content only
+	bool redraw = false;
+	FCWindowManager::static_data.mtx.lock();
+	for (std::pair<const int, FCWindow*>& window : FCWindowManager::static_data.windows)
+	{
+		if (window.second->dirty == true)
+		{
+			glutPostWindowRedisplay(window.first);
+			redraw = true;
+		}
+	}
+	FCWindowManager::static_data.mtx.unlock();
 
+	//Nothing to do - wait for a short amount of time, decreases processor usage
+	if (redraw == false)
+		std::this_thread::sleep_for(std::chrono::milliseconds(FCWindowManager::static_data.sleep));
 }
 
 void FCWindowManager::add_window(FCWindow* window_to_add)
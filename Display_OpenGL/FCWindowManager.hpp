@@ -29,7 +29,7 @@ struct FCWindowCommon_t
 	bool running;						//Flag indicates event loop running
 	std::map<int, FCWindow*> windows;	//Table containing created windows and IDs
 	std::mutex mtx;						//Mutex for static data access
-	unsigned int sleep;					//Sleep value for decreasing processor usage
+	unsigned int sleep;					//Idle sleep if no window has to be redrawn
 	int res_x, res_y;					//Screen resolution
 	int last_handle;					//Last used window handle
 	FCWindow* last_instance;			//Last used window pointer
@@ -8,6 +8,8 @@
 //Graphic drawing constants
 const int SPECTRUM_SIZE_X_MIN = 300;
 const int SPECTRUM_SIZE_Y_MIN = 150;
+//Vertices of one bar (quad)
+const int BAR_VERTICES = 4;
 
 //Cycle time measurement
 //#define ENABLE_CYCLE_TIME_MEASUREMENT
@@ -26,6 +28,8 @@ FCWindowSpectrum::FCWindowSpectrum(FCWindowParam_t& param)
 	//Initialize vector
 	for (int i = 0; i < this->size; i++)
 		this->data.values.push_back(0);
+	//Four vertices per bar
+	this->bars.resize(this->size * BAR_VERTICES);
 
 	//Adjustable graphic parameters
 	this->x_border = 50;
@@ -52,10 +56,23 @@ void FCWindowSpectrum::update(FCWindowData_t* data)
 	//First, cast pointer to derived class
 	FCWindowSpectrumData_t* pWindowData = dynamic_cast<FCWindowSpectrumData_t*>(data);
 	//Protect data
+	bool changed = false;
 	this->spectrum_mutex.lock();
 	for (int i = 0; i < this->size; i++)
+	{
+		//Only changed bars are updated
+		if (this->data.values.at(i) == pWindowData->values.at(i))
+			continue;
 		this->data.values.at(i) = pWindowData->values.at(i);
+		if (this->params_calculated == true)
+			this->stage_bar_height(i);
+		changed = true;
+	}
 	this->spectrum_mutex.unlock();
+
+	//Redraw only if a bar has changed
+	if (changed == true)
+		this->invalidate();
 }
 
 void FCWindowSpectrum::display_(void)
@@ -67,34 +84,15 @@ void FCWindowSpectrum::display_(void)
 	//Specific member callback (called from static base 'display')
 	glutSetWindow(this->get_handle());
 
-	//Specify window for clearance
+	//Clear window and draw cached title and axes
+	glClear(GL_COLOR_BUFFER_BIT);
+	this->draw_static();
+
 	//Protect data
   	this->spectrum_mutex.lock();
-	glScissor(this->x_border, this->y_border_bottom, this->get_width() - 2 * this->x_border, this->y_diff);
-	glEnable(GL_SCISSOR_TEST);
-	glClear(GL_COLOR_BUFFER_BIT);
-	glScissor(0, 0, FCWindowManager::get_res_x(), FCWindowManager::get_res_y());
-	glDisable(GL_SCISSOR_TEST);
 	
-  	//Display spectrum
-	for (int i = 0; i < this->size; i++)
-	{
-		//Get data from array and calculate height
-		int x_bar = this->x_begin + i * this->x_diff;
-		int x_bar2 = x_bar + this->x_size;
-
-		double lim_val = std::max(this->data.values.at(i), this->min_value);
-		lim_val = std::min(lim_val, this->max_value);
-		int y_bar2 = y_bar - (int)(lim_val * m + n);
-
-		//Draw polygon
-		glBegin(GL_POLYGON);
-		glVertex3f(x_bar, y_bar, 0.0);
-		glVertex3f(x_bar2, y_bar, 0.0);
-		glVertex3f(x_bar2, y_bar2, 0.0);
-		glVertex3f(x_bar, y_bar2, 0.0);
-		glEnd();
-	}
+  	//Display spectrum - all bars with one call
+	this->bars.draw(GL_QUADS);
 	
 	this->spectrum_mutex.unlock();
 	
@@ -106,7 +104,6 @@ void FCWindowSpectrum::display_(void)
 	#endif
 
   	glutSwapBuffers();
-	glutPostRedisplay();
 }
 
 void FCWindowSpectrum::reshape_(int width, int height)
@@ -131,14 +128,21 @@ void FCWindowSpectrum::output(int x, int y, std::string text)
 }
 
 void FCWindowSpectrum::init()
+{
+	//Calculate auxiliary parameters
+	this->calc_param();
+	
+	//Title and axes are drawn with next display cycle
+	this->invalidate_static();
+	this->invalidate();
+}
+
+void FCWindowSpectrum::draw_static_()
 {
 	//Display title
 	this->font = GLUT_BITMAP_TIMES_ROMAN_24;
 	this->output(50, 50, "* * * AUDIO SPECTRUM * * *");
 
-	//Calculate auxiliary parameters
-	this->calc_param();
-	
 	//Draw axes
 	this->draw_axes();
 }
@@ -194,11 +198,43 @@ void FCWindowSpectrum::calc_param()
 	std::cout << "y_diff = " << this->y_diff << std::endl;
 	std::cout << "m = " << this->m << std::endl;
 	std::cout << "n = " << this->n << std::endl;
+
+	//Layout has changed - update all vertices
+	this->spectrum_mutex.lock();
+	this->stage_bars();
+	this->spectrum_mutex.unlock();
 	
 	//Calculation finished, set flag
 	this->params_calculated = true;
 }
 
+void FCWindowSpectrum::stage_bars()
+{
+	for (int i = 0; i < this->size; i++)
+	{
+		//Bottom left, bottom right, top right, top left
+		int x_bar = this->x_begin + i * this->x_diff;
+		int x_bar2 = x_bar + this->x_size;
+		this->bars.set(i * BAR_VERTICES, x_bar, this->y_bar);
+		this->bars.set(i * BAR_VERTICES + 1, x_bar2, this->y_bar);
+		this->bars.set_x(i * BAR_VERTICES + 2, x_bar2);
+		this->bars.set_x(i * BAR_VERTICES + 3, x_bar);
+		this->stage_bar_height(i);
+	}
+}
+
+void FCWindowSpectrum::stage_bar_height(int i)
+{
+	//Get data from array and calculate height
+	double lim_val = std::max(this->data.values.at(i), this->min_value);
+	lim_val = std::min(lim_val, this->max_value);
+	int y_bar2 = this->y_bar - (int)(lim_val * this->m + this->n);
+
+	//Only the top vertices move
+	this->bars.set_y(i * BAR_VERTICES + 2, y_bar2);
+	this->bars.set_y(i * BAR_VERTICES + 3, y_bar2);
+}
+
 void FCWindowSpectrum::draw_axes(void)
 {
 	//Draw x axis
@@ -230,7 +266,6 @@ void FCWindowSpectrum::set_param(FCWindowSpectrumSize_t& param)
 	this->max_value       = param.max_value;
 	this->min_value       = param.min_value;
 
-	//Redraw static content
-	glClear(GL_COLOR_BUFFER_BIT);
+	//Recalculate and redraw static content
 	this->init();
 }
@@ -2,6 +2,7 @@
 #define _FC_WINDOWSPECTRUM_H
 
 #include "FCWindow.hpp"
+#include "FCWindowVertexBuffer.hpp"
 #include "Timing.hpp"
 
 #include <string>
@@ -51,6 +52,8 @@ private:
 	//Data for frequency array
 	int size;
 	FCWindowSpectrumData_t data;
+	//Vertices of the bars
+	FCWindowVertexBuffer bars;
 	//Flag indicates that params have been calculated
 	bool params_calculated;
 	
@@ -83,6 +86,12 @@ private:
 	void calc_param();
 	//Draw axes
 	void draw_axes();
+	//Draw title and axes into cached list
+	void draw_static_();
+	//Calculate vertices of all bars
+	void stage_bars();
+	//Calculate top vertices of one bar
+	void stage_bar_height(int);
 	
 	//Member callbacks - must be overridden by derived class
 	void display_(void);
@@ -0,0 +1,144 @@
+//Buffer object functions are part of GL 1.5 - prototypes must be requested
+#define GL_GLEXT_PROTOTYPES
+#include "FCWindowVertexBuffer.hpp"
+
+#include <GL/freeglut.h>
+#include <GL/glext.h>
+#include <cstdio>
+#include <cstring>
+
+//Components per vertex (x, y)
+const int VERTEX_COMPONENTS = 2;
+
+//***********************************************************************************************
+// FCWindowVertexBuffer
+//***********************************************************************************************
+
+FCWindowVertexBuffer::FCWindowVertexBuffer()
+{
+	this->n_vertices = 0;
+	this->dirty_first = 0;
+	this->dirty_last = -1;
+	this->vbo = 0;
+	this->vbo_capacity = 0;
+}
+
+FCWindowVertexBuffer::~FCWindowVertexBuffer()
+{
+	//The buffer object is released with the GL context of the window.
+	//It is not deleted here, because the destructor may run in a thread
+	//without current context.
+}
+
+void FCWindowVertexBuffer::resize(int n)
+{
+	this->n_vertices = n;
+	this->vertices.assign(n * VERTEX_COMPONENTS, 0.0f);
+	this->invalidate();
+}
+
+void FCWindowVertexBuffer::set(int index, float x, float y)
+{
+	this->vertices[index * VERTEX_COMPONENTS] = x;
+	this->vertices[index * VERTEX_COMPONENTS + 1] = y;
+	this->touch(index);
+}
+
+void FCWindowVertexBuffer::set_x(int index, float x)
+{
+	this->vertices[index * VERTEX_COMPONENTS] = x;
+	this->touch(index);
+}
+
+void FCWindowVertexBuffer::set_y(int index, float y)
+{
+	this->vertices[index * VERTEX_COMPONENTS + 1] = y;
+	this->touch(index);
+}
+
+void FCWindowVertexBuffer::invalidate()
+{
+	this->dirty_first = 0;
+	this->dirty_last = this->n_vertices - 1;
+}
+
+void FCWindowVertexBuffer::touch(int index)
+{
+	if (this->dirty_first > this->dirty_last)
+	{
+		this->dirty_first = index;
+		this->dirty_last = index;
+		return;
+	}
+	if (index < this->dirty_first)
+		this->dirty_first = index;
+	if (index > this->dirty_last)
+		this->dirty_last = index;
+}
+
+bool FCWindowVertexBuffer::supported()
+{
+	//Checked with the first context - all windows use the same GL implementation
+	static int result = -1;
+	if (result == -1)
+	{
+		int major = 1, minor = 0;
+		const char* version = (const char*)glGetString(GL_VERSION);
+		const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+		if (version != nullptr)
+			sscanf(version, "%d.%d", &major, &minor);
+		bool core = (major > 1) || ((major == 1) && (minor >= 5));
+		bool ext = (extensions != nullptr) && (strstr(extensions, "GL_ARB_vertex_buffer_object") != nullptr);
+		result = (core || ext) ? 1 : 0;
+	}
+	return (result == 1);
+}
+
+void FCWindowVertexBuffer::upload()
+{
+	//Buffer object is created with the first draw, because the context is needed
+	if (this->vbo == 0)
+		glGenBuffers(1, &this->vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, this->vbo);
+
+	//Reallocate storage if the size has changed - all vertices are uploaded
+	if (this->vbo_capacity != this->n_vertices)
+	{
+		glBufferData(GL_ARRAY_BUFFER, this->vertices.size() * sizeof(float), this->vertices.data(), GL_DYNAMIC_DRAW);
+		this->vbo_capacity = this->n_vertices;
+	}
+	else if (this->dirty_first <= this->dirty_last)
+	{
+		//Only the changed range
+		int offset = this->dirty_first * VERTEX_COMPONENTS;
+		int count = (this->dirty_last - this->dirty_first + 1) * VERTEX_COMPONENTS;
+		glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(float), count * sizeof(float), this->vertices.data() + offset);
+	}
+
+	this->dirty_first = 0;
+	this->dirty_last = -1;
+}
+
+void FCWindowVertexBuffer::draw(unsigned int mode, int first, int count)
+{
+	if ((count <= 0) || (first < 0) || (first + count > this->n_vertices))
+		return;
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	if (FCWindowVertexBuffer::supported() == true)
+	{
+		this->upload();
+		glVertexPointer(VERTEX_COMPONENTS, GL_FLOAT, 0, nullptr);
+		glDrawArrays(mode, first, count);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	else
+	{
+		//Vertex array from client memory
+		glVertexPointer(VERTEX_COMPONENTS, GL_FLOAT, 0, this->vertices.data());
+		glDrawArrays(mode, first, count);
+		this->dirty_first = 0;
+		this->dirty_last = -1;
+	}
+	glDisableClientState(GL_VERTEX_ARRAY);
+}
@@ -0,0 +1,54 @@
+#ifndef _FC_WINDOWVERTEXBUFFER_H
+#define _FC_WINDOWVERTEXBUFFER_H
+
+#include <vector>
+
+//2D vertex buffer for geometry which is drawn every frame
+//Vertices are staged in memory by the update methods (any thread, no GL calls).
+//On draw, only the changed range is uploaded with glBufferSubData and all
+//vertices are drawn with a single call. If buffer objects are not supported
+//(GL < 1.5), the vertices are drawn from client memory as vertex array.
+//Note: the buffer object belongs to the GL context of the window that drew first.
+class FCWindowVertexBuffer
+{
+public:
+	FCWindowVertexBuffer();
+	~FCWindowVertexBuffer();
+
+	//Set number of vertices - all vertices are reset to 0
+	void resize(int);
+	int size() { return this->n_vertices; }
+
+	//Set coordinates of one vertex and mark it as changed
+	void set(int, float, float);
+	void set_x(int, float);
+	void set_y(int, float);
+	//Mark all vertices as changed
+	void invalidate();
+
+	//Upload changes and draw range of vertices with given primitive
+	//Must be called with the GL context of the window
+	void draw(unsigned int, int, int);
+	void draw(unsigned int mode) { this->draw(mode, 0, this->n_vertices); }
+
+private:
+	//Staged vertices - x, y interleaved
+	std::vector<float> vertices;
+	int n_vertices;
+	//Range of changed vertices (first > last if nothing changed)
+	int dirty_first;
+	int dirty_last;
+
+	//Buffer object and number of vertices it can hold
+	unsigned int vbo;
+	int vbo_capacity;
+
+	//Check once if buffer objects can be used
+	static bool supported();
+	//Mark vertex as changed
+	void touch(int);
+	//Upload changed range
+	void upload();
+};
+
+#endif
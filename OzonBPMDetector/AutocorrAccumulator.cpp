@@ -0,0 +1,120 @@
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include "AutocorrAccumulator.hpp"
+
+AutocorrAccumulator::AutocorrAccumulator(double rate, double bpm_min, double half_life)
+{
+	this->rate = rate;
+	this->half_life = half_life;
+	this->max_lag = (long)ceil(60.0 / bpm_min * rate) + 1;
+
+	//Smoothing factors for one value
+	this->mean_factor = exp(-1.0 / (AUTOCORR_ACC_MEAN_TIME * rate));
+	this->forget_factor = pow(0.5, 1.0 / (half_life * rate));
+
+	build();
+}
+
+void AutocorrAccumulator::configure(double bpm_min)
+{
+	long max_lag = (long)ceil(60.0 / bpm_min * this->rate) + 1;
+	if (max_lag <= this->max_lag)
+		return;
+
+	this->max_lag = max_lag;
+	build();
+}
+
+void AutocorrAccumulator::build()
+{
+	this->sums.resize(this->max_lag + 1);
+	this->counts.resize(this->max_lag + 1);
+	this->history.resize(this->max_lag + 1);
+	reset();
+}
+
+void AutocorrAccumulator::reset()
+{
+	std::fill(this->sums.begin(), this->sums.end(), 0.0);
+	std::fill(this->counts.begin(), this->counts.end(), 0.0);
+	this->mean = 0.0;
+	this->first = true;
+	restart();
+}
+
+void AutocorrAccumulator::restart()
+{
+	this->position = 0;
+	this->valid = 0;
+}
+
+void AutocorrAccumulator::process(double value)
+{
+	//Only the variation of the input is of interest
+	if (this->first == true)
+	{
+		this->mean = value;
+		this->first = false;
+	}
+	this->mean = this->mean_factor * this->mean + (1.0 - this->mean_factor) * value;
+	double x = value - this->mean;
+
+	long size = (long)this->history.size();
+	this->history[this->position % size] = x;
+
+	//All lags are forgotten, only the lags with a partner in history get a new product
+	long lags = std::min(this->valid, this->max_lag);
+	for (long k = 0; k <= this->max_lag; k++)
+	{
+		this->sums[k] *= this->forget_factor;
+		this->counts[k] *= this->forget_factor;
+	}
+	for (long k = 0; k <= lags; k++)
+	{
+		this->sums[k] += x * this->history[(this->position - k) % size];
+		this->counts[k] += 1.0;
+	}
+
+	this->position++;
+	this->valid++;
+}
+
+void AutocorrAccumulator::process(const double* values, long size)
+{
+	for (long i = 0; i < size; i++)
+		process(values[i]);
+}
+
+double AutocorrAccumulator::get_lag(long lag)
+{
+	return (this->counts[lag] > 0.0) ? this->sums[lag] / this->counts[lag] : 0.0;
+}
+
+void AutocorrAccumulator::build_autocorr_array(buffer<double>& autocorr_array, double bpm_min, double bpm_max, const std::vector<bool>* window)
+{
+	long size_autocorr = autocorr_array.get_size();
+	double variance = get_lag(0);
+
+	//Calculate lag values -> beats/minute to seconds/beat
+	double min_lag = (double)60 / bpm_max;
+	double max_lag = (double)60 / bpm_min;
+
+	for (long i = 0; i < size_autocorr; i++)
+	{
+		if ((window != nullptr) && ((*window)[i] == false))
+		{
+			autocorr_array[i] = -std::numeric_limits<double>::max();
+			continue;
+		}
+
+		autocorr_array[i] = 0.0;
+		double lag = (min_lag + (max_lag - min_lag) / (double)size_autocorr * (double)i) * this->rate;
+		long lag_samples = (long)lag;
+		double frac = lag - lag_samples;
+		if ((lag_samples + 1 > this->max_lag) || (variance <= 0.0))
+			continue;
+
+		autocorr_array[i] = ((1.0 - frac) * get_lag(lag_samples) + frac * get_lag(lag_samples + 1)) / variance;
+	}
+}
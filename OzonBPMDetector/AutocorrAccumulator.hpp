@@ -0,0 +1,73 @@
+#ifndef _AUTOCORR_ACCUMULATOR_H
+#define _AUTOCORR_ACCUMULATOR_H
+//Purpose: Streaming autocorrelation with running sums per lag
+//Every new value adds its products with the last max_lag values to the lag sums,
+//older products are forgotten exponentially:
+//  S[k] = f * S[k] + x[n] * x[n - k]
+//The cost per value is one update per lag, so a fresh lag profile is available
+//after every value instead of recalculating the whole signal for every lag.
+//The sums are kept over signal gaps (restart), only products within one
+//contiguous segment are added.
+
+#include <vector>
+#include "buffer.hpp"
+
+//Time in seconds until the lag sums have decayed to half
+#define AUTOCORR_ACC_HALF_LIFE 8.0
+//Smoothing time of input mean value (removed from input) in seconds
+#define AUTOCORR_ACC_MEAN_TIME 2.0
+
+class AutocorrAccumulator
+{
+public:
+	//rate is the sample rate of the input in Hz, lags are kept for tempos down to bpm_min
+	AutocorrAccumulator(double rate, double bpm_min, double half_life = AUTOCORR_ACC_HALF_LIFE);
+
+	//Change lower tempo limit - sums are only rebuilt (and cleared) if more lags are needed
+	void configure(double bpm_min);
+	//Clear sums and history
+	void reset();
+	//Start a new contiguous segment - the history is cleared, the sums are kept
+	void restart();
+
+	//Add values - cost per value is one update per lag
+	void process(double value);
+	void process(const double* values, long size);
+
+	//Normalized autocorrelation for the lag grid of DSP::extract_bpm_value
+	//Lags are interpolated linearly between the integer lags. With a window
+	//(see DSP::autocorr_window), only the marked entries are calculated. The values
+	//may be negative, so all others are set to the lowest double.
+	void build_autocorr_array(buffer<double>& autocorr_array, double bpm_min, double bpm_max, const std::vector<bool>* window = nullptr);
+
+	//Number of values in the sums (decayed)
+	double get_count() { return this->counts.empty() ? 0.0 : this->counts[0]; }
+
+private:
+	double rate;
+	double half_life;
+	//Highest lag in samples
+	long max_lag;
+
+	//Lag sums and number of products per lag (both decayed)
+	std::vector<double> sums;
+	std::vector<double> counts;
+	//Last max_lag + 1 values without mean - position counts up, the slot is position % size
+	std::vector<double> history;
+	unsigned long position;
+	//Number of values in history since restart
+	long valid;
+
+	//Input mean value and smoothing factors
+	double mean;
+	bool first;
+	double mean_factor;
+	double forget_factor;
+
+	//Create sums for current lag range
+	void build();
+	//Mean product of lag
+	double get_lag(long lag);
+};
+
+#endif
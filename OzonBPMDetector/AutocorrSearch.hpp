@@ -0,0 +1,88 @@
+#ifndef _AUTOCORR_SEARCH_H
+#define _AUTOCORR_SEARCH_H
+//Purpose: Coarse to fine search on the lag grid of an autocorrelation array
+//Used by DSP::build_autocorr_array_search and the precision chains (Precision.hpp)
+//1. Autocorrelation on every coarse_step-th entry, entries in between are interpolated
+//2. Around the strongest coarse maxima (candidates), all entries are evaluated
+//Entries mapping to the same lag in samples are only evaluated once.
+
+#include <vector>
+#include <algorithm>
+#include "buffer.hpp"
+
+//lag_samples(i) - lag in samples of entry i
+//autocorr(i)    - autocorrelation value of entry i
+//Returns the number of evaluated lags
+template <typename L, typename A>
+long autocorr_search(buffer<double>& autocorr_array, long coarse_step, int candidates, L lag_samples, A autocorr)
+{
+	long size_autocorr = autocorr_array.get_size();
+	if (size_autocorr <= 0)
+		return 0;
+
+	if (coarse_step < 1)
+		coarse_step = 1;
+
+	//Evaluate entry - if the previous entry has the same lag, its value is copied
+	std::vector<bool> exact(size_autocorr, false);
+	long evaluations = 0;
+	auto evaluate = [&](long i)
+	{
+		if (exact[i] == true)
+			return;
+		exact[i] = true;
+		if ((i > 0) && (exact[i - 1] == true) && (lag_samples(i) == lag_samples(i - 1)))
+		{
+			autocorr_array[i] = autocorr_array[i - 1];
+			return;
+		}
+		autocorr_array[i] = autocorr(i);
+		evaluations++;
+	};
+
+	//Coarse grid - last entry is always part of it
+	std::vector<long> coarse;
+	for (long i = 0; i < size_autocorr; i += coarse_step)
+		coarse.push_back(i);
+	if (coarse.back() != size_autocorr - 1)
+		coarse.push_back(size_autocorr - 1);
+	for (size_t c = 0; c < coarse.size(); c++)
+		evaluate(coarse[c]);
+
+	//Linear interpolation in between
+	for (size_t c = 0; c + 1 < coarse.size(); c++)
+	{
+		long i0 = coarse[c];
+		long i1 = coarse[c + 1];
+		for (long i = i0 + 1; i < i1; i++)
+			autocorr_array[i] = autocorr_array[i0] + (autocorr_array[i1] - autocorr_array[i0]) * (double)(i - i0) / (double)(i1 - i0);
+	}
+
+	//Strongest local maxima of the coarse grid
+	std::vector<size_t> maxima;
+	for (size_t c = 0; c < coarse.size(); c++)
+	{
+		double value = autocorr_array[coarse[c]];
+		bool left = (c == 0) || (value >= autocorr_array[coarse[c - 1]]);
+		bool right = (c + 1 == coarse.size()) || (value >= autocorr_array[coarse[c + 1]]);
+		if ((left == true) && (right == true))
+			maxima.push_back(c);
+	}
+	std::sort(maxima.begin(), maxima.end(), [&](size_t a, size_t b) { return autocorr_array[coarse[a]] > autocorr_array[coarse[b]]; });
+	if ((int)maxima.size() > candidates)
+		maxima.resize(candidates);
+
+	//Refine between the neighbouring coarse entries
+	for (size_t m = 0; m < maxima.size(); m++)
+	{
+		size_t c = maxima[m];
+		long i0 = (c == 0) ? coarse[c] : coarse[c - 1] + 1;
+		long i1 = (c + 1 == coarse.size()) ? coarse[c] : coarse[c + 1] - 1;
+		for (long i = i0; i <= i1; i++)
+			evaluate(i);
+	}
+
+	return evaluations;
+}
+
+#endif
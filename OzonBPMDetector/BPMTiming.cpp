@@ -0,0 +1,156 @@
+#include <cmath>
+#include <string>
+#include "BPMTiming.hpp"
+
+void StageHistogram::add(long long ns)
+{
+	//Relaxed order is sufficient - values are statistics only
+	this->buckets[get_bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+	this->count.fetch_add(1, std::memory_order_relaxed);
+	this->sum_ns.fetch_add(ns, std::memory_order_relaxed);
+
+	//Update maximum
+	long long max = this->max_ns.load(std::memory_order_relaxed);
+	while ((ns > max) && (this->max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed) == false))
+		;
+}
+
+void StageHistogram::reset()
+{
+	for (int i = 0; i < TIMING_BUCKETS; i++)
+		this->buckets[i].store(0, std::memory_order_relaxed);
+	this->count.store(0, std::memory_order_relaxed);
+	this->sum_ns.store(0, std::memory_order_relaxed);
+	this->max_ns.store(0, std::memory_order_relaxed);
+}
+
+double StageHistogram::get_percentile(double p)
+{
+	//Find the bucket which contains the p-th value
+	unsigned long total = 0;
+	for (int i = 0; i < TIMING_BUCKETS; i++)
+		total += this->buckets[i].load(std::memory_order_relaxed);
+	if (total == 0)
+		return 0.0;
+
+	unsigned long target = (unsigned long)ceil(p * (double)total);
+	if (target == 0)
+		target = 1;
+
+	unsigned long sum = 0;
+	for (int i = 0; i < TIMING_BUCKETS; i++)
+	{
+		sum += this->buckets[i].load(std::memory_order_relaxed);
+		if (sum >= target)
+		{
+			//The upper limit of the bucket can't exceed the maximum
+			double limit = get_bucket_limit(i);
+			double max = get_max();
+			return (limit < max) ? limit : max;
+		}
+	}
+
+	return get_max();
+}
+
+double StageHistogram::get_max()
+{
+	return this->max_ns.load(std::memory_order_relaxed) / 1000.0;
+}
+
+double StageHistogram::get_mean()
+{
+	unsigned long n = get_count();
+	if (n == 0)
+		return 0.0;
+	return this->sum_ns.load(std::memory_order_relaxed) / 1000.0 / (double)n;
+}
+
+int StageHistogram::get_bucket(long long ns)
+{
+	//Everything below 1us goes into the first bucket
+	double us = ns / 1000.0;
+	if (us <= 1.0)
+		return 0;
+
+	int bucket = (int)(log2(us) * TIMING_BUCKETS_PER_OCTAVE);
+	if (bucket >= TIMING_BUCKETS)
+		bucket = TIMING_BUCKETS - 1;
+	return bucket;
+}
+
+double StageHistogram::get_bucket_limit(int bucket)
+{
+	return pow(2.0, (double)(bucket + 1) / TIMING_BUCKETS_PER_OCTAVE);
+}
+
+long long BPMTiming::elapsed(time_point& t)
+{
+	time_point now = clock::now();
+	long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - t).count();
+	t = now;
+	return ns;
+}
+
+void BPMTiming::add(eStages stage, long long ns)
+{
+	this->stages[stage].add(ns);
+}
+
+void BPMTiming::reset()
+{
+	for (int i = 0; i < eNumberOfStages; i++)
+		this->stages[i].reset();
+}
+
+const char* BPMTiming::get_stage_name(eStages stage)
+{
+	switch (stage)
+	{
+		case eStageBiquad:	return "biquad";
+		case eStageDownsample:	return "downsample";
+		case eStageFFT:		return "fft";
+		case eStageFilter:	return "filter";
+		case eStageOnset:	return "onset";
+		case eStageEnvelope:	return "envelope";
+		case eStageAutocorr:	return "autocorr";
+		case eStageComb:	return "comb";
+		case eStageDebugFiles:	return "debug files";
+		case eStagePeaks:	return "peaks";
+		case eStageTotal:	return "total";
+		default:		return "unknown";
+	}
+}
+
+std::string BPMTiming::get_stage_report(eStages stage)
+{
+	StageHistogram& h = this->stages[stage];
+	if (h.get_count() == 0)
+		return "";
+
+	//Format: 'name: n=... p50=... p95=... p99=... max=... us'
+	std::string s = get_stage_name(stage);
+	s += ": n=" + std::to_string(h.get_count());
+	s += " p50=" + std::to_string((long long)h.get_percentile(0.50));
+	s += " p95=" + std::to_string((long long)h.get_percentile(0.95));
+	s += " p99=" + std::to_string((long long)h.get_percentile(0.99));
+	s += " max=" + std::to_string((long long)h.get_max());
+	s += " us";
+	return s;
+}
+
+std::string BPMTiming::get_report(const std::string& eol)
+{
+	std::string report = "";
+	for (int i = 0; i < eNumberOfStages; i++)
+	{
+		std::string line = get_stage_report((eStages)i);
+		if (line != "")
+			report += line + eol;
+	}
+
+	if (report == "")
+		report = "no timing data" + eol;
+
+	return report;
+}
@@ -0,0 +1,100 @@
+#ifndef _BPM_TIMING_H
+#define _BPM_TIMING_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+//Histogram resolution - 4 buckets per octave, starting at 1us
+//96 buckets cover durations up to 2^24us (~16s)
+#define TIMING_BUCKETS 96
+#define TIMING_BUCKETS_PER_OCTAVE 4
+
+//Enum for the stages of the bpm analysis
+//Used as index into the stage histograms
+enum eStages
+{
+	eStageBiquad,				//Biquad filter cascade
+	eStageDownsample,			//Downsampling (incl. FFT buffer creation)
+	eStageFFT,				//Forward FFT
+	eStageFilter,				//Frequency cut, inverse FFT and scaling
+	eStageOnset,				//STFT and spectral flux novelty curve (algorithm 2 and 3)
+	eStageEnvelope,				//Envelope filter
+	eStageAutocorr,				//Autocorrelation
+	eStageComb,				//Comb filter resonator bank (algorithm 3)
+	eStageDebugFiles,			//Debug file output
+	eStagePeaks,				//Peak detection and BPM extraction
+	eStageTotal,				//Complete calculation
+
+	eNumberOfStages /* used for array size determination */
+};
+
+//Latency histogram of one stage
+//Buckets are logarithmic, so percentiles are accurate to ~19%.
+//All members are atomic: the analyzer thread records, while the
+//socket or main thread may read or reset at the same time.
+class StageHistogram
+{
+public:
+	StageHistogram() { reset(); }
+
+	//Add a duration in ns
+	void add(long long ns);
+	//Clear all values
+	void reset();
+
+	//Getter methods - all durations in us
+	unsigned long get_count() { return this->count.load(std::memory_order_relaxed); }
+	double get_percentile(double p);
+	double get_max();
+	double get_mean();
+
+private:
+	std::atomic<unsigned long> buckets[TIMING_BUCKETS];
+	std::atomic<unsigned long> count;
+	std::atomic<long long> sum_ns;
+	std::atomic<long long> max_ns;
+
+	//Bucket index for a duration and upper bucket limit in us
+	static int get_bucket(long long ns);
+	static double get_bucket_limit(int bucket);
+};
+
+//Stage timers for the bpm analysis
+//Usage:
+//	BPMTiming::time_point t = bpm_timing.begin();
+//	... stage code ...
+//	bpm_timing.lap(eStageBiquad, t);	//records the stage, t is set to now
+//If a stage is executed several times per calculation, elapsed() can be
+//summed up and passed to add() once.
+class BPMTiming
+{
+public:
+	//Monotonic clock - not affected by changes of system time
+	typedef std::chrono::steady_clock clock;
+	typedef clock::time_point time_point;
+
+	//Start a measurement
+	time_point begin() { return clock::now(); }
+	//Get ns since t and set t to now
+	long long elapsed(time_point& t);
+	//Add duration of a stage in ns
+	void add(eStages stage, long long ns);
+	//Add duration since t and set t to now
+	void lap(eStages stage, time_point& t) { add(stage, elapsed(t)); }
+
+	//Clear all histograms
+	void reset();
+
+	//Get name of stage
+	static const char* get_stage_name(eStages stage);
+	//Get one line summary of a stage, empty if stage has no values
+	std::string get_stage_report(eStages stage);
+	//Get summary of all stages, lines separated with eol
+	std::string get_report(const std::string& eol);
+
+private:
+	StageHistogram stages[eNumberOfStages];
+};
+
+#endif
@@ -10,12 +10,15 @@ Biquad::Biquad()
 	Q = 0.707;
 	peakGain_dB = 0.0;
 	z1 = z2 = 0.0;
+	calcFloat();
+	fz1 = fz2 = 0.0f;
 }
 
 Biquad::Biquad(Biquad_FilterType type, double Fc, double Q, double peakGain_dB)
 {
 	setBiquad(type, Fc, Q, peakGain_dB);
 	z1 = z2 = 0.0;
+	fz1 = fz2 = 0.0f;
 }
 
 Biquad::~Biquad()
@@ -64,6 +67,7 @@ void Biquad::setCoeff(Biquad_coeff& coeff)
 	
 	b1 = coeff.b1;
 	b2 = coeff.b2;
+	calcFloat();
 }
 
 void Biquad::reset()
@@ -71,6 +75,17 @@ void Biquad::reset()
 	//Set internal registers to zero
 	this->z1 = 0.0;
 	this->z2 = 0.0;
+	this->fz1 = 0.0f;
+	this->fz2 = 0.0f;
+}
+
+void Biquad::calcFloat()
+{
+	fa0 = (float)a0;
+	fa1 = (float)a1;
+	fa2 = (float)a2;
+	fb1 = (float)b1;
+	fb2 = (float)b2;
 }
 
 void Biquad::calcBiquad()
@@ -186,4 +201,6 @@ void Biquad::calcBiquad()
 		}
 		break;
 	}
+
+	calcFloat();
 }
\ No newline at end of file
@@ -39,14 +39,21 @@ public:
 	void setCoeff(Biquad_coeff& coeff);
 	void reset();
 	double process(double input);
+	//Single precision - own registers, coefficients are rounded from the double ones
+	//The overload is the float instance of P::filter_t (Precision.hpp). Biquad isn't a
+	//template, the coefficient design and the coefficient files stay double.
+	float process(float input);
 
 private:
 	void calcBiquad();
+	void calcFloat();
 
 	Biquad_FilterType type;
 	double a0, a1, a2, b1, b2;
 	double Fc, Q, peakGain_dB;
 	double z1, z2;
+	float fa0, fa1, fa2, fb1, fb2;
+	float fz1, fz2;
 };
 
 //We use inline, which should produce faster code,
@@ -59,4 +66,12 @@ inline double Biquad::process(double input)
 	return output;
 }
 
+inline float Biquad::process(float input)
+{
+	float output = input * fa0 + fz1;
+	fz1 = input * fa1 + fz2 - fb1 * output;
+	fz2 = input * fa2 - fb2 * output;
+	return output;
+}
+
 #endif
\ No newline at end of file
@@ -34,8 +34,8 @@ BiquadCascade::BiquadCascade(Biquad_FilterType type, int order, double Fc)
 	double angle = PI / (double)order / 2;
 
 	//Debug info
-	bool debug = (param_list.get<bool>("debug biquad") == true);
-	int split = param_list.get<int>("split audio");
+	bool debug = (param_list.get<bool>(eParamDebugBiquad) == true);
+	int split = param_list.get<int>(eParamSplitAudio);
 	if (debug == true)
 		my_console.WriteToSplitConsole("Order= " + std::to_string(order) + "; Filters= " + std::to_string(numQ), split);
 
@@ -84,8 +84,8 @@ BiquadCascade::BiquadCascade(Biquad_FilterType type, int order_, double Fc_lower
 	double angle = PI / (double)order / 2;
 	
 	//Debug info
-	bool debug = (param_list.get<bool>("debug biquad") == true);
-	int split = param_list.get<int>("split audio");
+	bool debug = (param_list.get<bool>(eParamDebugBiquad) == true);
+	int split = param_list.get<int>(eParamSplitAudio);
 	if (debug == true)
 		my_console.WriteToSplitConsole("Order= " + std::to_string(order) + "; Filters= " + std::to_string(numQ), split);
 	
@@ -136,8 +136,8 @@ void BiquadCascade::get_param(std::ifstream& file)
 	file.seekg(0, std::ios::beg);
 
 	//Debug info
-	bool debug = (param_list.get<bool>("debug biquad") == true);
-	int split = param_list.get<int>("split audio");
+	bool debug = (param_list.get<bool>(eParamDebugBiquad) == true);
+	int split = param_list.get<int>(eParamSplitAudio);
 
 	//Open file to read parameters
 	for (int i = 0; i < this->order; i++)
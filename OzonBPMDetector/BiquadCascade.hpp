@@ -20,6 +20,7 @@ public:
 	explicit BiquadCascade(int order);	//Manually set coefficients
 	~BiquadCascade();
 	double process(double input);
+	float process(float input);	//Single precision registers
 	void get_param(std::ifstream& file); //Read filter coefficients from IOWA IIR Filter Design Tool
 	void reset();
 	
@@ -38,4 +39,14 @@ inline double BiquadCascade::process(double input)
 	return output;
 }
 
+inline float BiquadCascade::process(float input)
+{
+	float output = input;
+	for (size_t i = 0; i < this->biquads.size(); i++)
+	{
+		output = this->biquads.at(i)->process(output);
+	}
+	return output;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include <cmath>
+#include <algorithm>
+#include "CombTracker.hpp"
+
+CombTracker::CombTracker(double rate, double bpm_min, double bpm_max, double bpm_step)
+{
+	this->rate = rate;
+	this->bpm_min = bpm_min;
+	this->bpm_max = bpm_max;
+	this->bpm_step = bpm_step;
+
+	//Smoothing factors for one sample
+	this->mean_factor = exp(-1.0 / (COMB_MEAN_TIME * rate));
+	this->energy_factor = exp(-1.0 / (COMB_ENERGY_TIME * rate));
+
+	build();
+}
+
+void CombTracker::configure(double bpm_min, double bpm_max)
+{
+	if ((bpm_min == this->bpm_min) && (bpm_max == this->bpm_max))
+		return;
+
+	this->bpm_min = bpm_min;
+	this->bpm_max = bpm_max;
+	build();
+}
+
+void CombTracker::build()
+{
+	this->resonators.clear();
+
+	long offset = 0;
+	for (double bpm = this->bpm_min; bpm <= this->bpm_max + 1e-9; bpm += this->bpm_step)
+	{
+		Resonator r;
+		r.bpm = bpm;
+		double delay = 60.0 / bpm * this->rate;
+		r.delay = (long)delay;
+		r.frac = delay - r.delay;
+		//Same half life in seconds for all resonators
+		r.gain = pow(0.5, delay / (COMB_HALF_LIFE * this->rate));
+		r.offset = offset;
+		r.size = r.delay + 2;
+		r.energy = 0.0;
+		offset += r.size;
+		this->resonators.push_back(r);
+	}
+
+	this->outputs.resize(offset);
+	reset();
+}
+
+void CombTracker::reset()
+{
+	std::fill(this->outputs.begin(), this->outputs.end(), 0.0);
+	for (Resonator& r : this->resonators)
+		r.energy = 0.0;
+	this->position = 0;
+	this->mean = 0.0;
+}
+
+void CombTracker::restart()
+{
+	std::fill(this->outputs.begin(), this->outputs.end(), 0.0);
+	this->position = 0;
+}
+
+void CombTracker::process(double value)
+{
+	//Only the variation of the envelope is of interest
+	this->mean = this->mean_factor * this->mean + (1.0 - this->mean_factor) * value;
+	double x = value - this->mean;
+
+	for (Resonator& r : this->resonators)
+	{
+		double* y = this->outputs.data() + r.offset;
+
+		//Output one period ago - interpolated between the two neighbours
+		double y1 = y[(this->position + r.size - r.delay) % r.size];
+		double y2 = y[(this->position + r.size - r.delay - 1) % r.size];
+		double feedback = (1.0 - r.frac) * y1 + r.frac * y2;
+
+		double out = r.gain * feedback + (1.0 - r.gain) * x;
+		y[this->position % r.size] = out;
+		r.energy = this->energy_factor * r.energy + (1.0 - this->energy_factor) * out * out;
+	}
+
+	this->position++;
+}
+
+void CombTracker::process(const double* values, long size)
+{
+	for (long i = 0; i < size; i++)
+		process(values[i]);
+}
+
+int CombTracker::get_best()
+{
+	int best = 0;
+	for (int i = 1; i < (int)this->resonators.size(); i++)
+	{
+		if (this->resonators[i].energy > this->resonators[best].energy)
+			best = i;
+	}
+	return best;
+}
+
+double CombTracker::get_bpm()
+{
+	if (this->resonators.empty() == true)
+		return 0.0;
+
+	int best = get_best();
+	double bpm = this->resonators[best].bpm;
+
+	//Parabolic interpolation with the neighbours
+	if ((best > 0) && (best < (int)this->resonators.size() - 1))
+	{
+		double e0 = this->resonators[best - 1].energy;
+		double e1 = this->resonators[best].energy;
+		double e2 = this->resonators[best + 1].energy;
+		double denom = e0 - 2.0 * e1 + e2;
+		if (denom < 0.0)
+			bpm += 0.5 * (e0 - e2) / denom * this->bpm_step;
+	}
+
+	return bpm;
+}
+
+double CombTracker::get_phase()
+{
+	if ((this->resonators.empty() == true) || (this->position == 0))
+		return 0.0;
+
+	//Maximum output within the last period is the last beat
+	const Resonator& r = this->resonators[get_best()];
+	const double* y = this->outputs.data() + r.offset;
+
+	long age_max = 0;
+	double y_max = y[(this->position - 1) % r.size];
+	long period = std::min((long)this->position, r.delay);
+	for (long age = 1; age < period; age++)
+	{
+		double value = y[(this->position - 1 - age) % r.size];
+		if (value > y_max)
+		{
+			y_max = value;
+			age_max = age;
+		}
+	}
+
+	return age_max / (r.delay + r.frac);
+}
+
+double CombTracker::get_confidence()
+{
+	if (this->resonators.empty() == true)
+		return 0.0;
+
+	double sum = 0.0;
+	for (const Resonator& r : this->resonators)
+		sum += r.energy;
+	double mean = sum / this->resonators.size();
+
+	return (mean > 0.0) ? this->resonators[get_best()].energy / mean : 0.0;
+}
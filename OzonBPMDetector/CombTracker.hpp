@@ -0,0 +1,86 @@
+#ifndef _COMB_TRACKER_H
+#define _COMB_TRACKER_H
+//Purpose: Tempo and beat phase tracking with a bank of comb filter resonators
+//One resonator per candidate tempo - the delay is one beat period:
+//  y[n] = a * y[n - T] + (1 - a) * x[n]
+//A resonator whose period matches the beats of the onset envelope builds up,
+//its smoothed output energy is the tempo score. The position of the maximum in
+//the last period of the best resonator is the last beat, which gives the phase.
+//Every sample updates all resonators once, there is no batch calculation.
+
+#include <vector>
+
+//Default tempo resolution of the bank in bpm - finer values are interpolated
+#define COMB_BPM_STEP 0.5
+//Time in seconds until the output of a resonator has decayed to half (same for all)
+#define COMB_HALF_LIFE 1.5
+//Smoothing time of resonator energy in seconds
+#define COMB_ENERGY_TIME 1.0
+//Smoothing time of input mean value (removed from input) in seconds
+#define COMB_MEAN_TIME 2.0
+
+class CombTracker
+{
+public:
+	//rate is the sample rate of the onset envelope in Hz
+	CombTracker(double rate, double bpm_min, double bpm_max, double bpm_step = COMB_BPM_STEP);
+
+	//Change tempo range - resonators are only rebuilt if the range has changed
+	void configure(double bpm_min, double bpm_max);
+	//Clear all resonators
+	void reset();
+	//Clear output histories, keep energies - for input which doesn't continue
+	//the previous values (the phase of the old outputs doesn't match anymore)
+	void restart();
+
+	//Add onset envelope values - cost per value is one update per resonator
+	void process(double value);
+	void process(const double* values, long size);
+
+	//Tempo of strongest resonator in bpm (interpolated between resonators)
+	double get_bpm();
+	//Beat phase after the last value: 0 = beat now, 0.5 = half way to the next beat
+	//Only the values since the last reset or restart are considered
+	double get_phase();
+	//Energy of strongest resonator relative to mean energy of all (1 = no tempo)
+	double get_confidence();
+
+private:
+	struct Resonator
+	{
+		double bpm;
+		//Delay in samples - integer and fractional part
+		long delay;
+		double frac;
+		//Feedback gain
+		double gain;
+		//Output history - offset into outputs, size delay + 2
+		long offset;
+		long size;
+		//Smoothed output energy
+		double energy;
+	};
+
+	double rate;
+	double bpm_min;
+	double bpm_max;
+	double bpm_step;
+
+	std::vector<Resonator> resonators;
+	//Output history of all resonators
+	std::vector<double> outputs;
+	//Number of values processed
+	unsigned long position;
+
+	//Input mean value and smoothing factors
+	double mean;
+	double mean_factor;
+	double energy_factor;
+
+	//Create resonators for current range
+	void build();
+	//Index of strongest resonator
+	int get_best();
+};
+
+#endif
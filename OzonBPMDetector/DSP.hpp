@@ -2,6 +2,7 @@
 #define _DSP_H
 
 #include "buffer.hpp"
+#include "AutocorrSearch.hpp"
 #include <limits>
 #include <cmath>
 #include <functional>
@@ -584,6 +585,140 @@ namespace DSP
 		}
 	}
 
+	//Mark the entries of an autocorrelation array (size entries, bpm_min..bpm_max) lying
+	//within +/- width bpm of one of the given tempos - returns the number of marked entries
+	long autocorr_window(long size, double bpm_min, double bpm_max, const std::vector<double>& tempos, double width, std::vector<bool>& window)
+	{
+		window.assign(size, false);
+
+		//Calculate lag values -> beats/minute to seconds/beat
+		double min_lag = (double)60 / bpm_max;
+		double max_lag = (double)60 / bpm_min;
+		double lag_step = (max_lag - min_lag) / (double)size;
+
+		long marked = 0;
+		for (size_t t = 0; t < tempos.size(); t++)
+		{
+			if (tempos[t] <= width)
+				continue;
+
+			//Higher tempo is the lower index
+			long i0 = (long)floor((60.0 / (tempos[t] + width) - min_lag) / lag_step);
+			long i1 = (long)ceil((60.0 / (tempos[t] - width) - min_lag) / lag_step);
+			i0 = std::max(i0, 0L);
+			i1 = std::min(i1, size - 1);
+			for (long i = i0; i <= i1; i++)
+			{
+				if (window[i] == false)
+					marked++;
+				window[i] = true;
+			}
+		}
+		return marked;
+	}
+
+	//Windowed variant of "build_autocorr_array" - only the entries marked in window
+	//(see "autocorr_window") are evaluated, all others are zero. The autocorrelation
+	//values are squared, so zero is never above a real peak.
+	template <typename T>
+	void build_autocorr_array_window(const buffer<T>& inbuffer, buffer<double>& autocorr_array, double bpm_min, double bpm_max, const std::vector<bool>& window)
+	{
+		//Get buffer sizes
+		long size_autocorr = autocorr_array.get_size();
+		long size_inbuffer = inbuffer.get_size();
+
+		//Get sample rate
+		long sample_rate = inbuffer.get_sample_rate();
+
+		//Get mean value and variance
+		double average = DSP::get_mean_value(inbuffer);
+		double variance = DSP::get_variance_value(inbuffer);
+
+		//Calculate lag values -> beats/minute to seconds/beat
+		double min_lag = (double)60 / bpm_max;
+		double max_lag = (double)60 / bpm_min;
+		double lag;
+
+		for (long i = 0; i < size_autocorr; i++)
+		{
+			if (window[i] == false)
+			{
+				autocorr_array[i] = 0.0;
+				continue;
+			}
+			lag = min_lag + (max_lag - min_lag) / (double)size_autocorr * (double)i;
+			autocorr_array[i] = DSP::get_autocorr(lag, inbuffer, size_inbuffer, sample_rate, average, variance);
+		}
+	}
+
+	//Coarse to fine variant of "build_autocorr_array" - returns the number of evaluated lags
+	//See "autocorr_search" (AutocorrSearch.hpp) for the search.
+	//The array can be used like the full one (peaks, envelope), but only the regions
+	//around the candidates are exact.
+	template <typename T>
+	long build_autocorr_array_search(const buffer<T>& inbuffer, buffer<double>& autocorr_array, double bpm_min, double bpm_max, long coarse_step, int candidates)
+	{
+		//Get buffer sizes
+		long size_autocorr = autocorr_array.get_size();
+		long size_inbuffer = inbuffer.get_size();
+
+		//Get sample rate
+		long sample_rate = inbuffer.get_sample_rate();
+
+		//Get mean value and variance
+		double average = DSP::get_mean_value(inbuffer);
+		double variance = DSP::get_variance_value(inbuffer);
+
+		//Calculate lag values -> beats/minute to seconds/beat
+		double min_lag = (double)60 / bpm_max;
+		double max_lag = (double)60 / bpm_min;
+
+		//Lag in samples of an entry - same rounding as "get_autocorr"
+		double time_max = (double)size_inbuffer / sample_rate;
+		auto lag_samples = [&](long i) -> long
+		{
+			double lag = min_lag + (max_lag - min_lag) / (double)size_autocorr * (double)i;
+			return (long)ceil((lag / time_max) * size_inbuffer);
+		};
+		auto autocorr = [&](long i) -> double
+		{
+			double lag = min_lag + (max_lag - min_lag) / (double)size_autocorr * (double)i;
+			return DSP::get_autocorr(lag, inbuffer, size_inbuffer, sample_rate, average, variance);
+		};
+
+		return autocorr_search(autocorr_array, coarse_step, candidates, lag_samples, autocorr);
+	}
+
+	//Like "extract_bpm_value", but the maximum is interpolated with a parabola
+	//through its neighbours, so the result is not bound to the lag grid
+	double extract_bpm_value_interp(const buffer<double>& autocorr_array, double bpm_min, double bpm_max)
+	{
+		//Get buffer size
+		long size = autocorr_array.get_size();
+
+		//Calculate lag values -> beats/minute to seconds/beat
+		double min_lag = (double)60 / bpm_max;
+		double max_lag = (double)60 / bpm_min;
+
+		//Get max value index from autocorr array
+		long index = DSP::get_max_index(autocorr_array);
+		double offset = 0.0;
+		if ((index > 0) && (index < size - 1))
+		{
+			double y0 = autocorr_array[index - 1];
+			double y1 = autocorr_array[index];
+			double y2 = autocorr_array[index + 1];
+			double denom = y0 - 2.0 * y1 + y2;
+			if (denom < 0.0)
+				offset = 0.5 * (y0 - y2) / denom;
+		}
+
+		//Return the calculated bpm value from the interpolated index
+		double bpm_lag = min_lag + (max_lag - min_lag) / size * ((double)index + offset);
+
+		return 60.0 / bpm_lag;
+	}
+
 	double extract_bpm_value(const buffer<double>& autocorr_array, double bpm_min, double bpm_max)
 	{
 		//Get buffer size
@@ -0,0 +1,225 @@
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include "DebugWriter.hpp"
+#include "WAVFile.h"
+
+DebugWriter::DebugWriter(size_t max_bytes)
+{
+	this->max_bytes = max_bytes;
+	this->pending_bytes = 0;
+	this->busy = false;
+	this->running = false;
+	this->written = 0;
+	this->dropped = 0;
+}
+
+DebugWriter::~DebugWriter()
+{
+	stop_writer();
+}
+
+void DebugWriter::start_writer()
+{
+	if (this->running.load() == true)
+		return;
+	this->running.store(true);
+	this->writer = std::thread(&DebugWriter::writer_loop, this);
+}
+
+void DebugWriter::stop_writer()
+{
+	if (this->running.load() == false)
+		return;
+
+	//The thread writes the pending artifacts before it ends
+	this->mtx.lock();
+	this->running.store(false);
+	this->mtx.unlock();
+	this->cv.notify_all();
+
+	if (this->writer.joinable() == true)
+		this->writer.join();
+}
+
+bool DebugWriter::write_wav(const std::string& filename, const buffer<short>& data)
+{
+	if (reserve(data.get_size() * sizeof(short)) == false)
+		return false;
+
+	DebugArtifact artifact;
+	artifact.type = eArtifactWavShort;
+	artifact.filename = filename;
+	artifact.bytes = data.get_size() * sizeof(short);
+	artifact.pcm = std::make_shared<buffer<short>>();
+	artifact.pcm->init_buffer(data.get_size(), data.get_sample_rate());
+	memcpy(artifact.pcm->data(), data.data(), artifact.bytes);
+
+	push(artifact);
+	return true;
+}
+
+bool DebugWriter::write_wav(const std::string& filename, const buffer<double>& data)
+{
+	if (reserve(data.get_size() * sizeof(double)) == false)
+		return false;
+
+	//Scaling is done by the writer
+	DebugArtifact artifact;
+	artifact.type = eArtifactWavDouble;
+	artifact.filename = filename;
+	artifact.bytes = data.get_size() * sizeof(double);
+	artifact.values = std::make_shared<buffer<double>>();
+	artifact.values->init_buffer(data.get_size(), data.get_sample_rate());
+	memcpy(artifact.values->data(), data.data(), artifact.bytes);
+
+	push(artifact);
+	return true;
+}
+
+bool DebugWriter::write_series(const std::string& filename, const buffer<double>& data)
+{
+	if (reserve(data.get_size() * sizeof(double)) == false)
+		return false;
+
+	DebugArtifact artifact;
+	artifact.type = eArtifactSeries;
+	artifact.filename = filename;
+	artifact.bytes = data.get_size() * sizeof(double);
+	artifact.values = std::make_shared<buffer<double>>();
+	artifact.values->init_buffer(data.get_size(), data.get_sample_rate());
+	memcpy(artifact.values->data(), data.data(), artifact.bytes);
+
+	push(artifact);
+	return true;
+}
+
+bool DebugWriter::append_text(const std::string& filename, const std::string& text)
+{
+	if (reserve(text.size()) == false)
+		return false;
+
+	DebugArtifact artifact;
+	artifact.type = eArtifactText;
+	artifact.filename = filename;
+	artifact.bytes = text.size();
+	artifact.text = text;
+
+	push(artifact);
+	return true;
+}
+
+void DebugWriter::flush()
+{
+	std::unique_lock<std::mutex> lock(this->mtx);
+	this->cv_idle.wait(lock, [this]() { return (this->queue.empty() == true) && (this->busy == false); });
+}
+
+bool DebugWriter::reserve(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(this->mtx);
+	if (this->pending_bytes + bytes > this->max_bytes)
+	{
+		this->dropped++;
+		return false;
+	}
+	this->pending_bytes += bytes;
+	return true;
+}
+
+void DebugWriter::push(DebugArtifact& artifact)
+{
+	//Without writer thread, the caller writes the artifact
+	if (this->running.load() == false)
+	{
+		write_artifact(artifact);
+		std::lock_guard<std::mutex> lock(this->mtx);
+		this->pending_bytes -= artifact.bytes;
+		this->written++;
+		return;
+	}
+
+	this->mtx.lock();
+	this->queue.push_back(std::move(artifact));
+	this->mtx.unlock();
+	this->cv.notify_one();
+}
+
+void DebugWriter::writer_loop()
+{
+	std::unique_lock<std::mutex> lock(this->mtx);
+	while (true)
+	{
+		this->cv.wait(lock, [this]() { return (this->queue.empty() == false) || (this->running.load() == false); });
+
+		//Queue is empty only if the writer has been stopped
+		if (this->queue.empty() == true)
+			break;
+
+		DebugArtifact artifact = std::move(this->queue.front());
+		this->queue.pop_front();
+		this->busy = true;
+		lock.unlock();
+
+		write_artifact(artifact);
+		//Release the snapshots before taking the lock again
+		size_t bytes = artifact.bytes;
+		artifact = DebugArtifact();
+
+		lock.lock();
+		this->pending_bytes -= bytes;
+		this->busy = false;
+		this->written++;
+		this->cv_idle.notify_all();
+	}
+}
+
+void DebugWriter::write_artifact(const DebugArtifact& artifact)
+{
+	switch (artifact.type)
+	{
+		case eArtifactWavShort:
+		{
+			WAVFile wavfile;
+			wavfile.set_buffer(*artifact.pcm);
+			std::ofstream file(artifact.filename, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+			wavfile.write_wav_file(file);
+			break;
+		}
+		case eArtifactWavDouble:
+		{
+			//Scale to full short range
+			const buffer<double>& values = *artifact.values;
+			double peak = 0.0;
+			for (long i = 0; i < values.get_size(); i++)
+				peak = std::max(peak, fabs(values[i]));
+			double factor = (peak > 0.0) ? (double)std::numeric_limits<short>::max() / peak : 0.0;
+
+			buffer<short> pcm;
+			pcm.init_buffer(values.get_size(), values.get_sample_rate());
+			for (long i = 0; i < values.get_size(); i++)
+				pcm[i] = (short)(values[i] * factor);
+
+			WAVFile wavfile;
+			wavfile.set_buffer(pcm);
+			std::ofstream file(artifact.filename, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+			wavfile.write_wav_file(file);
+			break;
+		}
+		case eArtifactSeries:
+		{
+			//Raw doubles - e.g. numpy.fromfile(filename, dtype='<f8')
+			std::ofstream file(artifact.filename, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+			file.write((const char*)artifact.values->data(), artifact.values->get_size() * sizeof(double));
+			break;
+		}
+		case eArtifactText:
+		{
+			std::ofstream file(artifact.filename, std::ios_base::out | std::ios_base::app);
+			file << artifact.text;
+			break;
+		}
+	}
+}
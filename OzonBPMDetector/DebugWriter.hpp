@@ -0,0 +1,95 @@
+#ifndef _DEBUG_WRITER_H
+#define _DEBUG_WRITER_H
+//Purpose: Write debug artifacts (wav files, arrays, peak logs) in the background
+//The analyzer only takes a snapshot of the data, the file I/O is done by
+//the writer thread. Pending snapshots are limited to a memory budget,
+//artifacts which don't fit are dropped instead of blocking the caller.
+
+#include <string>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "buffer.hpp"
+
+//Memory budget of pending artifacts in bytes
+#define DEBUG_WRITER_MAX_BYTES (32 * 1024 * 1024)
+
+//Type of artifact - defines how it is serialized
+enum eArtifactType
+{
+	eArtifactWavShort,		//16 bit wav file, samples unchanged
+	eArtifactWavDouble,		//16 bit wav file, samples scaled to full range
+	eArtifactSeries,		//Raw doubles, little endian
+	eArtifactText			//Text appended to file
+};
+
+//Artifact handed to the writer thread
+//The snapshots are shared, so queueing an artifact never copies the data
+struct DebugArtifact
+{
+	eArtifactType type;
+	std::string filename;
+	std::shared_ptr<buffer<short>> pcm;
+	std::shared_ptr<buffer<double>> values;
+	std::string text;
+	//Bytes taken from the budget
+	size_t bytes;
+};
+
+class DebugWriter
+{
+public:
+	DebugWriter(size_t max_bytes = DEBUG_WRITER_MAX_BYTES);
+	~DebugWriter();
+
+	//Start and stop writer thread
+	//Without thread, artifacts are written directly by the caller
+	void start_writer();
+	void stop_writer();
+
+	//Take snapshot of buffer and queue it
+	//Return false if the artifact has been dropped
+	bool write_wav(const std::string& filename, const buffer<short>& data);
+	bool write_wav(const std::string& filename, const buffer<double>& data);
+	bool write_series(const std::string& filename, const buffer<double>& data);
+	bool append_text(const std::string& filename, const std::string& text);
+
+	//Wait until all queued artifacts have been written
+	void flush();
+
+	//Statistics
+	long get_written() { return this->written.load(); }
+	long get_dropped() { return this->dropped.load(); }
+
+private:
+	//Queue and memory budget
+	std::deque<DebugArtifact> queue;
+	size_t max_bytes;
+	size_t pending_bytes;
+	//Artifact is being written by the thread
+	bool busy;
+	std::mutex mtx;
+	std::condition_variable cv;
+	//Signals the end of writing to flush()
+	std::condition_variable cv_idle;
+
+	std::atomic<bool> running;
+	std::thread writer;
+
+	std::atomic<long> written;
+	std::atomic<long> dropped;
+
+	//Take bytes from the budget - false if it is exhausted
+	bool reserve(size_t bytes);
+	//Queue artifact or write it directly
+	void push(DebugArtifact& artifact);
+	//Writer thread function
+	void writer_loop();
+	//Serialize artifact to file
+	void write_artifact(const DebugArtifact& artifact);
+};
+
+#endif
@@ -36,15 +36,15 @@ FCMachine::FCMachine()
 	this->stop = false;
 
 	//Write debug line
-	if (param_list.get<bool>("debug machine") == true)
-		my_console.WriteToSplitConsole("Created FC Machine.", param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugMachine) == true)
+		my_console.WriteToSplitConsole("Created FC Machine.", param_list.get<int>(eParamSplitMain));
 }
 
 FCMachine::~FCMachine()
 {
 	//Write debug line
-	if (param_list.get<bool>("debug machine") == true)
-		my_console.WriteToSplitConsole("Removed FC Machine.", param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugMachine) == true)
+		my_console.WriteToSplitConsole("Removed FC Machine.", param_list.get<int>(eParamSplitMain));
 
 	//Remove member states
 	for (int i = 0; i < eNumberOfStates; i++)
@@ -58,8 +58,8 @@ eError FCMachine::bind_function(void(*function)(), int id)
 	//Check if ID is valid
 	if (id >= eNumberOfStates)
 	{
-		if (param_list.get<bool>("debug machine") == true)
-			my_console.WriteToSplitConsole("FCStateError_InvalidIDNumber " + std::to_string(id), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugMachine) == true)
+			my_console.WriteToSplitConsole("FCStateError_InvalidIDNumber " + std::to_string(id), param_list.get<int>(eParamSplitErrors));
 
 		return eFCStateError_InvalidIDNumber;
 	}
@@ -74,8 +74,8 @@ eError FCMachine::bind_function(FCStates(*function)(), int id)
 	//Check if ID is valid
 	if (id >= eNumberOfStates)
 	{
-		if (param_list.get<bool>("debug machine") == true)
-			my_console.WriteToSplitConsole("FCStateError_InvalidIDNumber " + std::to_string(id), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugMachine) == true)
+			my_console.WriteToSplitConsole("FCStateError_InvalidIDNumber " + std::to_string(id), param_list.get<int>(eParamSplitErrors));
 
 		return eFCStateError_InvalidIDNumber;
 	}
@@ -90,8 +90,8 @@ eError FCMachine::bind_function(int(*function)(), int id)
 	//Check if ID is valid
 	if (id >= eNumberOfStates)
 	{
-		if (param_list.get<bool>("debug machine") == true)
-			my_console.WriteToSplitConsole("FCStateError_InvalidIDNumber " + std::to_string(id), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugMachine) == true)
+			my_console.WriteToSplitConsole("FCStateError_InvalidIDNumber " + std::to_string(id), param_list.get<int>(eParamSplitErrors));
 
 		return eFCStateError_InvalidIDNumber;
 	}
@@ -110,6 +110,8 @@ eError FCMachine::machine_loop()
 	{
 		//Fire execute method of state machine
 		retval = this->execute();
+		//Give the other threads some time - the state functions don't block
+		std::this_thread::sleep_for(std::chrono::microseconds(MACHINE_IDLE));
 	}
 
 	//If this loop ends, it means that there went something wrong inside or a stop command was issued
@@ -120,8 +122,8 @@ eError FCMachine::machine_loop()
 //Stop method
 void FCMachine::machine_stop()
 {
-	if (param_list.get<bool>("debug machine") == true)
-		my_console.WriteToSplitConsole("Stopping machine!", param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugMachine) == true)
+		my_console.WriteToSplitConsole("Stopping machine!", param_list.get<int>(eParamSplitMain));
 
 	//Set the stop flag to true
 	this->stop = true;
@@ -147,8 +149,8 @@ eError FCMachine::execute()
 
 	if (is_initialized == false)
 	{
-		if (param_list.get<bool>("debug machine") == true)
-			my_console.WriteToSplitConsole("FCStateError_FCMachineNotInitialized", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugMachine) == true)
+			my_console.WriteToSplitConsole("FCStateError_FCMachineNotInitialized", param_list.get<int>(eParamSplitErrors));
 
 		return eFCStateError_FCMachineNotInitialized;
 	}
@@ -165,8 +167,8 @@ eError FCMachine::execute()
 		next_id = this->active_state->get_next_id();
 		if (next_id >= this->size_info)
 		{
-			if (param_list.get<bool>("debug machine") == true)
-				my_console.WriteToSplitConsole("FCStateError_InvalidIDNumber " + std::to_string(next_id), param_list.get<int>("split errors"));
+			if (param_list.get<bool>(eParamDebugMachine) == true)
+				my_console.WriteToSplitConsole("FCStateError_InvalidIDNumber " + std::to_string(next_id), param_list.get<int>(eParamSplitErrors));
 
 			return eFCStateError_InvalidIDNumber;
 		}
@@ -200,8 +202,8 @@ eError FCMachine::set_trans(int id)
 	//Check if ID is valid
 	if (id >= eNumberOfStates)
 	{
-		if (param_list.get<bool>("debug machine") == true)
-			my_console.WriteToSplitConsole("FCStateError_InvalidIDNumber " + std::to_string(id), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugMachine) == true)
+			my_console.WriteToSplitConsole("FCStateError_InvalidIDNumber " + std::to_string(id), param_list.get<int>(eParamSplitErrors));
 
 		return eFCStateError_InvalidIDNumber;
 	}
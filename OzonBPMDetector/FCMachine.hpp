@@ -5,6 +5,10 @@
 #include "FCState.hpp"
 #include <thread>
 #include <future>
+#include <chrono>
+
+//Idle time of the machine loop in us
+#define MACHINE_IDLE 1000
 
 //Class for the state machine
 class FCMachine
@@ -59,16 +59,16 @@ FCQueue::FCQueue()
 	this->start = std::chrono::high_resolution_clock::now();
 
 	//Write debug line
-	if (param_list.get<bool>("debug queue") == true)
-		my_console.WriteToSplitConsole("Created and initialized FC queue.", param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugQueue) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitMain), "Created and initialized FC queue.");
 }
 
 FCQueue::~FCQueue()
 {
 	//Destructor
 	//Write debug line
-	if (param_list.get<bool>("debug queue") == true)
-		my_console.WriteToSplitConsole("Removed FC queue.", param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugQueue) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitMain), "Removed FC queue.");
 }
 
 eError FCQueue::push(FCEvent e)
@@ -76,8 +76,8 @@ eError FCQueue::push(FCEvent e)
 	//We check if queue is already full
 	if (this->is_full == true)
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_QueueIsFull", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_QueueIsFull");
 
 		return eFCQueueError_QueueIsFull;
 	}
@@ -89,8 +89,8 @@ eError FCQueue::push(FCEvent e)
 	this->queue[this->write_index] = e;
 
 	//Write debug line
-	if (param_list.get<bool>("debug queue") == true)
-		my_console.WriteToSplitConsole("Pushed event into queue, ID = " + std::to_string(e.ID), param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugQueue) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitMain), "Pushed event into queue, ID = {}", e.ID);
 
 	//Reset the empty flag
 	this->is_empty = false;
@@ -109,8 +109,8 @@ eError FCQueue::push(FCEvent e)
 		this->is_full = true;
 
 		//Write debug line
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("Warning! Queue is full!", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "Warning! Queue is full!");
 	}
 
 	//Release mutex
@@ -127,8 +127,8 @@ FCEvent FCQueue::pop()
 	//We check if the queue is empty
 	if (this->is_empty == true)
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_QueueIsEmpty", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_QueueIsEmpty");
 		
 		//We return error since there's nothing to pop
 		retval.success = false;
@@ -141,8 +141,8 @@ FCEvent FCQueue::pop()
 	//We generate the return value
 	retval = this->queue[this->read_index];
 
-	if (param_list.get<bool>("debug queue") == true)
-		my_console.WriteToSplitConsole("Popped event from queue, ID = " + std::to_string(retval.ID), param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugQueue) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitMain), "Popped event from queue, ID = {}", retval.ID);
 
 	//Reset the full flag
 	this->is_full = false;
@@ -161,8 +161,8 @@ FCEvent FCQueue::pop()
 		this->is_empty = true;
 
 		//Write debug line
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("Warning! Queue is empty!", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "Warning! Queue is empty!");
 	}
 
 	//Release mutex
@@ -187,8 +187,8 @@ int FCQueue::get_reg(int id)
 	//We check if id is valid
 	if (id < 0 || id >= (eLastTimer - 1))
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_InvalidIndex", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_InvalidIndex");
 
 		//We just return 0, if the ID is not defined
 		return 0;
@@ -208,8 +208,8 @@ std::string FCQueue::get_sreg(int id)
 	//We check if id is valid
 	if (id < 0 || id >= (eLastTimer - 1))
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_InvalidIndex", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_InvalidIndex");
 
 		//We just return empty string, if the ID is not defined
 		return "";
@@ -229,8 +229,8 @@ double FCQueue::get_dreg(int id)
 	//We check if id is valid
 	if (id < 0 || id >= (eLastTimer - 1))
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_InvalidIndex", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_InvalidIndex");
 
 		//We just return 0.0, if the ID is not defined
 		return 0.0;
@@ -250,8 +250,8 @@ eError FCQueue::set_reg(int id, int value, bool clear)
 	//We check if id is valid
 	if (id < 0 || id >= (eLastTimer - 1))
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_InvalidIndex", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_InvalidIndex");
 
 		return eFCQueueError_InvalidIndex;
 	}
@@ -276,8 +276,8 @@ eError FCQueue::set_sreg(int id, std::string value, bool clear)
 	//We check if id is valid
 	if (id < 0 || id >= (eLastTimer - 1))
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_InvalidIndex", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_InvalidIndex");
 
 		return eFCQueueError_InvalidIndex;
 	}
@@ -302,8 +302,8 @@ eError FCQueue::set_dreg(int id, double value, bool clear)
 	//We check if id is valid
 	if (id < 0 || id >= (eLastTimer - 1))
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_InvalidIndex", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_InvalidIndex");
 
 		return eFCQueueError_InvalidIndex;
 	}
@@ -328,8 +328,8 @@ void FCQueue::queue_stop()
 	//Lock the mutex
 	this->mtx_queue.lock();
 
-	if (param_list.get<bool>("debug queue") == true)
-		my_console.WriteToSplitConsole("Stopping queue!", param_list.get<int>("split main"));	
+	if (param_list.get<bool>(eParamDebugQueue) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitMain), "Stopping queue!");	
 
 	//Set the stop flag to true
 	this->stop = true;
@@ -369,12 +369,12 @@ eError FCQueue::queue_loop()
 			//Determine the type of function to be executed
 			retval = eval_obj(eval_event);
 
-			if (param_list.get<bool>("debug queue") == true)
+			if (param_list.get<bool>(eParamDebugQueue) == true)
 			{
 				int disp_index = this->write_index - this->read_index;
 				if (disp_index < 0)
 					disp_index = FC_QUEUE_SIZE + disp_index;
-				my_console.WriteToSplitConsole("# of queue elements: " + std::to_string(disp_index), param_list.get<int>("split main"));
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitMain), "# of queue elements: {}", disp_index);
 			
 				std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_WAIT));
 			}
@@ -445,8 +445,8 @@ eError FCQueue::config_timer(int id, FCTimer timer)
 	//We check if id is valid
 	if (id < eLastEvent || id >= eLastTimer)
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_InvalidIndex", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_InvalidIndex");
 
 		return eFCQueueError_InvalidIndex;
 	}
@@ -474,8 +474,8 @@ eError FCQueue::start_timer(int id)
 	//We check if id is valid
 	if (id < eLastEvent || id >= eLastTimer)
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_InvalidIndex", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_InvalidIndex");
 
 		return eFCQueueError_InvalidIndex;
 	}
@@ -505,8 +505,8 @@ eError FCQueue::stop_timer(int id)
 	//We check if id is valid
 	if (id < eLastEvent || id >= eLastTimer)
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_InvalidIndex", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_InvalidIndex");
 
 		return eFCQueueError_InvalidIndex;
 	}
@@ -532,8 +532,8 @@ eError FCQueue::reset_timer(int id)
 	//We check if id is valid
 	if (id < eLastEvent || id >= eLastTimer)
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_InvalidIndex", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_InvalidIndex");
 
 		return eFCQueueError_InvalidIndex;
 	}
@@ -595,8 +595,8 @@ eError FCQueue::set_SIR(void (*function)())
 	//We check if function is valid
 	if (function == nullptr)
 	{
-		if (param_list.get<bool>("debug queue") == true)
-			my_console.WriteToSplitConsole("FCQueueError_FunctionNullPtr", param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugQueue) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCQueueError_FunctionNullPtr");
 
 		return eFCQueueError_FunctionNullPtr;
 	}
@@ -676,8 +676,8 @@ eError FCQueue::eval_obj(T obj)
 
 		default:
 			//This is an error
-			if (param_list.get<bool>("debug queue") == true)
-				my_console.WriteToSplitConsole("FCQueueError_QueueEventInvalid", param_list.get<int>("split main"));
+			if (param_list.get<bool>(eParamDebugQueue) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitMain), "FCQueueError_QueueEventInvalid");
 			retval = eFCQueueError_QueueEventInvalid;
 		break;
 	}
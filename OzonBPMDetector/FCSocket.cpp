@@ -9,35 +9,45 @@
 #include <unistd.h>
 #include <chrono>
 #include <thread>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include <algorithm>
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <netinet/in.h>
 #include "bpm_globals.hpp"
 #include "bpm_param.hpp"
 #include "SplitConsole.hpp"
+#include "BPMTiming.hpp"
 
 //Extern split console instance
 extern SplitConsole my_console;
 //Extern parameter list
 extern ParamList param_list;
+//Extern stage timers
+extern BPMTiming bpm_timing;
 
 FCSocket::FCSocket()
 {
 	//Set init flags
 	this->initialized = true;
 	this->stop = false;
-	this->state = FCSocket_Init;
-	this->data = "";
-	this->mtx = false;
+	this->running = false;
+	this->subscribers = 0;
+	this->epollfd = -1;
+	this->wakefd = -1;
 
 	//Open socket
-	my_console.WriteToSplitConsole("Opening socket...", param_list.get<int>("split main"));
-	this->sockfd = socket(AF_INET, SOCK_STREAM, 0);
+	my_console.WriteToSplitConsole("Opening socket...", param_list.get<int>(eParamSplitMain));
+	this->sockfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
 
 	//Check if socket created successfully
 	if (this->sockfd < 0)
 	{
 		this->initialized = false;
-		my_console.WriteToSplitConsole("Error opening socket! " + std::to_string(this->sockfd), param_list.get<int>("split errors"));
+		my_console.WriteToSplitConsole("Error opening socket! " + std::to_string(this->sockfd), param_list.get<int>(eParamSplitErrors));
 	}
 
 	//Initialize server address and port
@@ -52,7 +62,7 @@ FCSocket::FCSocket()
 	int reuse_retval = setsockopt(this->sockfd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
 	if (this->initialized == false || reuse_retval < 0)
 	{
-		my_console.WriteToSplitConsole("Error setting SO_REUSEADDR: " + std::to_string(reuse_retval), param_list.get<int>("split errors"));
+		my_console.WriteToSplitConsole("Error setting SO_REUSEADDR: " + std::to_string(reuse_retval), param_list.get<int>(eParamSplitErrors));
 		this->initialized = false;
 	}
 
@@ -61,7 +71,35 @@ FCSocket::FCSocket()
 	if (this->initialized == false || bind_retval < 0)
 	{
 		this->initialized = false;
-		my_console.WriteToSplitConsole("Error binding socket! " + std::to_string(bind_retval), param_list.get<int>("split errors"));
+		my_console.WriteToSplitConsole("Error binding socket! " + std::to_string(bind_retval), param_list.get<int>(eParamSplitErrors));
+	}
+
+	//Create event poll and stop event
+	if (this->initialized == true)
+	{
+		this->epollfd = epoll_create1(0);
+		this->wakefd = eventfd(0, EFD_NONBLOCK);
+		if (this->epollfd < 0 || this->wakefd < 0)
+		{
+			this->initialized = false;
+			my_console.WriteToSplitConsole("Error creating epoll instance!", param_list.get<int>(eParamSplitErrors));
+		}
+	}
+
+	//Register listening socket and stop event
+	if (this->initialized == true)
+	{
+		epoll_event ev;
+		ev.events = EPOLLIN;
+		ev.data.fd = this->sockfd;
+		int ctl_listen = epoll_ctl(this->epollfd, EPOLL_CTL_ADD, this->sockfd, &ev);
+		ev.data.fd = this->wakefd;
+		int ctl_wake = epoll_ctl(this->epollfd, EPOLL_CTL_ADD, this->wakefd, &ev);
+		if (ctl_listen < 0 || ctl_wake < 0)
+		{
+			this->initialized = false;
+			my_console.WriteToSplitConsole("Error registering socket with epoll!", param_list.get<int>(eParamSplitErrors));
+		}
 	}
 
 	//Start listening on socket
@@ -71,7 +109,8 @@ FCSocket::FCSocket()
 
 FCSocket::~FCSocket()
 {
-
+	//If the listener thread has not been started, nobody closed the handles
+	close_all();
 }
 
 eError FCSocket::check_init()
@@ -87,7 +126,10 @@ std::future<eError> FCSocket::start_listening()
 	//Start thread
 	std::future<eError> result;
 	if (this->initialized == true)
+	{
+		this->running = true;
 		result = std::async(std::launch::async, &FCSocket::listening, this);
+	}
 	return result;
 }
 
@@ -95,154 +137,433 @@ void FCSocket::stop_listening()
 {
 	//Set stop flag
 	this->stop = true;
-	//Close connections
-	shutdown(this->newsockfd, SHUT_RDWR);
-	shutdown(this->sockfd, SHUT_RDWR);
-	close(this->newsockfd);
-	close(this->sockfd);
+
+	//Wake up listener thread - it closes all connections itself
+	this->frames_mtx.lock();
+	bool running = this->running;
+	int write_retval = 0;
+	if (running == true)
+	{
+		uint64_t one = 1;
+		write_retval = write(this->wakefd, &one, sizeof(one));
+	}
+	this->frames_mtx.unlock();
+
+	if (write_retval < 0)
+		my_console.WriteToSplitConsole("Error waking up socket listener!", param_list.get<int>(eParamSplitErrors));
+	if (running == false)
+		close_all();
 }
 
 void FCSocket::get_buffer(std::string& s)
 {
-	//Check mutex status
-	while (this->mtx == true)
-		//do nothing...
-	this->mtx = true;
-	s = this->data;
-	this->data = "";
-	this->mtx = false;
+	//Pop oldest command
+	std::lock_guard<std::mutex> lock(this->mtx);
+	if (this->commands.empty() == true)
+	{
+		s = "";
+		return;
+	}
+	s = this->commands.front();
+	this->commands.pop_front();
+}
+
+void FCSocket::push_command(const std::string& message)
+{
+	//If the application doesn't fetch the commands, the oldest is dropped
+	std::lock_guard<std::mutex> lock(this->mtx);
+	if (this->commands.size() >= COMMAND_QUEUE_SIZE)
+		this->commands.pop_front();
+	this->commands.push_back(message);
 }
 
 eError FCSocket::listening()
 {
 	//Loop function for TCP connections
+	//One thread serves all clients - the thread sleeps in epoll_wait
+	//until a socket is ready or stop_listening() is called
 	//Check proper initialization
 	eError retval = check_init();
 	if (retval != eSuccess)
 		return retval;
 
-	//Return values
-	int read_retval, write_retval;
-	//Message
-	std::string message;
-	bool cmd_ok;
+	epoll_event events[MAX_EVENTS];
 
 	while (this->stop == false && retval == eSuccess)
 	{
-		switch(this->state)
+		int n = epoll_wait(this->epollfd, events, MAX_EVENTS, -1);
+		if (n < 0)
 		{
-			case FCSocket_Init:
-				this->state = FCSocket_Accept;
-				break;
+			//Interrupted by signal - just wait again
+			if (errno == EINTR)
+				continue;
+			my_console.WriteToSplitConsole("Error on epoll_wait! " + std::to_string(errno), param_list.get<int>(eParamSplitErrors));
+			retval = eSocketOperationFailed;
+			break;
+		}
 
-			case FCSocket_Accept:
-				//Accept incoming connection
-				//Accept blocks thread until connection happens from client
-				this->clilen = sizeof(this->cli_addr);
-				this->newsockfd = accept(this->sockfd, (sockaddr*) &this->cli_addr, &this->clilen);
-				if (this->newsockfd < 0)
-				{
-					my_console.WriteToSplitConsole("Error on accept! " + std::to_string(this->newsockfd), param_list.get<int>("split errors"));
-					retval = eSocketOperationFailed;
-				}
-				else
+		for (int i = 0; i < n; i++)
+		{
+			int fd = events[i].data.fd;
+
+			//Wake up event - stop or telemetry frames
+			if (fd == this->wakefd)
+			{
+				uint64_t value;
+				if (read(this->wakefd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+					my_console.WriteToSplitConsole("Error reading wake up event!", param_list.get<int>(eParamSplitErrors));
+				send_frames();
+				continue;
+			}
+
+			//New connections
+			if (fd == this->sockfd)
+			{
+				accept_clients();
+				continue;
+			}
+
+			//Client event - client may have been closed in this loop
+			std::map<int, FCSocketClient>::iterator iter = this->clients.find(fd);
+			if (iter == this->clients.end())
+				continue;
+
+			if ((events[i].events & (EPOLLERR | EPOLLHUP)) != 0)
+			{
+				my_console.WriteToSplitConsole("Disconnect.", param_list.get<int>(eParamSplitMain));
+				close_client(fd);
+				continue;
+			}
+			if ((events[i].events & EPOLLOUT) != 0)
+			{
+				if (write_client(iter->second) == false)
 				{
-					//Connection accepted
-					//Send welcome message
-					write_retval = write(this->newsockfd, this->response_welcome.c_str(), this->response_welcome.length());
-					if (write_retval < 0)
-					{
-						my_console.WriteToSplitConsole("Error writing to socket!", param_list.get<int>("split errors"));
-						retval = eSocketOperationFailed;
-					}
-					else
-					{
-						my_console.WriteToSplitConsole("Client connected.", param_list.get<int>("split main"));
-						this->state = FCSocket_Read;
-					}
+					close_client(fd);
+					continue;
 				}
-				break;
+			}
+			if ((events[i].events & EPOLLIN) != 0)
+				read_client(iter->second);
+		}
+	}
 
-			case FCSocket_Read:
-				//Set buffer to zero
-				bzero(this->buffer, BUFFER_SIZE);
-		
-				//Read incoming data
-				//Read blocks until data is available
-				read_retval = read(this->newsockfd, this->buffer, BUFFER_SIZE - 1);
-				if (read_retval < 0)
-				{
-					my_console.WriteToSplitConsole("Error reading from socket!", param_list.get<int>("split errors"));
-					retval = eSocketOperationFailed;
-				}
-				else if (read_retval == 0)
-				{
-					my_console.WriteToSplitConsole("Disconnect.", param_list.get<int>("split main"));
-					
-					//Set next state
-					this->state = FCSocket_Disconnect;
-				}
-				else	
-				{
-					check_buffer();
-					message = std::string(this->buffer);
-					my_console.WriteToSplitConsole("Socket message: " + message, param_list.get<int>("split main"));
-				
-					//Process the message
-					cmd_ok = process_message(message);
-
-					//Provide data to outside user
-					//If read access is ongoing, we wait...
-					while (this->mtx == true)
-						//do nothing...
-					this->mtx = true;
-					this->data = message;
-					this->mtx = false;
-
-					//Set next state
-					this->state = FCSocket_Response;
-				}
+	//Close connections - no more frames are published from now on
+	this->frames_mtx.lock();
+	this->running = false;
+	this->frames_mtx.unlock();
+	close_all();
+
+	return retval;
+}
+
+void FCSocket::accept_clients()
+{
+	//Accept all pending connections
+	while (true)
+	{
+		sockaddr_in cli_addr;
+		socklen_t clilen = sizeof(cli_addr);
+		int newsockfd = accept4(this->sockfd, (sockaddr*) &cli_addr, &clilen, SOCK_NONBLOCK);
+		if (newsockfd < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				my_console.WriteToSplitConsole("Error on accept! " + std::to_string(errno), param_list.get<int>(eParamSplitErrors));
+			return;
+		}
+
+		//Check number of clients
+		if (this->clients.size() >= MAX_CLIENTS)
+		{
+			my_console.WriteToSplitConsole("Too many clients, connection refused.", param_list.get<int>(eParamSplitErrors));
+			close(newsockfd);
+			continue;
+		}
+
+		//Register client
+		epoll_event ev;
+		ev.events = EPOLLIN;
+		ev.data.fd = newsockfd;
+		if (epoll_ctl(this->epollfd, EPOLL_CTL_ADD, newsockfd, &ev) < 0)
+		{
+			my_console.WriteToSplitConsole("Error registering client with epoll!", param_list.get<int>(eParamSplitErrors));
+			close(newsockfd);
+			continue;
+		}
+
+		FCSocketClient& client = this->clients[newsockfd];
+		client.fd = newsockfd;
+		client.subscribed = false;
+		my_console.WriteToSplitConsole("Client connected.", param_list.get<int>(eParamSplitMain));
+
+		//Send welcome message
+		send_client(client, this->response_welcome);
+	}
+}
+
+void FCSocket::read_client(FCSocketClient& client)
+{
+	//Read until no more data is available
+	char buffer[BUFFER_SIZE];
+	int fd = client.fd;
+	bool eof = false;
+	while (true)
+	{
+		ssize_t read_retval = read(fd, buffer, BUFFER_SIZE);
+		if (read_retval > 0)
+		{
+			client.in.append(buffer, read_retval);
+			continue;
+		}
+		if (read_retval == 0)
+		{
+			//Client has finished sending - pending data is processed before closing
+			eof = true;
+			break;
+		}
+		if (errno == EINTR)
+			continue;
+		if (errno != EAGAIN && errno != EWOULDBLOCK)
+		{
+			my_console.WriteToSplitConsole("Error reading from socket!", param_list.get<int>(eParamSplitErrors));
+			close_client(fd);
+			return;
+		}
+		break;
+	}
+
+	//Process complete lines
+	//A line longer than the maximum message length is processed as well,
+	//after end of file also the rest without line ending
+	while (true)
+	{
+		std::size_t pos = client.in.find_first_of("\r\n");
+		if (pos == std::string::npos)
+		{
+			if ((eof == true) && (client.in.empty() == false))
+				pos = std::min(client.in.length(), (std::size_t)(BUFFER_SIZE - 1));
+			else if (client.in.length() < BUFFER_SIZE - 1)
 				break;
+			else
+				pos = BUFFER_SIZE - 1;
+		}
 
-			case FCSocket_Response:
-				//Send back response
-				if (cmd_ok == true)
-					write_retval = write(this->newsockfd, this->response_ok.c_str(), this->response_ok.length());
-				else
-					write_retval = write(this->newsockfd, this->response_not_ok.c_str(), this->response_not_ok.length());
-				
-				if (write_retval < 0)
-				{
-					my_console.WriteToSplitConsole("Error writing to socket!", param_list.get<int>("split errors"));
-					retval = eSocketOperationFailed;
-				}
-				else
-				{
-					//Set next state
-					this->state = FCSocket_Read;
-				}
+		std::string message = client.in.substr(0, pos);
+		client.in.erase(0, pos);
+		//Remove line ending
+		std::size_t next = client.in.find_first_not_of("\r\n");
+		client.in.erase(0, (next == std::string::npos) ? client.in.length() : next);
+
+		check_buffer(message);
+		if (message == "")
+			continue;
+		my_console.WriteToSplitConsole("Socket message: " + message, param_list.get<int>(eParamSplitMain));
+
+		//Subscription is handled per client
+		if (message == "s:bpm" || message == "s:off")
+		{
+			set_subscribed(client, (message == "s:bpm"));
+			send_client(client, (message == "s:bpm") ? "- SUBSCRIBED -\r\n" : "- UNSUBSCRIBED -\r\n");
+			if (this->clients.find(fd) == this->clients.end())
+				return;
+			continue;
+		}
+
+		//Process the message
+		std::string response;
+		if (process_message(message, response) == true)
+			send_client(client, response);
+		else
+			send_client(client, this->response_not_ok);
+
+		//Provide data to outside user
+		push_command(message);
+
+		//Client may have been closed during send
+		if (this->clients.find(fd) == this->clients.end())
+			return;
+	}
+
+	if (eof == true)
+	{
+		my_console.WriteToSplitConsole("Disconnect.", param_list.get<int>(eParamSplitMain));
+		close_client(fd);
+	}
+}
+
+void FCSocket::send_client(FCSocketClient& client, const std::string& s)
+{
+	//Queue data and try to send immediately
+	bool pending = (client.out.empty() == false);
+	client.out += s;
+	if (pending == true)
+		return;
+	if (write_client(client) == false)
+		close_client(client.fd);
+}
+
+bool FCSocket::write_client(FCSocketClient& client)
+{
+	//Write as much as the socket accepts
+	while (client.out.empty() == false)
+	{
+		ssize_t write_retval = send(client.fd, client.out.c_str(), client.out.length(), MSG_NOSIGNAL);
+		if (write_retval < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
 				break;
+			my_console.WriteToSplitConsole("Error writing to socket!", param_list.get<int>(eParamSplitErrors));
+			return false;
+		}
+		client.out.erase(0, write_retval);
+	}
 
-			case FCSocket_Disconnect:
-				//Client disconnected
-				close(this->newsockfd);
+	//Wait for writable socket only while data is pending
+	epoll_event ev;
+	ev.events = EPOLLIN;
+	if (client.out.empty() == false)
+		ev.events |= EPOLLOUT;
+	ev.data.fd = client.fd;
+	epoll_ctl(this->epollfd, EPOLL_CTL_MOD, client.fd, &ev);
+
+	return true;
+}
 
-				//Set next state
-				this->state = FCSocket_Accept;
+void FCSocket::publish(const FCTelemetry& telemetry)
+{
+	if (this->subscribers == 0 || this->running == false)
+		return;
+
+	//Serialize frame - little endian
+	char frame[TELEMETRY_FRAME_SIZE];
+	int pos = 0;
+	auto put = [&](unsigned long long value, int bytes)
+	{
+		for (int i = 0; i < bytes; i++)
+			frame[pos++] = (char)((value >> (8 * i)) & 0xFF);
+	};
+	auto put_float = [&](double value)
+	{
+		float f = (float)value;
+		uint32_t bits;
+		memcpy(&bits, &f, sizeof(bits));
+		put(bits, 4);
+	};
+	put(TELEMETRY_FRAME_SIZE - 2, 2);
+	put(TELEMETRY_TYPE_BPM, 1);
+	put(TELEMETRY_VERSION, 1);
+	put(telemetry.timestamp, 8);
+	put_float(telemetry.bpm_raw);
+	put_float(telemetry.bpm_smoothed);
+	put_float(telemetry.rms);
+	put((unsigned long long)telemetry.duration, 4);
+	put_float(telemetry.confidence);
+	put_float(telemetry.phase);
+
+	//Queue frame - oldest frame is dropped if listener can't keep up
+	this->frames_mtx.lock();
+	if (this->frames.size() >= TELEMETRY_QUEUE_SIZE)
+		this->frames.pop_front();
+	this->frames.push_back(std::string(frame, TELEMETRY_FRAME_SIZE));
+
+	//Wake up listener thread - inside the lock, so the handle can't be
+	//closed meanwhile
+	uint64_t one = 1;
+	int write_retval = -1;
+	if (this->running == true)
+		write_retval = write(this->wakefd, &one, sizeof(one));
+	this->frames_mtx.unlock();
+
+	if (write_retval < 0)
+		my_console.WriteToSplitConsole("Error waking up socket listener!", param_list.get<int>(eParamSplitErrors));
+}
+
+void FCSocket::send_frames()
+{
+	//Take pending frames
+	std::deque<std::string> pending;
+	this->frames_mtx.lock();
+	pending.swap(this->frames);
+	this->frames_mtx.unlock();
+
+	//Send to all subscribed clients
+	std::vector<int> fds;
+	for (std::map<int, FCSocketClient>::iterator iter = this->clients.begin(); iter != this->clients.end(); ++iter)
+		if (iter->second.subscribed == true)
+			fds.push_back(iter->first);
+
+	for (std::size_t i = 0; i < fds.size(); i++)
+	{
+		for (std::size_t j = 0; j < pending.size(); j++)
+		{
+			//Client may have been closed during send
+			std::map<int, FCSocketClient>::iterator iter = this->clients.find(fds[i]);
+			if (iter == this->clients.end())
 				break;
+			//Slow client - frame is dropped
+			if (iter->second.out.length() + pending[j].length() > MAX_CLIENT_BUFFER)
+				continue;
+			send_client(iter->second, pending[j]);
 		}
-		
 	}
+}
 
-	return retval;
+void FCSocket::set_subscribed(FCSocketClient& client, bool subscribed)
+{
+	if (client.subscribed == subscribed)
+		return;
+	client.subscribed = subscribed;
+	if (subscribed == true)
+		this->subscribers++;
+	else
+		this->subscribers--;
 }
 
-bool FCSocket::process_message(std::string& message)
+void FCSocket::close_client(int fd)
+{
+	std::map<int, FCSocketClient>::iterator iter = this->clients.find(fd);
+	if (iter != this->clients.end())
+		set_subscribed(iter->second, false);
+	epoll_ctl(this->epollfd, EPOLL_CTL_DEL, fd, nullptr);
+	shutdown(fd, SHUT_RDWR);
+	close(fd);
+	this->clients.erase(fd);
+}
+
+void FCSocket::close_all()
+{
+	//Close clients
+	while (this->clients.empty() == false)
+		close_client(this->clients.begin()->first);
+
+	//Close handles
+	if (this->sockfd >= 0)
+	{
+		shutdown(this->sockfd, SHUT_RDWR);
+		close(this->sockfd);
+		this->sockfd = -1;
+	}
+	if (this->epollfd >= 0)
+	{
+		close(this->epollfd);
+		this->epollfd = -1;
+	}
+	if (this->wakefd >= 0)
+	{
+		close(this->wakefd);
+		this->wakefd = -1;
+	}
+}
+
+bool FCSocket::process_message(std::string& message, std::string& response)
 {
 	//Command format:
 	//'p:[param_name], [value]'
 	//'g:[param_name]
 	//'c:[command] [param]
+	//'t:' or 't:reset'
+	//'s:bpm' or 's:off' - subscription, handled in read_client()
 	//Check if known command
 	std::string cmd = message.substr(0, 2);
 	//p command - set parameter
@@ -296,7 +617,7 @@ bool FCSocket::process_message(std::string& message)
 				break;
 		}
 
-		this->response_ok = "- PARAM OK -\r\n";
+		response = "- PARAM OK -\r\n";
 		return true;
 	}
 	//g command - get parameter
@@ -327,7 +648,7 @@ bool FCSocket::process_message(std::string& message)
 				break;
 		}
 
-		this->response_ok = param_response + "\r\n";
+		response = param_response + "\r\n";
 
 		return true;
 	}
@@ -358,22 +679,40 @@ bool FCSocket::process_message(std::string& message)
 		//Set message
 		message = command;			
 
-		this->response_ok = command + "\r\n" + "- CMD OK -\r\n";
+		response = command + "\r\n" + "- CMD OK -\r\n";
 
 		return true;
 	}
+	//t command - timing statistics of bpm analysis
+	else if (cmd == "t:")
+	{
+		std::string command = message.substr(2, message.length() - 2);
+		if (command == "reset")
+		{
+			bpm_timing.reset();
+			response = "- TIMING RESET -\r\n";
+			return true;
+		}
+		else if (command == "")
+		{
+			response = bpm_timing.get_report("\r\n");
+			return true;
+		}
+
+		return false;
+	}
 
 	return false;
 }
 
-void FCSocket::check_buffer()
+void FCSocket::check_buffer(std::string& message)
 {
-	//Scan through buffer and remove nonprintable characters
-	for (int i = 0; i < BUFFER_SIZE; i++)
+	//Scan through message and remove nonprintable characters
+	for (std::size_t i = 0; i < message.length(); i++)
 	{
-		if (!std::isprint(this->buffer[i]))
+		if (!std::isprint(message[i]))
 		{
-			this->buffer[i] = '\0';
+			message.erase(i);
 			break;
 		}
 	}
@@ -6,6 +6,10 @@
 #include <future>
 #include <string>
 #include <thread>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <map>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include "bpm_globals.hpp"
@@ -13,16 +17,55 @@
 #define BUFFER_SIZE 32
 #define PORT_NO 3333
 #define BACKLOG 5
+//Maximum number of simultaneously connected clients
+#define MAX_CLIENTS 16
+//Maximum number of epoll events handled per wakeup
+#define MAX_EVENTS 16
+//Maximum number of pending commands for the application
+#define COMMAND_QUEUE_SIZE 32
+//Maximum number of pending telemetry frames
+#define TELEMETRY_QUEUE_SIZE 16
+//Maximum size of unsent data per client - frames are dropped for slow clients
+#define MAX_CLIENT_BUFFER 4096
 
-//Enum for state machine
-enum FCSocketState
+//Telemetry frame
+//Subscribed clients ('s:bpm') receive one binary frame per bpm update:
+//	uint16	length of the rest of the frame (34)
+//	uint8	frame type (1 = bpm update)
+//	uint8	frame version (2)
+//	uint64	timestamp [us since epoch]
+//	float32	raw bpm value
+//	float32	smoothed bpm value
+//	float32	rms value
+//	uint32	analysis duration [us]
+//	float32	confidence [0..1]
+//	float32	beat phase [0..1) at the end of the buffer, 0 = beat (algorithm 3)
+//All values are little endian.
+#define TELEMETRY_FRAME_SIZE 36
+#define TELEMETRY_TYPE_BPM 1
+#define TELEMETRY_VERSION 2
+
+struct FCTelemetry
+{
+	unsigned long long timestamp;
+	double bpm_raw;
+	double bpm_smoothed;
+	double rms;
+	long long duration;
+	double confidence;
+	double phase;
+};
+
+//Data of a connected client
+//Incoming data is collected until a line is complete, outgoing
+//data is kept until the socket accepts it
+struct FCSocketClient
 {
-	FCSocket_Init	=	0,
-	FCSocket_Accept,
-	FCSocket_Read,
-	FCSocket_Response,
-	FCSocket_Disconnect
-	
+	int fd;
+	std::string in;
+	std::string out;
+	//Client receives telemetry frames
+	bool subscribed;
 };
 
 class FCSocket
@@ -37,47 +80,70 @@ public:
 	std::future<eError> start_listening();
 	void stop_listening();
 	//Getter method for buffer data
+	//Returns the oldest pending command, or an empty string
 	void get_buffer(std::string& s);
+	//Send telemetry frame to all subscribed clients
+	//Only queues the frame, sending is done by the listener thread
+	void publish(const FCTelemetry& telemetry);
 
 private:
 	//Socket handle
 	int sockfd;
-	//Address for server and client
-	sockaddr_in serv_addr, cli_addr;
+	//Address for server
+	sockaddr_in serv_addr;
 	//Port number
 	int portno;
-	//Socket for incoming data
-	int newsockfd;
-	socklen_t clilen;
-	//Buffer for data
-	char buffer[BUFFER_SIZE];
+	//Event poll handle
+	int epollfd;
+	//Event handle used to wake up the listener thread on stop
+	//or when telemetry frames are pending
+	int wakefd;
+
+	//Connected clients - key is the socket handle
+	std::map<int, FCSocketClient> clients;
 
 	//Initialized flag
 	bool initialized;
 	//Flag for loop
-	bool stop;
+	std::atomic<bool> stop;
+	//Listener thread has been started
+	std::atomic<bool> running;
 
-	//Internal state machine
-	FCSocketState state;
+	//Commands for outside users
+	std::deque<std::string> commands;
+	//Mutex for protecting commands
+	std::mutex mtx;
 
-	//Data for outside users
-	std::string data;
-	//Mutex for protecting data
-	bool mtx;
+	//Serialized telemetry frames waiting for the listener thread
+	std::deque<std::string> frames;
+	std::mutex frames_mtx;
+	//Number of subscribed clients - nothing is published without subscribers
+	std::atomic<int> subscribers;
 
 	//Char* for parameter response
-	std::string response_ok = "- OK -\r\n";
 	std::string response_not_ok = "- NOK -\r\n";
 	std::string response_welcome = "- - - BPM-COUNTER - welcome - - -\r\n";
 
 	//Loop function for TCP connections
 	eError listening();
 
+	//Connection handling
+	void accept_clients();
+	void read_client(FCSocketClient& client);
+	bool write_client(FCSocketClient& client);
+	void send_client(FCSocketClient& client, const std::string& s);
+	void close_client(int fd);
+	void close_all();
+	void send_frames();
+	void set_subscribed(FCSocketClient& client, bool subscribed);
+
 	//Helper function for buffer processing
-	bool process_message(std::string& message);
-	void check_buffer();
+	bool process_message(std::string& message, std::string& response);
+	void check_buffer(std::string& message);
+	//Hand command over to application
+	void push_command(const std::string& message);
 };
 
 #endif
 
-#endif
\ No newline at end of file
+#endif
@@ -27,16 +27,16 @@ FCState::FCState()
 	this->is_initialized = false;
 
 	//Write debug line
-	if (param_list.get<bool>("debug state") == true)
-		my_console.WriteToSplitConsole("Initialized FCState " + std::to_string(my_id), param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugState) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitFC), "Initialized FCState {}", my_id);
 
 }
 
 //Destructor
 FCState::~FCState()
 {
-	if (param_list.get<bool>("debug state") == true)
-		my_console.WriteToSplitConsole("Removed FCState " + std::to_string(my_id), param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugState) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitFC), "Removed FCState {}", my_id);
 }
 
 //Bind methods for function pointers
@@ -45,8 +45,8 @@ eError FCState::bind_entr(void(*function)())
 	//Check for null pointer
 	if (function == nullptr)
 	{
-		if (param_list.get<bool>("debug state") == true)
-			my_console.WriteToSplitConsole("FCStateError_BindFunctionNullPtr " + std::to_string(my_id), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugState) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCStateError_BindFunctionNullPtr {}", my_id);
 		return eFCStateError_BindFunctionNullPtr;
 	}
 
@@ -55,8 +55,8 @@ eError FCState::bind_entr(void(*function)())
 	set_init();
 
 	//Write debug line
-	if (param_list.get<bool>("debug state") == true)
-		my_console.WriteToSplitConsole("Binding entry function done for " + std::to_string(my_id), param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugState) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitFC), "Binding entry function done for {}", my_id);
 
 	return eSuccess;
 }
@@ -66,8 +66,8 @@ eError FCState::bind_loop(FCStates(*function)())
 	//Check for null pointer
 	if (function == nullptr)
 	{
-		if (param_list.get<bool>("debug state") == true)
-			my_console.WriteToSplitConsole("FCStateError_BindFunctionNullPtr " + std::to_string(my_id), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugState) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCStateError_BindFunctionNullPtr {}", my_id);
 
 		return eFCStateError_BindFunctionNullPtr;
 	}
@@ -77,8 +77,8 @@ eError FCState::bind_loop(FCStates(*function)())
 	set_init();
 
 	//Write debug line
-	if (param_list.get<bool>("debug state") == true)
-		my_console.WriteToSplitConsole("Binding loop function done for " + std::to_string(my_id), param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugState) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitFC), "Binding loop function done for {}", my_id);
 
 	return eSuccess;
 }
@@ -88,8 +88,8 @@ eError FCState::bind_exit(int(*function)())
 	//Check for null pointer
 	if (function == nullptr)
 	{
-		if (param_list.get<bool>("debug state") == true)
-			my_console.WriteToSplitConsole("FCStateError_BindFunctionNullPtr " + std::to_string(my_id), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugState) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCStateError_BindFunctionNullPtr {}", my_id);
 
 		return eFCStateError_BindFunctionNullPtr;
 	}
@@ -99,8 +99,8 @@ eError FCState::bind_exit(int(*function)())
 	set_init();
 
 	//Write debug line
-	if (param_list.get<bool>("debug state") == true)
-		my_console.WriteToSplitConsole("Binding exit function done for " + std::to_string(my_id), param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugState) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitFC), "Binding exit function done for {}", my_id);
 
 	return eSuccess;
 }
@@ -113,8 +113,8 @@ eError FCState::execute()
 	//The others aren't mandatory
 	if (this->is_initialized == false)
 	{
-		if (param_list.get<bool>("debug state") == true)
-			my_console.WriteToSplitConsole("FCStateError_FCStateNotInitialized " + std::to_string(my_id), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugState) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCStateError_FCStateNotInitialized {}", my_id);
 
 		return eFCStateError_FCStateNotInitialized;
 	}
@@ -123,26 +123,26 @@ eError FCState::execute()
 	switch (this->state)
 	{
 		case StateEntr:
-			if (param_list.get<bool>("debug state") == true)
-				my_console.WriteToSplitConsole("Executing entry function Id = " + std::to_string(my_id), param_list.get<int>("split fc"));
+			if (param_list.get<bool>(eParamDebugState) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitFC), "Executing entry function Id = {}", my_id);
 			entry_function();
 			this->state = StateLoop;
 			break;
 		case StateLoop:
-			if (param_list.get<bool>("debug state") == true)
-				my_console.WriteToSplitConsole("Executing loop function Id = " + std::to_string(my_id), param_list.get<int>("split fc"));
+			if (param_list.get<bool>(eParamDebugState) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitFC), "Executing loop function Id = {}", my_id);
 			this->state = loop_function();
 			break;
 		case StateExit:
-			if (param_list.get<bool>("debug state") == true)
-				my_console.WriteToSplitConsole("Executing exit function Id = " + std::to_string(my_id), param_list.get<int>("split fc"));
+			if (param_list.get<bool>(eParamDebugState) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitFC), "Executing exit function Id = {}", my_id);
 			this->next_id = exit_function();
 			//Here, we have to check if the next state is
 			//defined (not -1)
 			if (this->next_id == -1)
 			{
-				if (param_list.get<bool>("debug state") == true)
-					my_console.WriteToSplitConsole("FCStateError_FCStateNextIdNotDefined " + std::to_string(my_id), param_list.get<int>("split errors"));
+				if (param_list.get<bool>(eParamDebugState) == true)
+					my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCStateError_FCStateNextIdNotDefined {}", my_id);
 				return eFCStateError_FCStateNextIdNotDefined;
 			}
 			this->state = StateEntr;
@@ -164,8 +164,8 @@ eError FCState::set_next_id(int id)
 	//We check the ID
 	if (id < -1)
 	{
-		if (param_list.get<bool>("debug state") == true)
-			my_console.WriteToSplitConsole("FCStateError_InvalidIDNumber " + std::to_string(my_id), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugState) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "FCStateError_InvalidIDNumber {}", my_id);
 		return eFCStateError_InvalidIDNumber;
 	}
 
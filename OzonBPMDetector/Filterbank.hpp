@@ -0,0 +1,57 @@
+#ifndef _FILTERBANK_H
+#define _FILTERBANK_H
+
+#include <vector>
+
+//Shape of the filters
+enum eFilterbankShape
+{
+	eFilterbankRect,		//Band b is [edges[b], edges[b+1]), bins are averaged
+	eFilterbankTriangle		//Band b rises from edges[b] to edges[b+1] and falls to edges[b+2]
+};
+
+//Filterbank mapping the bins of a spectrum to frequency bands
+//The weights are calculated once for a given FFT size and sample rate and
+//stored sparse: each band has a contiguous range of bins with its weights,
+//so applying the filterbank is one short dot product per band.
+class Filterbank
+{
+public:
+	Filterbank();
+
+	//Build filterbank from band edges in Hz
+	//bins is the number of spectrum bins passed to apply (0: fft_size / 2 + 1)
+	void build(const std::vector<double>& edges, long fft_size, long sample_rate, eFilterbankShape shape = eFilterbankRect, long bins = 0);
+	//Octave bands (bands_per_octave = 1), third octave bands (3)...
+	void build_octave(long fft_size, long sample_rate, double freq_min, double freq_max, int bands_per_octave = 1, long bins = 0);
+	//Triangular filters with equal distance on mel scale
+	void build_mel(long fft_size, long sample_rate, double freq_min, double freq_max, int bands, long bins = 0);
+
+	//Edges for octave and mel filterbanks
+	static std::vector<double> octave_edges(double freq_min, double freq_max, int bands_per_octave);
+	static std::vector<double> mel_edges(double freq_min, double freq_max, int bands);
+
+	//Apply filterbank - in has bins values, out has get_bands() values
+	void apply(const double* in, double* out) const;
+	void apply(const std::vector<double>& in, std::vector<double>& out) const;
+
+	int get_bands() const { return (int)this->first.size(); }
+	//Number of spectrum bins used by the filterbank (highest bin + 1)
+	long get_bins_used() const { return this->bins_used; }
+	//Center frequency of band
+	double get_center(int band) const { return this->centers[band]; }
+
+private:
+	//For each band: first bin, number of bins and offset into weights
+	std::vector<long> first;
+	std::vector<int> count;
+	std::vector<int> offset;
+	std::vector<double> weights;
+	std::vector<double> centers;
+	long bins_used;
+
+	//Add band with given shape - weights are normalized to sum 1
+	void add_band(double freq_low, double freq_center, double freq_high, double freq_res, eFilterbankShape shape, long bins);
+};
+
+#endif
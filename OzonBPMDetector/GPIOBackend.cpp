@@ -0,0 +1,139 @@
+//The GPIO implementation is not used on WIN32
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <wiringPi.h>
+#include "GPIOBackend.hpp"
+#include "GPIOPin.hpp"
+#include "bpm_globals.hpp"
+#include "bpm_param.hpp"
+#include "SplitConsole.hpp"
+
+//Extern split console instance
+extern SplitConsole my_console;
+//Extern parameter list
+extern ParamList param_list;
+
+GPIOBackend* GPIOBackend::create()
+{
+	//Try register access first
+	GPIOBackendMem* mem = new(std::nothrow) GPIOBackendMem();
+	if ((mem != nullptr) && (mem->check_init() == eSuccess))
+		return mem;
+	delete mem;
+
+	if (param_list.get<bool>(eParamDebugGPIO) == true)
+		my_console.WriteToSplitConsole("GPIO Backend: " GPIO_MEM_DEVICE " not available, using wiringPi", param_list.get<int>(eParamSplitMain));
+
+	return new(std::nothrow) GPIOBackendWiringPi();
+}
+
+GPIOBackendMem::GPIOBackendMem()
+{
+	this->regs = nullptr;
+
+	//The gpiomem device maps the GPIO block only, no root needed
+	int fd = open(GPIO_MEM_DEVICE, O_RDWR | O_SYNC | O_CLOEXEC);
+	if (fd < 0)
+		return;
+
+	void* map = mmap(nullptr, GPIO_MEM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	//The mapping stays valid after closing the file
+	close(fd);
+
+	if (map != MAP_FAILED)
+		this->regs = (volatile unsigned int*)map;
+
+	if (param_list.get<bool>(eParamDebugGPIO) == true)
+		my_console.WriteToSplitConsole("GPIO Backend: Mapped " GPIO_MEM_DEVICE " = " + std::to_string(this->regs != nullptr), param_list.get<int>(eParamSplitMain));
+}
+
+GPIOBackendMem::~GPIOBackendMem()
+{
+	if (this->regs != nullptr)
+		munmap((void*)this->regs, GPIO_MEM_SIZE);
+}
+
+eError GPIOBackendMem::check_init()
+{
+	if (this->regs == nullptr)
+		return eGPIOBackendNotInitialized;
+	return eSuccess;
+}
+
+eError GPIOBackendMem::set_output(unsigned int mask)
+{
+	eError retval = check_init();
+	if (retval != eSuccess)
+		return retval;
+
+	//Function select registers hold 3 bits per pin, 10 pins per register
+	//001 = output
+	for (int pin = 0; pin < 32; pin++)
+	{
+		if ((mask & (1u << pin)) == 0)
+			continue;
+
+		volatile unsigned int* fsel = this->regs + GPIO_REG_FSEL + (pin / 10);
+		int shift = (pin % 10) * 3;
+		*fsel = (*fsel & ~(7u << shift)) | (1u << shift);
+	}
+
+	return retval;
+}
+
+eError GPIOBackendWiringPi::check_init()
+{
+	if (GPIOPin::is_initialized == false)
+		return eWiringPiNotInitialized;
+	return eSuccess;
+}
+
+eError GPIOBackendWiringPi::set_output(unsigned int mask)
+{
+	eError retval = check_init();
+	if (retval != eSuccess)
+		return retval;
+
+	for (int pin = 0; pin < 32; pin++)
+	{
+		if ((mask & (1u << pin)) == 0)
+			continue;
+
+		int wiringPi_number = GPIOPin::gpio_to_wiringPi(pin);
+		if (wiringPi_number == -1)
+			return eGPIONumberNotValid;
+		pinMode(wiringPi_number, OUTPUT);
+	}
+
+	return retval;
+}
+
+void GPIOBackendWiringPi::write_pins(unsigned int mask, bool value)
+{
+	for (int pin = 0; pin < 32; pin++)
+	{
+		if ((mask & (1u << pin)) == 0)
+			continue;
+
+		int wiringPi_number = GPIOPin::gpio_to_wiringPi(pin);
+		if (wiringPi_number != -1)
+			digitalWrite(wiringPi_number, value ? HIGH : LOW);
+	}
+}
+
+unsigned int GPIOBackendWiringPi::read_bank()
+{
+	unsigned int result = 0;
+	for (int pin = 0; pin < 32; pin++)
+	{
+		int wiringPi_number = GPIOPin::gpio_to_wiringPi(pin);
+		if ((wiringPi_number != -1) && (digitalRead(wiringPi_number) == HIGH))
+			result |= (1u << pin);
+	}
+	return result;
+}
+
+#endif
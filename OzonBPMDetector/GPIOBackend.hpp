@@ -0,0 +1,130 @@
+#ifndef _GPIO_BACKEND_H
+#define _GPIO_BACKEND_H
+//Purpose: Access to a whole bank of GPIO pins with one operation
+//Pins are addressed by a bit mask, bit n refers to GPIO n (bank 0, GPIO 0..31)
+
+#include <atomic>
+#include "bpm_globals.hpp"
+
+//Path of the GPIO register device
+#define GPIO_MEM_DEVICE "/dev/gpiomem"
+//Size of the mapped register block
+#define GPIO_MEM_SIZE 4096
+//Register offsets (32 bit words) of the BCM283x GPIO block
+#define GPIO_REG_FSEL 0
+#define GPIO_REG_SET 7
+#define GPIO_REG_CLR 10
+#define GPIO_REG_LEV 13
+
+//Type of backend
+enum eGPIOBackend
+{
+	eGPIOBackendMem,		//Registers mapped from /dev/gpiomem
+	eGPIOBackendWiringPi,		//One wiringPi call per pin
+	eGPIOBackendMock		//Pin states in memory only
+};
+
+//Base class of the backends
+class GPIOBackend
+{
+public:
+	virtual ~GPIOBackend() { }
+
+	//Create backend - register access if possible, otherwise wiringPi
+	static GPIOBackend* create();
+
+	//Check if backend is ready to use
+	virtual eError check_init() = 0;
+	//Get type of backend
+	virtual eGPIOBackend get_type() = 0;
+	//Configure all pins in mask as outputs
+	virtual eError set_output(unsigned int mask) = 0;
+	//Set all pins in mask to high
+	virtual void set_bank(unsigned int mask) = 0;
+	//Set all pins in mask to low
+	virtual void clear_bank(unsigned int mask) = 0;
+	//Read level of all pins
+	virtual unsigned int read_bank() = 0;
+
+	//Pins in mask get the level of the corresponding bit in value
+	void write_bank(unsigned int mask, unsigned int value)
+	{
+		clear_bank(mask & ~value);
+		set_bank(mask & value);
+	}
+};
+
+//Backend with the GPIO registers mapped into memory
+//Setting or clearing a bank is one register store
+class GPIOBackendMem : public GPIOBackend
+{
+public:
+	GPIOBackendMem();
+	~GPIOBackendMem();
+
+	eError check_init();
+	eGPIOBackend get_type() { return eGPIOBackendMem; }
+	eError set_output(unsigned int mask);
+	void set_bank(unsigned int mask) { this->regs[GPIO_REG_SET] = mask; }
+	void clear_bank(unsigned int mask) { this->regs[GPIO_REG_CLR] = mask; }
+	unsigned int read_bank() { return this->regs[GPIO_REG_LEV]; }
+
+private:
+	//Mapped register block
+	volatile unsigned int* regs;
+};
+
+//Backend using wiringPi - fallback if registers can't be mapped
+//wiringPi must already be initialized (GPIOPin::init_gpio)
+class GPIOBackendWiringPi : public GPIOBackend
+{
+public:
+	eError check_init();
+	eGPIOBackend get_type() { return eGPIOBackendWiringPi; }
+	eError set_output(unsigned int mask);
+	void set_bank(unsigned int mask) { write_pins(mask, true); }
+	void clear_bank(unsigned int mask) { write_pins(mask, false); }
+	unsigned int read_bank();
+
+private:
+	void write_pins(unsigned int mask, bool value);
+};
+
+//Backend without hardware
+//Keeps the pin states, used to test and measure off the Pi
+class GPIOBackendMock : public GPIOBackend
+{
+public:
+	GPIOBackendMock() : state(0), outputs(0), writes(0) { }
+
+	eError check_init() { return eSuccess; }
+	eGPIOBackend get_type() { return eGPIOBackendMock; }
+	eError set_output(unsigned int mask)
+	{
+		this->outputs.fetch_or(mask, std::memory_order_relaxed);
+		return eSuccess;
+	}
+	void set_bank(unsigned int mask)
+	{
+		this->state.fetch_or(mask, std::memory_order_relaxed);
+		this->writes.fetch_add(1, std::memory_order_relaxed);
+	}
+	void clear_bank(unsigned int mask)
+	{
+		this->state.fetch_and(~mask, std::memory_order_relaxed);
+		this->writes.fetch_add(1, std::memory_order_relaxed);
+	}
+	unsigned int read_bank() { return this->state.load(std::memory_order_relaxed); }
+
+	//Number of bank operations
+	unsigned long get_writes() { return this->writes.load(std::memory_order_relaxed); }
+	//Pins configured as output
+	unsigned int get_outputs() { return this->outputs.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<unsigned int> state;
+	std::atomic<unsigned int> outputs;
+	std::atomic<unsigned long> writes;
+};
+
+#endif
@@ -6,6 +6,8 @@
 #include "bpm_globals.hpp"
 #include "bpm_param.hpp"
 #include <chrono>
+#include <unistd.h>
+#include <sys/eventfd.h>
 
 //Extern split console instance
 extern SplitConsole my_console;
@@ -15,12 +17,23 @@ extern ParamList param_list;
 GPIOButton::GPIOButton()
 {
 	//Execute init function - ignore return value
-	//The result is stored in member variable is_initialized
+	//The result is stored in member variable is_initialized
+	this->listener = new(std::nothrow) GPIOListener();
+	init_button();
+}
+
+GPIOButton::GPIOButton(GPIOLine* line)
+{
+	this->listener = new(std::nothrow) GPIOListener(line);
 	init_button();
 }
 
 GPIOButton::~GPIOButton()
-{
+{
+	//Thread is using the listener
+	stop_events();
+	close(this->stopfd);
+
 	//We delete all the instances
 	delete(listener);
 }
@@ -28,8 +41,8 @@ GPIOButton::~GPIOButton()
 eError GPIOButton::init_button()
 {
 	//Write debug line
-	if (param_list.get<bool>("debug button") == true)
-		my_console.WriteToSplitConsole("GPIO Button Class: Created button.", param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugButton) == true)
+		my_console.WriteToSplitConsole("GPIO Button Class: Created button.", param_list.get<int>(eParamSplitMain));
 
 	//Declare return value
 	eError retval = eSuccess;
@@ -41,11 +54,14 @@ eError GPIOButton::init_button()
 	this->pressed = std::chrono::high_resolution_clock::now();
 	this->released = std::chrono::high_resolution_clock::now();
 
-	//Create listener
-	this->listener = new(std::nothrow) GPIOListener();
+	//Event thread
+	this->events_running.store(false);
+	this->events_stop.store(false);
+	this->handler = nullptr;
+	this->stopfd = eventfd(0, EFD_CLOEXEC);
 
 	//Check for proper initialization
-	if (this->listener == nullptr || this->listener->check_init() != eSuccess)
+	if (this->listener == nullptr || this->listener->check_init() != eSuccess || this->stopfd < 0)
 	{
 		this->is_initialized = false;
 		retval = eGPIOButtonNotInitialized;
@@ -93,25 +109,7 @@ eButtonHandlerState GPIOButton::get_state()
 	//Evaluate difference
 	if (update_state == true)
 	{
-		//How long is the difference?
-		if (ms >= TIME_LONG_MS)
-		{
-			this->state_handler = Handler_ButtonHeldLong;
-			if (param_list.get<bool>("debug button") == true)
-				my_console.WriteToSplitConsole("GPIO Button Class: HELD LONG.", param_list.get<int>("split main"));
-		}
-		else if (ms >= TIME_SHORT_MS)
-		{
-			this->state_handler = Handler_ButtonHeldShort;
-			if (param_list.get<bool>("debug button") == true)
-				my_console.WriteToSplitConsole("GPIO Button Class: HELD SHORT.", param_list.get<int>("split main"));
-		}
-		else 
-		{
-			this->state_handler = Handler_ButtonPressed;
-			if (param_list.get<bool>("debug button") == true)
-				my_console.WriteToSplitConsole("GPIO Button Class: PRESSED.", param_list.get<int>("split main"));
-		}
+		this->state_handler = classify(ms);
 
 		//Store timestamp
 		this->updated = std::chrono::high_resolution_clock::now();
@@ -140,4 +138,108 @@ eError GPIOButton::check_init()
 	return retval;
 }
 
+eButtonHandlerState GPIOButton::classify(long ms)
+{
+	//How long is the difference?
+	if (ms >= TIME_LONG_MS)
+	{
+		if (param_list.get<bool>(eParamDebugButton) == true)
+			my_console.WriteToSplitConsole("GPIO Button Class: HELD LONG.", param_list.get<int>(eParamSplitMain));
+		return Handler_ButtonHeldLong;
+	}
+	else if (ms >= TIME_SHORT_MS)
+	{
+		if (param_list.get<bool>(eParamDebugButton) == true)
+			my_console.WriteToSplitConsole("GPIO Button Class: HELD SHORT.", param_list.get<int>(eParamSplitMain));
+		return Handler_ButtonHeldShort;
+	}
+	else 
+	{
+		if (param_list.get<bool>(eParamDebugButton) == true)
+			my_console.WriteToSplitConsole("GPIO Button Class: PRESSED.", param_list.get<int>(eParamSplitMain));
+		return Handler_ButtonPressed;
+	}
+}
+
+bool GPIOButton::is_edge_triggered()
+{
+	return ((this->listener != nullptr) && (this->listener->is_edge_triggered() == true));
+}
+
+eError GPIOButton::start_events(ButtonHandler handler)
+{
+	//Check init status
+	eError retval = check_init();
+	if (retval != eSuccess)
+		return retval;
+
+	if ((is_edge_triggered() == false) || (handler == nullptr))
+		return eGPIOButtonNotInitialized;
+
+	if (this->events_running.load() == true)
+		return eSuccess;
+
+	this->handler = handler;
+	this->events_running.store(true);
+	this->event_thread = std::thread(&GPIOButton::event_loop, this);
+
+	return retval;
+}
+
+void GPIOButton::stop_events()
+{
+	//Thread may also have ended by itself after a line error
+	if (this->event_thread.joinable() == false)
+		return;
+
+	//Wake up the thread blocking in poll()
+	this->events_stop.store(true);
+	uint64_t one = 1;
+	bool woken = (write(this->stopfd, &one, sizeof(one)) == sizeof(one));
+
+	this->event_thread.join();
+	this->events_running.store(false);
+	this->events_stop.store(false);
+
+	//Clear the event handle, so the thread can be started again
+	if (woken == true)
+	{
+		if (read(this->stopfd, &one, sizeof(one)) != sizeof(one))
+			return;
+	}
+}
+
+void GPIOButton::event_loop()
+{
+	//Kernel timestamp of the last press
+	long long pressed_ts = 0;
+	bool is_pressed = (this->listener->get_state() == ButtonPressed);
+
+	eButtonState state;
+	long long timestamp;
+	while (this->listener->wait_change(this->stopfd, state, timestamp) == true)
+	{
+		if (state == ButtonPressed)
+		{
+			pressed_ts = timestamp;
+			is_pressed = true;
+		}
+		else if (is_pressed == true)
+		{
+			//Press is classified on release, like in polled mode
+			is_pressed = false;
+			long ms = (long)((timestamp - pressed_ts) / 1000000);
+			this->handler(classify(ms));
+		}
+	}
+
+	if (this->events_stop.load() == true)
+		return;
+
+	//Line error - the main loop polls the button with get_state() from now on
+	my_console.WriteToSplitConsole("GPIO Button Class: Edge events failed, button is polled.", param_list.get<int>(eParamSplitErrors));
+	this->listener->set_polled();
+	this->events_running.store(false);
+}
+
 #endif
\ No newline at end of file
@@ -5,11 +5,15 @@
 //Handles Reset button for OZON bpm counter
 //Runs a thread internally which updates button state periodically
 //Button instance is meant to check periodically in SIR routine
+//If the button is created with a line, a thread waits for edge events
+//instead and reports every classified press to a handler
 
 #include "GPIOListener.hpp"
 #include "bpm_globals.hpp"
 #include <future>
 #include <chrono>
+#include <thread>
+#include <atomic>
 
 #define TIME_SHORT_MS  2000
 #define TIME_LONG_MS   5000
@@ -23,10 +27,15 @@ enum eButtonHandlerState
 	Handler_ButtonHeldLong
 };
 
+//Handler for classified button presses
+typedef void(*ButtonHandler)(eButtonHandlerState);
+
 class GPIOButton
 {
 public:
 	GPIOButton();
+	//Edge triggered button - takes ownership of the line
+	GPIOButton(GPIOLine* line);
 	~GPIOButton();
 
 	//Getter method for button state
@@ -35,6 +44,14 @@ public:
 	//Check init flag
 	eError check_init();
 
+	//Check if button uses edge events
+	bool is_edge_triggered();
+	//Start event thread - the handler is called from this thread on every
+	//release with the press classified by its duration
+	eError start_events(ButtonHandler handler);
+	//Stop event thread
+	void stop_events();
+
 private:
 	//Initialized state
 	bool is_initialized;
@@ -51,6 +68,19 @@ private:
 	std::chrono::time_point<std::chrono::high_resolution_clock> pressed;
 	std::chrono::time_point<std::chrono::high_resolution_clock> released;
 	std::chrono::time_point<std::chrono::high_resolution_clock> updated;
+
+	//Classify press by its duration
+	eButtonHandlerState classify(long ms);
+
+	//Event thread
+	std::thread event_thread;
+	std::atomic<bool> events_running;
+	//Set while the thread is stopped - wait_change() also returns false on errors
+	std::atomic<bool> events_stop;
+	//Event handle used to wake up the thread on stop
+	int stopfd;
+	ButtonHandler handler;
+	void event_loop();
 };
 
 #endif
\ No newline at end of file
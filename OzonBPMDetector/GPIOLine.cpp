@@ -0,0 +1,137 @@
+//The GPIO implementation is not used on WIN32
+#ifndef _WIN32
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include "GPIOLine.hpp"
+#include "bpm_globals.hpp"
+#include "bpm_param.hpp"
+#include "SplitConsole.hpp"
+
+//Extern split console instance
+extern SplitConsole my_console;
+//Extern parameter list
+extern ParamList param_list;
+
+GPIOLineChardev::GPIOLineChardev(int gpio_number)
+{
+	this->fd = -1;
+
+	int chip = open(GPIO_CHIP_DEVICE, O_RDONLY | O_CLOEXEC);
+	if (chip < 0)
+	{
+		if (param_list.get<bool>(eParamDebugGPIO) == true)
+			my_console.WriteToSplitConsole("GPIO Line Class: Can't open " GPIO_CHIP_DEVICE, param_list.get<int>(eParamSplitErrors));
+		return;
+	}
+
+	//Request line events for both edges
+	struct gpioevent_request req;
+	memset(&req, 0, sizeof(req));
+	req.lineoffset = gpio_number;
+	req.handleflags = GPIOHANDLE_REQUEST_INPUT;
+	req.eventflags = GPIOEVENT_REQUEST_BOTH_EDGES;
+	strncpy(req.consumer_label, GPIO_LINE_CONSUMER, sizeof(req.consumer_label) - 1);
+
+	if (ioctl(chip, GPIO_GET_LINEEVENT_IOCTL, &req) == 0)
+		this->fd = req.fd;
+
+	//The line handle stays valid after closing the chip
+	close(chip);
+
+	if (param_list.get<bool>(eParamDebugGPIO) == true)
+		my_console.WriteToSplitConsole("GPIO Line Class: Requested line " + std::to_string(gpio_number) + ", fd = " + std::to_string(this->fd), param_list.get<int>(eParamSplitMain));
+}
+
+GPIOLineChardev::~GPIOLineChardev()
+{
+	if (this->fd >= 0)
+		close(this->fd);
+}
+
+eError GPIOLineChardev::check_init()
+{
+	if (this->fd < 0)
+		return eGPIOListenerNotInitialized;
+	return eSuccess;
+}
+
+bool GPIOLineChardev::read_edge(GPIOEdge& edge)
+{
+	//Handle is blocking - only call if poll() reported data
+	struct gpioevent_data data;
+	if (read(this->fd, &data, sizeof(data)) != sizeof(data))
+		return false;
+
+	edge.value = (data.id == GPIOEVENT_EVENT_RISING_EDGE);
+	edge.timestamp = (long long)data.timestamp;
+	return true;
+}
+
+bool GPIOLineChardev::get_value()
+{
+	struct gpiohandle_data data;
+	memset(&data, 0, sizeof(data));
+	if (ioctl(this->fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data) != 0)
+		return false;
+	return (data.values[0] != 0);
+}
+
+GPIOLineSim::GPIOLineSim()
+{
+	this->value.store(false);
+	this->dropped.store(0);
+	if (pipe2(this->fds, O_CLOEXEC) != 0)
+	{
+		this->fds[0] = -1;
+		this->fds[1] = -1;
+		return;
+	}
+	//Injecting never blocks - a full pipe drops the edge
+	fcntl(this->fds[1], F_SETFL, fcntl(this->fds[1], F_GETFL) | O_NONBLOCK);
+}
+
+GPIOLineSim::~GPIOLineSim()
+{
+	if (this->fds[0] >= 0)
+		close(this->fds[0]);
+	if (this->fds[1] >= 0)
+		close(this->fds[1]);
+}
+
+eError GPIOLineSim::check_init()
+{
+	if (this->fds[0] < 0)
+		return eGPIOListenerNotInitialized;
+	return eSuccess;
+}
+
+bool GPIOLineSim::read_edge(GPIOEdge& edge)
+{
+	return (read(this->fds[0], &edge, sizeof(edge)) == sizeof(edge));
+}
+
+void GPIOLineSim::inject(bool value, long long timestamp)
+{
+	GPIOEdge edge;
+	edge.value = value;
+	edge.timestamp = timestamp;
+	this->value.store(value);
+	//Writes up to PIPE_BUF are atomic, so the reader never sees half an edge
+	//If the pipe is full (EAGAIN), the edge is lost - like an overrun of a real line
+	if (write(this->fds[1], &edge, sizeof(edge)) != sizeof(edge))
+		this->dropped.fetch_add(1);
+}
+
+void GPIOLineSim::inject(bool value)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	inject(value, now.tv_sec * 1000000000LL + now.tv_nsec);
+}
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef _GPIO_LINE_H
+#define _GPIO_LINE_H
+//Purpose: Edge events of a GPIO input line
+//The line provides a file descriptor which becomes readable when an
+//edge is pending, so a listener can block in poll() instead of sampling
+
+#include <atomic>
+#include "bpm_globals.hpp"
+
+//GPIO character device - line offsets equal the GPIO numbers
+#define GPIO_CHIP_DEVICE "/dev/gpiochip0"
+//Label of the requested line
+#define GPIO_LINE_CONSUMER "bpm-button"
+
+//Edge of an input line
+struct GPIOEdge
+{
+	//Level after the edge
+	bool value;
+	//Time of the edge in ns, taken by the kernel
+	//Only differences between edges are meaningful
+	long long timestamp;
+};
+
+//Base class of the line sources
+class GPIOLine
+{
+public:
+	virtual ~GPIOLine() { }
+
+	//Check if line is ready to use
+	virtual eError check_init() = 0;
+	//File descriptor for poll() - readable if edges are pending
+	virtual int get_fd() = 0;
+	//Read one pending edge, returns false if there is none
+	virtual bool read_edge(GPIOEdge& edge) = 0;
+	//Read actual level of the line
+	virtual bool get_value() = 0;
+};
+
+//Line requested from the GPIO character device
+//Both edges are reported, timestamps come from the interrupt handler
+class GPIOLineChardev : public GPIOLine
+{
+public:
+	GPIOLineChardev(int gpio_number);
+	~GPIOLineChardev();
+
+	eError check_init();
+	int get_fd() { return this->fd; }
+	bool read_edge(GPIOEdge& edge);
+	bool get_value();
+
+private:
+	//Line event handle
+	int fd;
+};
+
+//Simulated line - edges are injected by the user
+//Uses a pipe, so poll() behaves like with a real line
+class GPIOLineSim : public GPIOLine
+{
+public:
+	GPIOLineSim();
+	~GPIOLineSim();
+
+	eError check_init();
+	int get_fd() { return this->fds[0]; }
+	bool read_edge(GPIOEdge& edge);
+	bool get_value() { return this->value.load(); }
+
+	//Inject edge with given timestamp in ns
+	void inject(bool value, long long timestamp);
+	//Inject edge with actual time
+	void inject(bool value);
+	//Number of edges lost because the pipe was full
+	unsigned long get_dropped() { return this->dropped.load(); }
+
+private:
+	//Pipe - read and write end
+	int fds[2];
+	//Level after the last injected edge
+	std::atomic<bool> value;
+	std::atomic<unsigned long> dropped;
+};
+
+#endif
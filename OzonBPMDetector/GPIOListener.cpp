@@ -3,6 +3,9 @@
 
 #include "GPIOListener.hpp"
 #include <wiringPi.h>
+#include <poll.h>
+#include <errno.h>
+#include <chrono>
 #include "bpm_globals.hpp"
 #include "bpm_param.hpp"
 #include "SplitConsole.hpp"
@@ -16,6 +19,13 @@ GPIOListener::GPIOListener()
 {
 	//Execute init function - ignore return value
 	//The result is stored in member variable is_initialized
+	this->line = nullptr;
+	init_listener();
+}
+
+GPIOListener::GPIOListener(GPIOLine* line)
+{
+	this->line = line;
 	init_listener();
 }
 
@@ -23,13 +33,14 @@ GPIOListener::~GPIOListener()
 {
 	//We delete all the instances
 	delete(pin);
+	delete(line);
 }
 
 eError GPIOListener::init_listener()
 {
 	//Write debug line
-	if (param_list.get<bool>("debug listener") == true)
-		my_console.WriteToSplitConsole("GPIO Listener Class: Created listener.", param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugListener) == true)
+		my_console.WriteToSplitConsole("GPIO Listener Class: Created listener.", param_list.get<int>(eParamSplitMain));
 
 	//Declare return value
 	eError retval = eSuccess;
@@ -42,6 +53,22 @@ eError GPIOListener::init_listener()
 	this->scans = 0;
 	this->scans_ok = 0;
 
+	//Edge triggered - the line is already requested, no pin needed
+	if (this->line != nullptr)
+	{
+		this->pin = nullptr;
+		if (this->line->check_init() != eSuccess)
+		{
+			this->is_initialized = false;
+			return eGPIOListenerNotInitialized;
+		}
+
+		this->line_state = this->line->get_value();
+		this->state_button = (this->line_state == true) ? ButtonPressed : ButtonReleased;
+		this->is_initialized = true;
+		return retval;
+	}
+
 	//Address pins
 	this->pin = new(std::nothrow) GPIOPin(RESET_PIN_1, eIN, false);
 
@@ -82,8 +109,12 @@ eError GPIOListener::update()
 	if (this->is_initialized == false)
 		return eGPIOListenerNotInitialized;
 
-	//Get actual raw pin state
-	this->pin_state = this->pin->getval_gpio();
+	//Edge triggered listener is updated by wait_change()
+	if (is_edge_triggered() == true)
+		return retval;
+
+	//Get actual raw pin state - a line without edge events is polled
+	this->pin_state = (this->line != nullptr) ? this->line->get_value() : this->pin->getval_gpio();
 
 	//Debug variables
 	static bool pressed = false;
@@ -118,10 +149,10 @@ eError GPIOListener::update()
 					this->scans = 0;
 				}
 				//Write debug line
-				if (param_list.get<bool>("debug listener") == true)
+				if (param_list.get<bool>(eParamDebugListener) == true)
 				{
 					if (released == false)
-						my_console.WriteToSplitConsole("GPIO Listener Class: Button RELEASED state.", param_list.get<int>("split main"));
+						my_console.WriteToSplitConsole("GPIO Listener Class: Button RELEASED state.", param_list.get<int>(eParamSplitMain));
 					released = true;
 					pressed = false;
 				}
@@ -183,10 +214,10 @@ eError GPIOListener::update()
 					this->scans = 0;
 				}
 				//Write debug line
-				if (param_list.get<bool>("debug listener") == true)
+				if (param_list.get<bool>(eParamDebugListener) == true)
 				{
 					if (pressed == false)
-						my_console.WriteToSplitConsole("GPIO Listener Class: Button PRESSED state.", param_list.get<int>("split main"));
+						my_console.WriteToSplitConsole("GPIO Listener Class: Button PRESSED state.", param_list.get<int>(eParamSplitMain));
 					pressed = true;
 					released = false;
 				}
@@ -225,4 +256,80 @@ eError GPIOListener::update()
 	return retval;
 }
 
+bool GPIOListener::wait_change(int stopfd, eButtonState& state, long long& timestamp)
+{
+	if ((this->is_initialized == false) || (this->line == nullptr))
+		return false;
+
+	struct pollfd fds[2];
+	fds[0].fd = this->line->get_fd();
+	fds[0].events = POLLIN;
+	fds[1].fd = stopfd;
+	fds[1].events = POLLIN;
+
+	//Level change waiting for the debounce time
+	bool pending = false;
+	bool candidate = this->line_state;
+	long long candidate_ts = 0;
+	std::chrono::steady_clock::time_point deadline;
+
+	while (true)
+	{
+		//Without pending change we sleep until the next edge
+		int timeout = -1;
+		if (pending == true)
+		{
+			auto remaining = deadline - std::chrono::steady_clock::now();
+			long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count();
+			timeout = (ms > 0) ? (int)ms : 0;
+		}
+
+		int result = poll(fds, 2, timeout);
+		if (result < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+
+		//Stop requested
+		if (fds[1].revents != 0)
+			return false;
+
+		//Timeout - line has been stable long enough
+		if (result == 0)
+		{
+			this->line_state = candidate;
+			this->state_button = (candidate == true) ? ButtonPressed : ButtonReleased;
+			state = this->state_button;
+			timestamp = candidate_ts;
+
+			if (param_list.get<bool>(eParamDebugListener) == true)
+				my_console.WriteToSplitConsole(std::string("GPIO Listener Class: Button ") + ((candidate == true) ? "PRESSED" : "RELEASED") + " edge.", param_list.get<int>(eParamSplitMain));
+
+			return true;
+		}
+
+		if ((fds[0].revents & POLLIN) != 0)
+		{
+			GPIOEdge edge;
+			if (this->line->read_edge(edge) == false)
+				return false;
+
+			//A bounce starts with the first edge, every further edge
+			//restarts the debounce time
+			if (pending == false)
+				candidate_ts = edge.timestamp;
+			candidate = edge.value;
+			pending = (candidate != this->line_state);
+			deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(DEBOUNCE_MS);
+		}
+		else if (fds[0].revents != 0)
+		{
+			//Line error
+			return false;
+		}
+	}
+}
+
 #endif
\ No newline at end of file
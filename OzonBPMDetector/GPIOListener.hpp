@@ -1,13 +1,17 @@
 #ifndef _GPIO_LISTENER_H
 #define _GPIO_LISTENER_H
 
+#include <atomic>
 #include "bpm_globals.hpp"
 #include "GPIOPin.hpp"
+#include "GPIOLine.hpp"
 
 #define NUMBER_OF_SCANS 5
 #define NUMBER_OF_SCANS_OK 3
 #define NUMBER_OF_SCANS_OFF 5
 #define SLEEP_LISTENER_MS 10
+//Time the line must be stable before an edge is accepted
+#define DEBOUNCE_MS (NUMBER_OF_SCANS * SLEEP_LISTENER_MS)
 
 enum eButtonState
 {
@@ -29,6 +33,8 @@ class GPIOListener
 {
 public:
 	GPIOListener();
+	//Edge triggered listener - takes ownership of the line
+	GPIOListener(GPIOLine* line);
 	~GPIOListener();
 
 	//Called to get actual state
@@ -38,11 +44,28 @@ public:
 	//Check init flag
 	eError check_init();
 
+	//Check if listener uses edge events of a line
+	bool is_edge_triggered() { return ((this->line != nullptr) && (this->polled.load() == false)); }
+	//Poll the level of the line in update() instead of waiting for edges
+	//Fallback if the edge events of the line fail
+	void set_polled() { this->polled.store(true); }
+	//Wait for the next debounced change of the button state
+	//Blocks in poll() until the line has been stable for DEBOUNCE_MS after
+	//an edge, or until stopfd becomes readable. The timestamp is the kernel
+	//time of the first edge. Returns false on stop or error.
+	bool wait_change(int stopfd, eButtonState& state, long long& timestamp);
+
 private:
 	//Initialized state
 	bool is_initialized;
 	//Pin to monitor
 	GPIOPin* pin;
+	//Line to monitor - edge triggered
+	GPIOLine* line;
+	//Debounced level of the line
+	bool line_state;
+	//Line is polled - set by the event thread of the button
+	std::atomic<bool> polled { false };
 	//Init method
 	eError init_listener();
 	//State of the button and the listener
@@ -19,8 +19,8 @@ GPIOPin::GPIOPin()
 	//Default constructor
 	this->gpio_number = 2;
 	//Write debug line
-	if (param_list.get<bool>("debug gpio") == true)
-		my_console.WriteToSplitConsole("GPIO Pin Class: Creating pin " + std::to_string(gpio_number), param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugGPIO) == true)
+		my_console.WriteToSplitConsole("GPIO Pin Class: Creating pin " + std::to_string(gpio_number), param_list.get<int>(eParamSplitMain));
 
 	this->direction = eOUT;
 	setdir_gpio(eOUT);
@@ -29,10 +29,10 @@ GPIOPin::GPIOPin()
 	setval_gpio(false);
 
 	//Write debug line
-	if (param_list.get<bool>("debug gpio") == true)
+	if (param_list.get<bool>(eParamDebugGPIO) == true)
 	{
-		my_console.WriteToSplitConsole("GPIO Pin Class: Direction = " + std::to_string(direction), param_list.get<int>("split main"));
-		my_console.WriteToSplitConsole("GPIO Pin Class: Pin value = " + std::to_string(pin_value), param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("GPIO Pin Class: Direction = " + std::to_string(direction), param_list.get<int>(eParamSplitMain));
+		my_console.WriteToSplitConsole("GPIO Pin Class: Pin value = " + std::to_string(pin_value), param_list.get<int>(eParamSplitMain));
 	}
 }
 
@@ -41,8 +41,8 @@ GPIOPin::GPIOPin(int pin_number, eDirection direction, bool value)
 	//Constructor
 	this->gpio_number = pin_number;
 	//Write debug line
-	if (param_list.get<bool>("debug gpio") == true)
-		my_console.WriteToSplitConsole("GPIO Pin Class: Creating pin " + std::to_string(pin_number), param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugGPIO) == true)
+		my_console.WriteToSplitConsole("GPIO Pin Class: Creating pin " + std::to_string(pin_number), param_list.get<int>(eParamSplitMain));
 
 	this->direction = direction;
 	setdir_gpio(direction);
@@ -60,10 +60,10 @@ GPIOPin::GPIOPin(int pin_number, eDirection direction, bool value)
 	}
 
 	//Write debug line
-	if (param_list.get<bool>("debug gpio") == true)
+	if (param_list.get<bool>(eParamDebugGPIO) == true)
 	{
-		my_console.WriteToSplitConsole("GPIO Pin Class: Direction = " + std::to_string(direction), param_list.get<int>("split main"));
-		my_console.WriteToSplitConsole("GPIO Pin Class: Pin value = " + std::to_string(pin_value), param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("GPIO Pin Class: Direction = " + std::to_string(direction), param_list.get<int>(eParamSplitMain));
+		my_console.WriteToSplitConsole("GPIO Pin Class: Pin value = " + std::to_string(pin_value), param_list.get<int>(eParamSplitMain));
 	}
 }
 
@@ -77,8 +77,8 @@ int GPIOPin::init_gpio()
 		GPIOPin::is_initialized = false;
 
 	//Write debug line
-	if (param_list.get<bool>("debug gpio") == true)
-		my_console.WriteToSplitConsole("GPIO Pin Class: wiringPiSetup = " + std::to_string(result), param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugGPIO) == true)
+		my_console.WriteToSplitConsole("GPIO Pin Class: wiringPiSetup = " + std::to_string(result), param_list.get<int>(eParamSplitMain));
 	
 	return result;
 }
@@ -158,11 +158,11 @@ eError GPIOPin::setdir_gpio(eDirection direction)
 	else
 		pinMode(wiringPi_number, INPUT);
 
-	if (param_list.get<bool>("debug gpio") == true)
+	if (param_list.get<bool>(eParamDebugGPIO) == true)
 	{
-		my_console.WriteToSplitConsole("GPIO Pin Class: Set direction on pin " + std::to_string(wiringPi_number), param_list.get<int>("split main"));
-		my_console.WriteToSplitConsole("GPIO Pin Class: equals gpio " + std::to_string(this->gpio_number), param_list.get<int>("split main"));
-		my_console.WriteToSplitConsole("GPIO Pin Class: Direction = " + std::to_string(direction), param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("GPIO Pin Class: Set direction on pin " + std::to_string(wiringPi_number), param_list.get<int>(eParamSplitMain));
+		my_console.WriteToSplitConsole("GPIO Pin Class: equals gpio " + std::to_string(this->gpio_number), param_list.get<int>(eParamSplitMain));
+		my_console.WriteToSplitConsole("GPIO Pin Class: Direction = " + std::to_string(direction), param_list.get<int>(eParamSplitMain));
 	}
 
 	return retval;
@@ -199,11 +199,11 @@ eError GPIOPin::setval_gpio(bool value)
 	else
 		digitalWrite(wiringPi_number, LOW);
 
-	if (param_list.get<bool>("debug gpio") == true)
+	if (param_list.get<bool>(eParamDebugGPIO) == true)
 	{
-		my_console.WriteToSplitConsole("GPIO Pin Class: Set value on pin " + std::to_string(wiringPi_number), param_list.get<int>("split main"));
-		my_console.WriteToSplitConsole("GPIO Pin Class: equals gpio " + std::to_string(this->gpio_number), param_list.get<int>("split main"));
-		my_console.WriteToSplitConsole("GPIO Pin Class: Value = " + std::to_string(value), param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("GPIO Pin Class: Set value on pin " + std::to_string(wiringPi_number), param_list.get<int>(eParamSplitMain));
+		my_console.WriteToSplitConsole("GPIO Pin Class: equals gpio " + std::to_string(this->gpio_number), param_list.get<int>(eParamSplitMain));
+		my_console.WriteToSplitConsole("GPIO Pin Class: Value = " + std::to_string(value), param_list.get<int>(eParamSplitMain));
 	}
 
 	return retval;
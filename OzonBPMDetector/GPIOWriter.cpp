@@ -4,90 +4,116 @@
 #include <iostream>
 #include <chrono>
 #include <math.h>
-#include <wiringPi.h>
 #include <unistd.h>
-#include <signal.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
 #include "GPIOWriter.hpp"
 #include "bpm_globals.hpp"
 #include "bpm_param.hpp"
 #include "SplitConsole.hpp"
-#include "TIMINT.hpp"
 
 //Extern split console instance
 extern SplitConsole my_console;
 //Extern parameter list
 extern ParamList param_list;
 
+//Helper functions for timespec calculation
+static long long timespec_diff(const struct timespec& a, const struct timespec& b)
+{
+	//Returns a - b in ns
+	return (a.tv_sec - b.tv_sec) * 1000000000LL + (a.tv_nsec - b.tv_nsec);
+}
+
+static void timespec_add(struct timespec& t, long int us)
+{
+	t.tv_nsec += us * 1000L;
+	while (t.tv_nsec >= 1000000000L)
+	{
+		t.tv_nsec -= 1000000000L;
+		t.tv_sec++;
+	}
+}
+
 GPIOWriter::GPIOWriter()
 {
 	//Execute init function - ignore return value
 	//The result is stored in member variable is_initialized
+	this->backend = GPIOBackend::create();
+	init_writer();
+}
+
+GPIOWriter::GPIOWriter(GPIOBackend* backend)
+{
+	this->backend = backend;
 	init_writer();
 }
 
 GPIOWriter::~GPIOWriter()
 {
+	//Stop the refresh thread first, it is still using the pins
+	stop_refresh();
+
 	//We set all pins to zero
 	reset_display(0);
 	
-	//We delete all the instances
-	delete(adr_1);
-	delete(adr_2);
-	delete(adr_3);
-	delete(adr_4);
-	delete(seg_1);
-	delete(seg_2);
-	delete(seg_3);
-	delete(seg_4);
-	delete(seg_5);
-	delete(seg_6);
-	delete(seg_7);
-	delete(seg_8);
+	//We delete the backend
+	delete this->backend;
 }
 
 eError GPIOWriter::init_writer()
 {
 	//Write debug line
-	if (param_list.get<bool>("debug writer") == true)
+	if (param_list.get<bool>(eParamDebugWriter) == true)
 		std::cout << "GPIO Writer Class: Created writer " << std::endl;
 
 	//Declare return value
 	eError retval = eSuccess;
 
+	//Refresh thread and statistics
+	this->frame.store(0);
+	this->refresh_running.store(false);
+	reset_statistics();
+	//Timing parameters are read before first use - stable versions
+	//of the parameter list are even, so 1 never matches
+	this->timing_version = 1;
+
 	//Address pins
-	this->adr_1 = new(std::nothrow) GPIOPin(ADDRESS_PIN_1, eOUT, false);
-	this->adr_2 = new(std::nothrow) GPIOPin(ADDRESS_PIN_2, eOUT, false);
-	this->adr_3 = new(std::nothrow) GPIOPin(ADDRESS_PIN_3, eOUT, false);
-	this->adr_4 = new(std::nothrow) GPIOPin(ADDRESS_PIN_4, eOUT, false);
+	this->address_mask[0] = 1u << ADDRESS_PIN_1;
+	this->address_mask[1] = 1u << ADDRESS_PIN_2;
+	this->address_mask[2] = 1u << ADDRESS_PIN_3;
+	this->address_mask[3] = 1u << ADDRESS_PIN_4;
+	this->all_addresses = 0;
+	for (int i = 0; i < DISPLAY_DIGITS; i++)
+		this->all_addresses |= this->address_mask[i];
+
 	//Segment pins
-	this->seg_1 = new(std::nothrow) GPIOPin(SEGMENT_PIN_1, eOUT, false);
-	this->seg_2 = new(std::nothrow) GPIOPin(SEGMENT_PIN_2, eOUT, false);
-	this->seg_3 = new(std::nothrow) GPIOPin(SEGMENT_PIN_3, eOUT, false);
-	this->seg_4 = new(std::nothrow) GPIOPin(SEGMENT_PIN_4, eOUT, false);
-	this->seg_5 = new(std::nothrow) GPIOPin(SEGMENT_PIN_5, eOUT, false);
-	this->seg_6 = new(std::nothrow) GPIOPin(SEGMENT_PIN_6, eOUT, false);
-	this->seg_7 = new(std::nothrow) GPIOPin(SEGMENT_PIN_7, eOUT, false);
-	this->seg_8 = new(std::nothrow) GPIOPin(SEGMENT_PIN_8, eOUT, false);
-
-	//Check for proper initialization
-	if (   this->adr_1 == nullptr || this->adr_2 == nullptr || this->adr_3 == nullptr 
-	    || this->adr_4 == nullptr || this->seg_1 == nullptr || this->seg_2 == nullptr
-   	    || this->seg_3 == nullptr || this->seg_4 == nullptr || this->seg_5 == nullptr
-	    || this->seg_6 == nullptr || this->seg_7 == nullptr || this->seg_8 == nullptr)
+	//Every pattern is translated to its bank mask in advance, so
+	//writing a digit is a single bank operation
+	int segment_pins[8] = { SEGMENT_PIN_1, SEGMENT_PIN_2, SEGMENT_PIN_3, SEGMENT_PIN_4,
+				SEGMENT_PIN_5, SEGMENT_PIN_6, SEGMENT_PIN_7, SEGMENT_PIN_8 };
+	for (int pattern = 0; pattern < 256; pattern++)
+	{
+		this->segment_mask[pattern] = 0;
+		for (int i = 0; i < 8; i++)
+			if ((pattern & (1 << i)) != 0)
+				this->segment_mask[pattern] |= 1u << segment_pins[i];
+	}
+	this->all_segments = this->segment_mask[0xFF];
+
+	//Check for proper initialization and configure the pins
+	if ((this->backend == nullptr) || (this->backend->check_init() != eSuccess)
+	    || (this->backend->set_output(this->all_addresses | this->all_segments) != eSuccess))
 	{
 		this->is_initialized = false;
 		retval = eGPIOWriterNotInitialized;
 	}
 	else
+	{
 		this->is_initialized = true;
-
-	//Timer interrupt
-	this->interrupt_activated = false;
-	this->value = 0.0;
-	this->sequence = 0;
-	//Configure and start timer
-	TIMINT::set_callback(this->se, &GPIOWriter::interrupt_callback_wrapper, this);
-	//TIMINT::start_timer(&this->display_timer, this->se, 0, DISPLAY_CYCLE);
+		this->backend->clear_bank(this->all_addresses | this->all_segments);
+	}
 
 	//Save starting time point for time measurement
 	this->start = std::chrono::high_resolution_clock::now();
@@ -123,95 +149,11 @@ SevenSegNum GPIOWriter::num_to_seg(float number)
 	return result;
 }
 
-eError GPIOWriter::print_number(float number, unsigned int sequence)
-{
-	//Function shall be executed periodically by timer interrupt
-	//One cycle prints out one 4 digit number with one decimal dot
-
-	//Create number	
-	SevenSegNum num = num_to_seg(number);
-
-	unsigned int num_seq = 16;
-	unsigned int seq = sequence % num_seq;
-	
-	//Depending on the sequence number, we set or reset the pins
-	switch (seq)
-	{
-		//Hundreds
-		case 0:
-			this->adr_1->setval_gpio(true);
-			set_segments(num.hundreds, 16, false);
-			set_dot(num.number, 1);
-			break;
-		case 1:
-			//Wait
-			break;
-		case 2:
-			reset_display(2);
-			reset_display(1);
-			break;
-		case 3: 
-			//Wait
-			break;
-
-		//Tens
-		case 4:
-			this->adr_2->setval_gpio(true);
-			set_segments(num.tens, 16, false);
-			set_dot(num.number, 2);
-			break;
-		case 5:
-			//Wait
-			break;
-		case 6:
-			reset_display(2);
-			reset_display(1);
-			break;
-		case 7: 
-			//Wait
-			break;
-
-		//Ones
-		case 8:
-			this->adr_3->setval_gpio(true);
-			set_segments(num.ones, 16, false);
-			set_dot(num.number, 3);
-			break;
-		case 9:
-			//Wait
-			break;
-		case 10:
-			reset_display(2);
-			reset_display(1);
-			break;
-		case 11: 
-			//Wait
-			break;
-
-		//Tenths
-		case 12:
-			this->adr_4->setval_gpio(true);
-			set_segments(num.tenths, 16, false);
-			break;
-		case 13:
-			//Wait
-			break;
-		case 14:
-			reset_display(2);
-			reset_display(1);
-			break;
-		case 15: 
-			//Wait
-			break;
-	}
-
-	return eSuccess;
-}
-
 eError GPIOWriter::print_number(float number)
 {
 	//Function shall be executed periodically
 	//One cycle prints out one 4 digit number with one decimal dot
+	//If the refresh thread is running, it only updates the frame
 
 	//Check if writer is initialized
 	eError retval = check_init();
@@ -221,154 +163,40 @@ eError GPIOWriter::print_number(float number)
 	//Create number	
 	SevenSegNum num = num_to_seg(number);
 
-	if (param_list.get<bool>("debug writer") == true)
+	if (param_list.get<bool>(eParamDebugWriter) == true)
 	{
-		my_console.WriteToSplitConsole("Number: " + std::to_string(number), param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("Number: " + std::to_string(number), param_list.get<int>(eParamSplitMain));
 		//std::cout << "GPIO Writer Class: Found digits ";
 		//std::cout << num.hundreds << "_" << num.tens << "_";
 		//std::cout << num.ones << "_" << num.tenths << std::endl;
 	}
 
-	//Get timing parameters and control mode
-	int control_mode = param_list.get<int>("control mode");
-	int hold_addr_seg = param_list.get<int>("hold addr seg");
-	int pause_addr_seg = param_list.get<int>("pause addr seg");
-	int hold_seg_addr = param_list.get<int>("hold seg addr");
-	int pause_seg_addr = param_list.get<int>("pause seg addr");
-	
-	//Depending on the control mode, the timing is different
-	if (control_mode == 0)
-	{
-		//Control mode 0
-		//First we set the address, then we set the segments
-
-		//Set hundreds
-		this->adr_1->setval_gpio(true);
-		//We set the pins of the segments according to the received digits
-		set_segments(num.hundreds, 16, false);
-		set_dot(num.number, 1);
-		//We keep this for some time
-		usleep(hold_addr_seg);
-
-		//We reset the segments
-		reset_display(2);
-		//We reset the addresses
-		reset_display(1);
-
-		//We pause for a short time
-		usleep(pause_addr_seg);
-
-		//Set tens
-		this->adr_2->setval_gpio(true);
-		set_segments(num.tens, 16, false);
-		set_dot(num.number, 2);
-		usleep(hold_addr_seg);
-		reset_display(2);
-		reset_display(1);
-		usleep(pause_addr_seg);
-
-		//Set ones
-		this->adr_3->setval_gpio(true);
-		set_segments(num.ones, 16, false);
-		set_dot(num.number, 3);
-		usleep(hold_addr_seg);
-		reset_display(2);
-		reset_display(1);
-		usleep(pause_addr_seg);
-
-		//Set tenths
-		this->adr_4->setval_gpio(true);
-		set_segments(num.tenths, 16, false);
-		//There's no decimal dot needed at the end for now
-		usleep(hold_addr_seg);
-		reset_display(2);
-		reset_display(1);
-		usleep(pause_addr_seg);
-	}
-	
-	if (control_mode == 1)
-	{
-		//Control mode 1
-		//First we set the segments, then we set the address
-
-		//Set hundreds
-		//We set the pins of the segments according to the received digits
-		set_segments(num.hundreds, 16, false);
-		set_dot(num.number, 1);
-		this->adr_1->setval_gpio(true);
-		//We keep this for some time
-		usleep(hold_seg_addr);
-
-		//We reset the addresses
-		reset_display(1);
-		//We reset the segments
-		reset_display(2);
-
-		//We pause for a short time
-		usleep(pause_seg_addr);
-
-		//Set tens
-		set_segments(num.tens, 16, false);
-		set_dot(num.number, 2);
-		this->adr_2->setval_gpio(true);
-		usleep(hold_seg_addr);
-		reset_display(1);
-		reset_display(2);
-		usleep(pause_seg_addr);
-
-		//Set ones
-		set_segments(num.ones, 16, false);
-		set_dot(num.number, 3);
-		this->adr_3->setval_gpio(true);
-		usleep(hold_seg_addr);
-		reset_display(1);
-		reset_display(2);
-		usleep(pause_seg_addr);
-
-		//Set tenths
-		set_segments(num.tenths, 16, false);
-		//There's no decimal dot needed at the end for now
-		this->adr_4->setval_gpio(true);
-		usleep(hold_seg_addr);
-		reset_display(1);
-		reset_display(2);
-		usleep(pause_seg_addr);
-	}
+	//Build the frame - the segment patterns are computed only once here,
+	//the refresh only copies them to the pins
+	unsigned int frame = 0;
+	frame |= (unsigned int)(get_segments(num.hundreds, 16, false) | (get_dot(num.number, 1) ? 0x80 : 0x00));
+	frame |= (unsigned int)(get_segments(num.tens, 16, false) | (get_dot(num.number, 2) ? 0x80 : 0x00)) << 8;
+	frame |= (unsigned int)(get_segments(num.ones, 16, false) | (get_dot(num.number, 3) ? 0x80 : 0x00)) << 16;
+	//There's no decimal dot needed at the end for now
+	frame |= (unsigned int)get_segments(num.tenths, 16, false) << 24;
+
+	show_frame(frame);
 
 	return retval;
 }
 
-void GPIOWriter::set_segments(int number, int offset, bool text)
+unsigned char GPIOWriter::get_segments(int number, int offset, bool text)
 {
-	//Write debug lines
-	if (param_list.get<bool>("debug writer") == true)
-	{
-		//std::cout << "GPIO Writer Class: Segments of " << number+offset << "  ";
-		//std::cout << (aChars[number+offset] & 0x01) << "_";
-		//std::cout << (aChars[number+offset] & 0x02) << "_";
-		//std::cout << (aChars[number+offset] & 0x04) << "_";
-		//std::cout << (aChars[number+offset] & 0x08) << "_";
-		//std::cout << (aChars[number+offset] & 0x10) << "_";
-		//std::cout << (aChars[number+offset] & 0x20) << "_";
-		//std::cout << (aChars[number+offset] & 0x40) << std::endl;
-	}
-
-	//We check the digit and select the pins accordingly
-	this->seg_1->setval_gpio((aChars[number+offset] & 0x01) == 0x01);
-	this->seg_2->setval_gpio((aChars[number+offset] & 0x02) == 0x02);
-	this->seg_3->setval_gpio((aChars[number+offset] & 0x04) == 0x04);
-	this->seg_4->setval_gpio((aChars[number+offset] & 0x08) == 0x08);
-	this->seg_5->setval_gpio((aChars[number+offset] & 0x10) == 0x10);
-	this->seg_6->setval_gpio((aChars[number+offset] & 0x20) == 0x20);
-	this->seg_7->setval_gpio((aChars[number+offset] & 0x40) == 0x40);
-
+	//Segment 1..7 are bits 0..6 of the char table
 	//The dot is only displayed regularly, if we are in text mode. If a number is being
-	//displayed, the dot is handled differently with function set_dot()
+	//displayed, the dot is handled differently with function get_dot()
 	if (text == true)
-		this->seg_8->setval_gpio((aChars[number+offset] & 0x80) == 0x80);
+		return (unsigned char)aChars[number+offset];
+	else
+		return (unsigned char)(aChars[number+offset] & 0x7F);
 }
 
-void GPIOWriter::set_dot(float number, int select)
+bool GPIOWriter::get_dot(float number, int select)
 {
 	//Decimal dot is implemented only at one position, code in /* */ below is used
 	//for advanced numerical display (varying decimal dot location)
@@ -406,11 +234,8 @@ void GPIOWriter::set_dot(float number, int select)
 		this->seg_8->setval_gpio(false);
 	*/
 
-	//Set the decimal dot
-	if (select == 3 && number < 1000)
-		this->seg_8->setval_gpio(true);
-	else
-		this->seg_8->setval_gpio(false);
+	//Check the decimal dot
+	return (select == 3 && number < 1000);
 }
 
 eError GPIOWriter::print_string(const char* text, int size, int pos)
@@ -454,8 +279,8 @@ eError GPIOWriter::print_string(const char* text, int size, int pos)
 		else
 			disp[i] = ' ';
 
-	if (param_list.get<bool>("debug writer") == true)
-		my_console.WriteToSplitConsole("GPIO Writer Class: Printing " + std::string(text), param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugWriter) == true)
+		my_console.WriteToSplitConsole("GPIO Writer Class: Printing " + std::string(text), param_list.get<int>(eParamSplitMain));
 
 	//Select chars to display
 	char first = disp[pos+0];
@@ -463,103 +288,14 @@ eError GPIOWriter::print_string(const char* text, int size, int pos)
 	char third = disp[pos+2];
 	char forth = disp[pos+3];
 
-	//Get timing parameters and control mode
-	int control_mode = param_list.get<int>("control mode");
-	int hold_addr_seg = param_list.get<int>("hold addr seg");
-	int pause_addr_seg = param_list.get<int>("pause addr seg");
-	int hold_seg_addr = param_list.get<int>("hold seg addr");
-	int pause_seg_addr = param_list.get<int>("pause seg addr");
-	
-	//Depending on the control mode, the timing is different
-	if (control_mode == 0)
-	{
-		//Control mode 0
-		//First we set the address, then we set the segments
-
-		//Set first 
-		this->adr_1->setval_gpio(true);
-		//We set the pins of the segments according to the received digits
-		set_segments(first, -32, true);
-		//We keep this for some time
-		usleep(hold_addr_seg);
-
-		//We reset the segments
-		reset_display(2);
-		//We reset the addresses
-		reset_display(1);
-
-		//We pause for a short time
-		usleep(pause_addr_seg);
-
-		//Set second
-		this->adr_2->setval_gpio(true);
-		set_segments(secnd, -32, true);
-		usleep(hold_addr_seg);
-		reset_display(2);
-		reset_display(1);
-		usleep(pause_addr_seg);
-
-		//Set third
-		this->adr_3->setval_gpio(true);
-		set_segments(third, -32, true);
-		usleep(hold_addr_seg);
-		reset_display(2);
-		reset_display(1);
-		usleep(pause_addr_seg);
-
-		//Set fourth
-		this->adr_4->setval_gpio(true);
-		set_segments(forth, -32, true);
-		usleep(hold_addr_seg);
-		reset_display(2);
-		reset_display(1);
-		usleep(pause_addr_seg);
-	}
-	
-	if (control_mode == 1)
-	{
-		//Control mode 1
-		//First we set the segments, then we set the address
-
-		//Set first
-		//We set the pins of the segments according to the received digits
-		set_segments(first, -32, true);
-		this->adr_1->setval_gpio(true);
-		//We keep this for some time
-		usleep(hold_seg_addr);
-
-		//We reset the addresses
-		reset_display(1);
-		//We reset the segments
-		reset_display(2);
-
-		//We pause for a short time
-		usleep(pause_seg_addr);
-
-		//Set second
-		set_segments(secnd, -32, true);
-		this->adr_2->setval_gpio(true);
-		usleep(hold_seg_addr);
-		reset_display(1);
-		reset_display(2);
-		usleep(pause_seg_addr);
-
-		//Set third
-		set_segments(third, -32, true);
-		this->adr_3->setval_gpio(true);
-		usleep(hold_seg_addr);
-		reset_display(1);
-		reset_display(2);
-		usleep(pause_seg_addr);
-
-		//Set fourth
-		set_segments(forth, -32, true);
-		this->adr_4->setval_gpio(true);
-		usleep(hold_seg_addr);
-		reset_display(1);
-		reset_display(2);
-		usleep(pause_seg_addr);
-	}
+	//Build the frame
+	unsigned int frame = 0;
+	frame |= (unsigned int)get_segments(first, -32, true);
+	frame |= (unsigned int)get_segments(secnd, -32, true) << 8;
+	frame |= (unsigned int)get_segments(third, -32, true) << 16;
+	frame |= (unsigned int)get_segments(forth, -32, true) << 24;
+
+	show_frame(frame);
 
 	return retval;
 }
@@ -614,40 +350,28 @@ eError GPIOWriter::reset_display(int option)
 	//Option 0: reset all of the pins
 	//Option 1: reset all of the address pins
 	//Option 2: reset all of the segment pins
+	//While the refresh thread is running, it owns the pins. Option 0
+	//blanks the displayed frame, options 1 and 2 have no effect.
+	if ((option < 0) || (option > 2))
+		return eGPIOWriterResetInvalidOption;
+
+	if (this->refresh_running.load() == true)
+	{
+		if (option == 0)
+			this->frame.store(0);
+		return retval;
+	}
+
 	switch (option)
 	{
 		case 0:
-			this->adr_1->setval_gpio(false);
-			this->adr_2->setval_gpio(false);
-			this->adr_3->setval_gpio(false);
-			this->adr_4->setval_gpio(false);
-			this->seg_1->setval_gpio(false);
-			this->seg_2->setval_gpio(false);
-			this->seg_3->setval_gpio(false);
-			this->seg_4->setval_gpio(false);
-			this->seg_5->setval_gpio(false);
-			this->seg_6->setval_gpio(false);
-			this->seg_7->setval_gpio(false);
-			this->seg_8->setval_gpio(false);
+			this->backend->clear_bank(this->all_addresses | this->all_segments);
 			break;
 		case 1: 
-			this->adr_1->setval_gpio(false);
-			this->adr_2->setval_gpio(false);
-			this->adr_3->setval_gpio(false);
-			this->adr_4->setval_gpio(false);
+			this->backend->clear_bank(this->all_addresses);
 			break;
 		case 2:
-			this->seg_1->setval_gpio(false);
-			this->seg_2->setval_gpio(false);
-			this->seg_3->setval_gpio(false);
-			this->seg_4->setval_gpio(false);
-			this->seg_5->setval_gpio(false);
-			this->seg_6->setval_gpio(false);
-			this->seg_7->setval_gpio(false);
-			this->seg_8->setval_gpio(false);
-			break;
-		default:
-			retval = eGPIOWriterResetInvalidOption;
+			this->backend->clear_bank(this->all_segments);
 			break;
 	}
 
@@ -680,43 +404,220 @@ eError GPIOWriter::check_chars(const char* text, int size)
 	return retval;
 }
 
-void GPIOWriter::interrupt_callback(sigval_t val)
+void GPIOWriter::show_frame(unsigned int frame)
 {
-	GPIOWriter* instance = (GPIOWriter*)val.sival_ptr;
+	//Refresh thread running - it takes over the frame at the start of the next cycle
+	if (this->refresh_running.load() == true)
+	{
+		this->frame.store(frame, std::memory_order_relaxed);
+		return;
+	}
 
-	if (instance->interrupt_activated == false)
+	//No refresh thread - print one complete cycle
+	this->frame.store(frame, std::memory_order_relaxed);
+	load_timing();
+	for (int phase = 0; phase < DISPLAY_PHASES; phase++)
+	{
+		write_phase(phase, frame);
+		usleep(get_phase_duration(phase));
+	}
+}
+
+void GPIOWriter::load_timing()
+{
+	//Only read the parameters if something has changed
+	if (param_list.get_version() == this->timing_version)
 		return;
+
+	this->timing_version = param_list.snapshot([&]()
+	{
+		this->control_mode = param_list.get<int>(eParamControlMode);
+		this->timing.hold_addr_seg = param_list.get<int>(eParamHoldAddrSeg);
+		this->timing.pause_addr_seg = param_list.get<int>(eParamPauseAddrSeg);
+		this->timing.hold_seg_addr = param_list.get<int>(eParamHoldSegAddr);
+		this->timing.pause_seg_addr = param_list.get<int>(eParamPauseSegAddr);
+	});
+}
+
+long int GPIOWriter::get_phase_duration(int phase)
+{
+	//Even phases: digit on (hold), odd phases: digit off (pause)
+	bool on = ((phase % 2) == 0);
+
+	if (this->control_mode == 0)
+		return on ? this->timing.hold_addr_seg : this->timing.pause_addr_seg;
+	else
+		return on ? this->timing.hold_seg_addr : this->timing.pause_seg_addr;
+}
+
+void GPIOWriter::write_phase(int phase, unsigned int frame)
+{
+	int digit = phase / 2;
+	unsigned char pattern = (unsigned char)(frame >> (8 * digit));
+
+	//Depending on the control mode, the order of the pins is different
+	//Segments are cleared at the end of each digit, so setting is enough
+	if ((phase % 2) == 0)
+	{
+		if (this->control_mode == 0)
+		{
+			//Control mode 0
+			//First we set the address, then we set the segments
+			this->backend->set_bank(this->address_mask[digit]);
+			this->backend->set_bank(this->segment_mask[pattern]);
+		}
+		else
+		{
+			//Control mode 1
+			//First we set the segments, then we set the address
+			this->backend->set_bank(this->segment_mask[pattern]);
+			this->backend->set_bank(this->address_mask[digit]);
+		}
+	}
 	else
 	{
-		instance->print_number(instance->value, this->sequence);
-		this->sequence++;
-		if (this->sequence >= 16)
-			this->sequence = 0;
+		//Reset in reverse order
+		if (this->control_mode == 0)
+		{
+			this->backend->clear_bank(this->all_segments);
+			this->backend->clear_bank(this->all_addresses);
+		}
+		else
+		{
+			this->backend->clear_bank(this->all_addresses);
+			this->backend->clear_bank(this->all_segments);
+		}
 	}
 }
 
-void GPIOWriter::interrupt_callback_wrapper(sigval_t val)
+eError GPIOWriter::start_refresh()
+{
+	//Check if writer is initialized
+	eError retval = check_init();
+	if (retval != eSuccess)
+		return retval;
+
+	if (this->refresh_running.load() == true)
+		return eSuccess;
+
+	this->refresh_running.store(true);
+	this->refresh_thread = std::thread(&GPIOWriter::refresh_loop, this);
+
+	if (param_list.get<bool>(eParamDebugWriter) == true)
+		my_console.WriteToSplitConsole("GPIO Writer Class: Refresh thread started", param_list.get<int>(eParamSplitMain));
+
+	return eSuccess;
+}
+
+void GPIOWriter::stop_refresh()
 {
-	GPIOWriter* obj = (GPIOWriter*)val.sival_ptr;
-	obj->interrupt_callback(val);
+	if (this->refresh_running.load() == false)
+		return;
+
+	//The thread sleeps for one phase at most, so joining is fast
+	this->refresh_running.store(false);
+	if (this->refresh_thread.joinable() == true)
+		this->refresh_thread.join();
 }
 
-eError GPIOWriter::activate_timer_interrupt()
+void GPIOWriter::refresh_loop()
 {
-	this->interrupt_activated = true;
-	return eSuccess;
+	set_thread_priority();
+
+	//Deadline of the next phase
+	//Deadlines are absolute, so a late wakeup doesn't shift the following phases
+	struct timespec deadline;
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+	int phase = 0;
+	unsigned int current = 0;
+
+	while (this->refresh_running.load() == true)
+	{
+		//Frame and timing are only taken over at the start of a cycle,
+		//so one cycle never shows digits of two different frames
+		if (phase == 0)
+		{
+			load_timing();
+			current = this->frame.load(std::memory_order_relaxed);
+		}
+
+		//Wait for the deadline - restart if interrupted by a signal
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+			;
+
+		//Measure lateness of the wakeup
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		long long late = timespec_diff(now, deadline);
+		this->jitter[phase].add(late > 0 ? late : 0);
+
+		write_phase(phase, current);
+
+		//Calculate next deadline
+		timespec_add(deadline, get_phase_duration(phase));
+		if (timespec_diff(now, deadline) > 0)
+		{
+			//We are already behind the next deadline - catching up would only
+			//shorten the following phases, so the schedule restarts from now
+			this->missed[phase].fetch_add(1, std::memory_order_relaxed);
+			deadline = now;
+		}
+
+		phase++;
+		if (phase == DISPLAY_PHASES)
+		{
+			phase = 0;
+			this->cycles.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	//Leave the display dark
+	this->backend->clear_bank(this->all_addresses | this->all_segments);
 }
 
-eError GPIOWriter::deactivate_timer_interrupt()
+void GPIOWriter::set_thread_priority()
 {
-	this->interrupt_activated = false;
-	return eSuccess;
+	//Real time priority keeps the wakeup latency low on a loaded system
+	//The thread only runs for a few us per phase, so it doesn't starve others
+	//If we aren't allowed to (not root), we continue with normal priority
+	struct sched_param param;
+	param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+	if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0)
+	{
+		if (param_list.get<bool>(eParamDebugWriter) == true)
+			my_console.WriteToSplitConsole("GPIO Writer Class: No real time priority for refresh thread", param_list.get<int>(eParamSplitErrors));
+	}
 }
 
-eError GPIOWriter::set_value(double value)
+void GPIOWriter::reset_statistics()
 {
-	this->value = value;
-	return eSuccess;
+	for (int i = 0; i < DISPLAY_PHASES; i++)
+	{
+		this->jitter[i].reset();
+		this->missed[i].store(0, std::memory_order_relaxed);
+	}
+	this->cycles.store(0, std::memory_order_relaxed);
 }
-	
+
+std::string GPIOWriter::get_refresh_report(const std::string& eol)
+{
+	std::string report = "display refresh: cycles=" + std::to_string(get_cycles()) + eol;
+
+	//Format: 'digit X on/off: n=... p50=... p99=... max=... us missed=...'
+	for (int i = 0; i < DISPLAY_PHASES; i++)
+	{
+		StageHistogram& h = this->jitter[i];
+		report += "digit " + std::to_string(i / 2 + 1) + (((i % 2) == 0) ? " on: " : " off: ");
+		report += "n=" + std::to_string(h.get_count());
+		report += " p50=" + std::to_string((long long)h.get_percentile(0.50));
+		report += " p99=" + std::to_string((long long)h.get_percentile(0.99));
+		report += " max=" + std::to_string((long long)h.get_max());
+		report += " us missed=" + std::to_string(get_missed(i));
+		report += eol;
+	}
+
+	return report;
+}
+
 #endif
\ No newline at end of file
@@ -3,18 +3,29 @@
 
 #include <chrono>
 #include <string>
-#include <signal.h>
+#include <thread>
+#include <atomic>
+#include <time.h>
 #include "bpm_globals.hpp"
-#include "GPIOPin.hpp"
+#include "GPIOBackend.hpp"
+#include "BPMTiming.hpp"
+
+//Number of multiplexed digits
+#define DISPLAY_DIGITS 4
+//Each digit has an 'on' phase (address and segments set, lasts 'hold')
+//and an 'off' phase (everything cleared, lasts 'pause')
+#define DISPLAY_PHASES (2 * DISPLAY_DIGITS)
 
 class GPIOWriter
 {
 public:
 	//Constructor
-	//Only use default constructor
-	//Create 4 address pins and 8 segment pins
+	//Use 4 address pins and 8 segment pins
 	//The info comes from the bpm_globals.hpp file
 	GPIOWriter();
+	//Writer with given backend, e.g. GPIOBackendMock to measure
+	//the refresh timing without hardware. The writer takes ownership.
+	GPIOWriter(GPIOBackend* backend);
 
 	//Destructor
 	~GPIOWriter();
@@ -32,38 +43,40 @@ public:
 	eError reset_display(int option);
 
 	#ifndef _WIN32
-		//Activation method for timer interrupt
-		//After this function has been called, the print method is called by
-		//timer interrupt internally. User must call set_value to control displayed value.
-		eError activate_timer_interrupt();
-		//Deactivate interrupt timer
-		//After this function has been called, user must periodically call 
-		//print method to display value.
-		eError deactivate_timer_interrupt();
-		//Setter method for internal value
-		eError set_value(double value);
-		//Timer interrupt callback wrapper - callbacks are static, so we can't 
-		//pass a member function as callback, therefore a wrapper is needed.
-		static void interrupt_callback_wrapper(sigval_t val);
+		//Start refresh thread
+		//While the refresh thread is running, the print methods only
+		//update the displayed frame and return immediately. The thread
+		//multiplexes the digits on absolute deadlines.
+		//Without refresh thread, each print call performs one complete
+		//multiplex cycle and blocks until it is done.
+		eError start_refresh();
+		//Stop refresh thread and clear all pins
+		void stop_refresh();
+		//Check if refresh thread is running
+		bool is_refreshing() { return this->refresh_running.load(); }
+
+		//Refresh statistics
+		//Lateness of each phase is measured against its deadline. If a
+		//phase starts after the deadline of the following phase, the
+		//deadline counts as missed and the schedule is restarted.
+		unsigned long get_cycles() { return this->cycles.load(std::memory_order_relaxed); }
+		unsigned long get_missed(int phase) { return this->missed[phase].load(std::memory_order_relaxed); }
+		void reset_statistics();
+		//Get summary of all phases, lines separated with eol
+		std::string get_refresh_report(const std::string& eol);
 	#endif
 
 private:
 	//Initialized state
 	bool is_initialized;
-	//Address pins
-	GPIOPin* adr_1;
-	GPIOPin* adr_2;
-	GPIOPin* adr_3;
-	GPIOPin* adr_4;
-	//Segment pins
-	GPIOPin* seg_1;
-	GPIOPin* seg_2;
-	GPIOPin* seg_3;
-	GPIOPin* seg_4;
-	GPIOPin* seg_5;
-	GPIOPin* seg_6;
-	GPIOPin* seg_7;
-	GPIOPin* seg_8;
+	//Pin access
+	GPIOBackend* backend;
+	//Bank masks of the address pins (one per digit) and of all pins
+	unsigned int address_mask[DISPLAY_DIGITS];
+	unsigned int all_addresses;
+	unsigned int all_segments;
+	//Bank mask for each segment pattern (bit 0..7 = segment 1..8)
+	unsigned int segment_mask[256];
 
 	//Init function
 	//Called upon instance creation
@@ -73,26 +86,41 @@ private:
 	//Check if characters are valid
 	eError check_chars(const char* text, int size);
 	//Helper function for print method
-	//No return value because initialization is already checked before
-	void set_segments(int number, int offset, bool text);
+	//Returns the segment pattern of a char, bit 0..7 is segment 1..8
+	unsigned char get_segments(int number, int offset, bool text);
 	//Display decimal dot
-	void set_dot(float number, int select);
+	bool get_dot(float number, int select);
 
 	#ifndef _WIN32
-		//Timer interrupt
-		timer_t display_timer;
-		//Event struct for timer interrupt event configuration
-		sigevent se;
-		//Timer interrupt callback 
-		void interrupt_callback(sigval_t val);
-		//Activation flag
-		bool interrupt_activated;
-		//Internal value
-		double value;
-		//Sequence value for interrupt
-		unsigned int sequence;
-		//Print out a number - internal callback
-		eError print_number(float number, unsigned int sequence);
+		//Displayed frame - one segment pattern per digit
+		//Byte 0 is the leftmost digit
+		std::atomic<unsigned int> frame;
+		//Show frame - handed over to the refresh thread or printed directly
+		void show_frame(unsigned int frame);
+
+		//Timing parameters, only re-read if the parameter list changed
+		int control_mode;
+		SevenSegTiming timing;
+		unsigned long timing_version;
+		void load_timing();
+		//Duration of a phase in us
+		long int get_phase_duration(int phase);
+
+		//Pin output of one phase
+		void write_phase(int phase, unsigned int frame);
+
+		//Refresh thread
+		std::thread refresh_thread;
+		std::atomic<bool> refresh_running;
+		void refresh_loop();
+		//Try to get real time priority for the refresh thread
+		void set_thread_priority();
+
+		//Statistics
+		StageHistogram jitter[DISPLAY_PHASES];
+		std::atomic<unsigned long> missed[DISPLAY_PHASES];
+		std::atomic<unsigned long> cycles;
+
 		//Save starting point for time measurement
 		std::chrono::high_resolution_clock::time_point start;
 	#endif
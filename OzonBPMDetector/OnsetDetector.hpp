@@ -0,0 +1,216 @@
+#ifndef _ONSET_DETECTOR_H
+#define _ONSET_DETECTOR_H
+//Purpose: Onset detection with spectral flux (algorithm 2)
+//Samples are added in blocks of any size. Every hop, the last frame is windowed and
+//transformed, the magnitudes are compressed to log frequency bands and the novelty
+//value is the sum of the band increases compared to the previous frame (half wave
+//rectified). The novelty curve has a rate of sample_rate / hop (~172 Hz), so the
+//autocorrelation for the tempo is done on a very short signal.
+//Note: uses DSP.hpp like PEAKS.hpp - only include in one translation unit.
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include "buffer.hpp"
+#include "DSP.hpp"
+#include "Filterbank.hpp"
+#include "bpm_globals.hpp"
+
+class OnsetDetector
+{
+public:
+	OnsetDetector(long sample_rate, long frame_size = ONSET_FRAME_SIZE, long hop_size = ONSET_HOP_SIZE, long history = ONSET_HISTORY)
+	{
+		this->sample_rate = sample_rate;
+		this->frame_size = frame_size;
+		this->hop_size = hop_size;
+
+		//Sample history - one frame
+		this->samples.resize(frame_size);
+		this->frame.init_buffer(frame_size, sample_rate);
+		this->spectrum.init_buffer(frame_size * 2, sample_rate);
+		this->magnitude.resize(frame_size / 2 + 1);
+
+		//Window is calculated once
+		this->window.resize(frame_size);
+		for (long i = 0; i < frame_size; i++)
+			this->window[i] = DSP::hanning((double)i, (double)frame_size);
+
+		//Log frequency bands
+		this->bands.build_octave(frame_size, sample_rate, ONSET_FREQ_MIN, ONSET_FREQ_MAX, ONSET_BANDS_PER_OCTAVE);
+		this->band_values.resize(this->bands.get_bands());
+		this->band_values_old.resize(this->bands.get_bands());
+
+		this->novelty.resize(history);
+
+		reset();
+	}
+
+	//Start new signal - history and novelty curve are cleared
+	void reset()
+	{
+		this->position = 0;
+		this->hop_count = 0;
+		this->count = 0;
+		std::fill(this->band_values_old.begin(), this->band_values_old.end(), 0.0);
+	}
+
+	//Add samples - novelty values are calculated for every complete hop
+	void process(const short* values, long size)
+	{
+		for (long i = 0; i < size; i++)
+		{
+			this->samples[this->position % this->frame_size] = values[i];
+			this->position++;
+			this->hop_count++;
+
+			if ((this->position >= (unsigned long)this->frame_size) && (this->hop_count >= this->hop_size))
+			{
+				this->hop_count = 0;
+				add_frame();
+			}
+		}
+	}
+
+	void process(const buffer<short>& values)
+	{
+		process(values.data(), values.get_size());
+	}
+
+	//Rate of the novelty curve in Hz
+	double get_rate() { return (double)this->sample_rate / this->hop_size; }
+	//Number of novelty values available
+	long get_size() { return (this->count < (long)this->novelty.size()) ? this->count : (long)this->novelty.size(); }
+
+	//Copy the last novelty values to out (oldest first) - returns number of values
+	long get_novelty(buffer<double>& out)
+	{
+		long size = std::min(get_size(), out.get_size());
+		long start = this->count - size;
+		for (long i = 0; i < size; i++)
+			out[i] = this->novelty[(start + i) % this->novelty.size()];
+		return size;
+	}
+
+	//Autocorrelation of the novelty curve for the lag grid of DSP::extract_bpm_value
+	//The novelty rate is low, so lags are interpolated linearly between the values
+	//With a window (see DSP::autocorr_window), only the marked entries are evaluated.
+	//The values are not squared and may be negative, so all others are set to the
+	//lowest double - the maximum is always inside the window.
+	void build_autocorr_array(buffer<double>& autocorr_array, double bpm_min, double bpm_max, const std::vector<bool>* window = nullptr)
+	{
+		long size_autocorr = autocorr_array.get_size();
+
+		//Curve without mean value
+		long size = get_size();
+		this->curve.resize(size);
+		long start = this->count - size;
+		double average = 0.0;
+		for (long i = 0; i < size; i++)
+		{
+			this->curve[i] = this->novelty[(start + i) % this->novelty.size()];
+			average += this->curve[i];
+		}
+		average = (size > 0) ? average / size : 0.0;
+		double variance = 0.0;
+		for (long i = 0; i < size; i++)
+		{
+			this->curve[i] -= average;
+			variance += this->curve[i] * this->curve[i];
+		}
+		variance = (size > 0) ? variance / size : 0.0;
+
+		//Calculate lag values -> beats/minute to seconds/beat
+		double min_lag = (double)60 / bpm_max;
+		double max_lag = (double)60 / bpm_min;
+		double rate = get_rate();
+
+		for (long i = 0; i < size_autocorr; i++)
+		{
+			if ((window != nullptr) && ((*window)[i] == false))
+			{
+				autocorr_array[i] = -std::numeric_limits<double>::max();
+				continue;
+			}
+
+			double lag = (min_lag + (max_lag - min_lag) / (double)size_autocorr * (double)i) * rate;
+			long lag_samples = (long)lag;
+			double frac = lag - lag_samples;
+			long n = size - lag_samples - 1;
+
+			double autocorr = 0.0;
+			if ((n > 0) && (variance > 0.0))
+			{
+				for (long j = 0; j < n; j++)
+					autocorr += this->curve[j] * ((1.0 - frac) * this->curve[j + lag_samples] + frac * this->curve[j + lag_samples + 1]);
+				autocorr = autocorr / n / variance;
+			}
+			autocorr_array[i] = autocorr;
+		}
+	}
+
+private:
+	long sample_rate;
+	long frame_size;
+	long hop_size;
+
+	//Last frame_size samples - position counts up, the slot is position % frame_size
+	std::vector<short> samples;
+	unsigned long position;
+	long hop_count;
+
+	//Frame processing
+	std::vector<double> window;
+	buffer<double> frame;
+	buffer<double> spectrum;
+	std::vector<double> magnitude;
+	Filterbank bands;
+	std::vector<double> band_values;
+	std::vector<double> band_values_old;
+
+	//Novelty curve - count values have been added, the slot is index % size
+	std::vector<double> novelty;
+	long count;
+	//Work buffer for autocorrelation
+	std::vector<double> curve;
+
+	//Calculate novelty value of the last frame
+	void add_frame()
+	{
+		//Frame in time order with window
+		unsigned long start = this->position - this->frame_size;
+		for (long i = 0; i < this->frame_size; i++)
+			this->frame[i] = this->samples[(start + i) % this->frame_size] * this->window[i];
+
+		DSP::perform_fft(this->frame, this->spectrum, +1);
+
+		//Magnitudes scaled to full range
+		double scale = 2.0 / (this->frame_size * 32768.0);
+		for (size_t k = 0; k < this->magnitude.size(); k++)
+			this->magnitude[k] = scale * sqrt(this->spectrum[2 * k] * this->spectrum[2 * k] + this->spectrum[2 * k + 1] * this->spectrum[2 * k + 1]);
+
+		//Log compressed bands
+		this->bands.apply(this->magnitude.data(), this->band_values.data());
+		for (size_t b = 0; b < this->band_values.size(); b++)
+			this->band_values[b] = log(1.0 + ONSET_COMPRESSION * this->band_values[b]);
+
+		//Spectral flux - only increasing energy counts, first frame has no reference
+		double flux = 0.0;
+		if (this->count > 0)
+		{
+			for (size_t b = 0; b < this->band_values.size(); b++)
+			{
+				double diff = this->band_values[b] - this->band_values_old[b];
+				if (diff > 0.0)
+					flux += diff;
+			}
+		}
+		this->band_values_old.swap(this->band_values);
+
+		this->novelty[this->count % this->novelty.size()] = flux;
+		this->count++;
+	}
+};
+
+#endif
@@ -4,46 +4,54 @@
 #include "buffer.hpp"
 #include "DSP.hpp"
 #include <vector>
-#include <fstream>
+#include <sstream>
 #include <functional>
+#include <algorithm>
 
 namespace PEAKS
 {
-	//Debug stream
-	std::ofstream dbgOut;
+	//Debug stream - collected in memory, the caller writes it to the file
+	std::ostringstream dbgOut;
 	//Debug flag - can be set to output data
 	static bool debug_active = false;
-	static bool debug_file_open = false;
 	
 	void activate_debug()
 	{
 		debug_active = true;
-		if (debug_file_open == false)
-		{
-			dbgOut.open("peak_data.txt", std::ios_base::ate | std::ios_base::app);
-			debug_file_open = true;
-		}
 	}
 
 	void deactivate_debug()
 	{
 		debug_active = false;
-		debug_file_open = false;
-		dbgOut.close();
+		dbgOut.str("");
+	}
+
+	//Get debug output of the last extraction and clear the stream
+	std::string take_debug()
+	{
+		std::string text = dbgOut.str();
+		dbgOut.str("");
+		return text;
 	}
 	
-	struct peak
+	//Helper debug function - print vector contents
+	template <typename T>
+	void print_vec(std::string s, std::vector<T>& v)
 	{
-		unsigned int i; //Array index (autocorr_array 1...n)
-		unsigned int j; //Peak nbr inside autocorr_array
-		explicit peak(unsigned int i, unsigned int j) //We allow only construction like this
-		{
-			this->i = i;
-			this->j = j;
-		};
-		bool operator==(const peak& rhs) const //Comparison of two peaks
+		dbgOut << s << " content: " << std::endl;
+		for (unsigned int i = 0; i < v.size(); i++)
+			dbgOut << i << ": " << v.at(i) << std::endl;
+	}
+
+	//Peak of one autocorr array - used for matching the arrays
+	struct band_peak
+	{
+		long index;		//Array index (position in autocorr array)
+		unsigned int array;	//Number of autocorr array
+		double confidence;	//Peak value / global max / number of peaks of the array
+		bool operator<(const band_peak& rhs) const //Sort by index, then by array
 		{
-			return ((this->i == rhs.i) && (this->j) == rhs.j);
+			return (this->index < rhs.index) || ((this->index == rhs.index) && (this->array < rhs.array));
 		};
 	};
 
@@ -71,133 +79,116 @@ namespace PEAKS
 		}
 	};
 
-	//Assume having a vector of indices with peaks already found -> vec
-	//We want to know, if a certain new peak (peak) is already close to one of the found peaks in vec
-	//So we check the proximity of the indices in vec for the indices defined by peak
-	int find_index(std::vector<long>& vec, peak& peak, std::vector<std::vector<long>>& peak_indices, long width)
+	//Work memory of the extraction - provided by the caller and reused for every
+	//measurement, the vectors keep their capacity, so after the first measurement
+	//no memory is allocated anymore
+	struct scratch
 	{
-		//Check size
-		int index = -1;
-		if (vec.size() == 0)
-			return index;
-
-		//Check index
-		if (peak.i >= peak_indices.size())
-			return index;
-		if (peak.j >= peak_indices.at(peak.i).size())
-			return index;
-
-		//Go through already found peaks
-		for (unsigned int i = 0; i < vec.size(); i++)
+		//Peak index values - x axis, indices
+		std::vector<std::vector<long>> peak_indices;
+		//Maximum values - y axis
+		std::vector<std::vector<double>> max_values;
+		std::vector<double> global_max_values;
+		//Number of peaks
+		std::vector<unsigned int> num_peaks;
+		//Index queue for the windowed maximum
+		std::vector<long> window;
+		//Peaks of all arrays sorted by index
+		std::vector<band_peak> sorted;
+		//Merged peaks
+		std::vector<long> peaks;
+		std::vector<double> confidence;
+		std::vector<unsigned int> adjacence;
+		std::vector<double> average;
+
+		//Clear the results for a number of arrays
+		void prepare(unsigned int arrays)
 		{
-			//If the index defined by 'peak' is close to an already found peak -> save the index and stop
-			if (abs((peak_indices.at(peak.i).at(peak.j)) - (vec.at(i))) <= width)
+			this->peak_indices.resize(arrays);
+			this->max_values.resize(arrays);
+			for (unsigned int i = 0; i < arrays; i++)
 			{
-				index = (int)i;
+				this->peak_indices.at(i).clear();
+				this->max_values.at(i).clear();
 			}
+			this->global_max_values.clear();
+			this->num_peaks.clear();
+			this->sorted.clear();
+			this->peaks.clear();
+			this->confidence.clear();
+			this->adjacence.clear();
+			this->average.clear();
 		}
-		return index;
-	}
-
-	//Check if two peak's indices (peak1 and peak2) stored in peak_indices are close together
-	//Proximity is defined by width
-	bool close_together(peak& peak1, peak& peak2, std::vector<std::vector<long>>& peak_indices, long width)
-	{
-		//Check index
-		if (peak1.i >= peak_indices.size() || peak2.i >= peak_indices.size())
-			return false;
-		if (peak1.j >= peak_indices.at(peak1.i).size() || peak2.j >= peak_indices.at(peak2.i).size())
-			return false;
-
-		if (abs((peak_indices.at(peak1.i).at(peak1.j)) - (peak_indices.at(peak2.i).at(peak2.j))) <= width)
-			return true;
-		else
-			return false;
-	}
+	};
 
 	//Get peaks from a single input buffer
+	//A peak is the maximum of the window +/- width around it, values after the end
+	//of the buffer count as zero. The windowed maximum is found in one pass with a
+	//monotonic queue of indices (values decrease from front to back), the queue
+	//memory (window) is provided by the caller. Peaks below threshold * global
+	//maximum are skipped.
 	template <typename T>
-	unsigned int get_peaks(const buffer<T>& inbuffer, std::vector<long>& indices, std::vector<T>& values, unsigned int width, double threshold)
+	unsigned int get_peaks(const buffer<T>& inbuffer, std::vector<long>& indices, std::vector<T>& values, unsigned int width, double threshold, std::vector<long>& window)
 	{
 		//Get size of input buffer
 		long size = inbuffer.get_size();
 
-		//Add width to end of buffer
-		buffer<double> temp_buffer;
-		temp_buffer.init_buffer(size + width, inbuffer.get_sample_rate());
-		//Append zeros to end of buffer
-		for (long i = 0; i < size + width; i++)
-		{
-			if (i < size)
-				temp_buffer[i] = inbuffer[i];
-			else
-				temp_buffer[i] = 0;
-		}
+		indices.clear();
+		values.clear();
+		if (size == 0)
+			return 0;
 
-		std::vector<long> temp_ind;
-		std::vector<T> temp_val;
+		//Every index is added once - queue has at most size entries
+		window.resize(size);
+		long head = 0;
+		long tail = 0;
 
-		//Store local maximum
-		T local_max = std::numeric_limits<T>::min();
-		T global_max = std::numeric_limits<T>::min();
-		long max_ind = 0;
-		long counter = 0;
+		T global_max = inbuffer[0];
 
-		//Scan through values
-		for (long i = 0; i < size + width; i++)
+		//Scan through values - j is the newest value, c the center of the window
+		for (long j = 0; j < size + (long)width; j++)
 		{
-			//Check for new global maximum
-			if (temp_buffer[i] > global_max)
+			if (j < size)
 			{
-				global_max = temp_buffer[i];
+				//Values not above the new one can't be a maximum anymore
+				while ((tail > head) && (inbuffer[window[tail - 1]] <= inbuffer[j]))
+					tail--;
+				window[tail++] = j;
+
+				//Check for new global maximum
+				if (inbuffer[j] > global_max)
+					global_max = inbuffer[j];
 			}
 
-			//Check for new local maximum
-			if (temp_buffer[i] > local_max)
-			{
-				//Store new local maximum
-				local_max = temp_buffer[i];
-				//Store index
-				max_ind = i;
-				//Reset counter
-				counter = 0;
-			}
-			else
+			long c = j - (long)width;
+			if (c < 0)
+				continue;
+
+			//Remove values left of the window
+			while (window[head] < c - (long)width)
+				head++;
+
+			//Center is the maximum of its window
+			if ((window[head] == c) && (inbuffer[c] > 0))
 			{
-				//Increase counter
-				counter++;
-				//Check if counter has reached width
-				if (counter >= width)
-				{
-					//Reset counter
-					counter = 0;
-					//Store local maximum
-					temp_val.push_back(local_max);
-					//Store index
-					temp_ind.push_back(max_ind);
-					//Reset values
-					local_max = std::numeric_limits<T>::min();
-					max_ind = 0;
-				}
+				indices.push_back(c);
+				values.push_back(inbuffer[c]);
 			}
 		}
 
-		//Debug output
-		//for (unsigned int i = 0; i < temp_val.size(); i++)
-		//{
-		//	std::cout << "Local Max: " << i << " - value " << temp_val.at(i) << " at pos " << temp_ind.at(i) << std::endl;
-		//}
-
 		//Check values - if below threshold, skip them
-		for (unsigned int i = 0; i < temp_val.size(); i++)
+		unsigned int count = 0;
+		for (unsigned int i = 0; i < values.size(); i++)
 		{
-			if (temp_val.at(i) / (double)global_max >= threshold)
+			if (values.at(i) / (double)global_max >= threshold)
 			{
-				//Add value to result vector
-				indices.push_back(temp_ind.at(i));
-				values.push_back(temp_val.at(i));
+				indices.at(count) = indices.at(i);
+				values.at(count) = values.at(i);
+				count++;
 			}
 		}
+		indices.resize(count);
+		values.resize(count);
 
 		//Debug output
 		if (debug_active == true)
@@ -210,20 +201,32 @@ namespace PEAKS
 		return values.size();
 	}
 
-	//Helper debug function - print vector contents
-	template <typename T>
-	void print_vec(std::string s, std::vector<T>& v)
+	//Calculate peaks and max values of all arrays
+	void get_all_peaks(std::vector<buffer<double>*>& autocorr_arrays, params& params, scratch& work)
 	{
-		dbgOut << s << " content: " << std::endl;
-		for (unsigned int i = 0; i < v.size(); i++)
-			dbgOut << i << ": " << v.at(i) << std::endl;
+		//Number of arrays
+		unsigned int nArrays = autocorr_arrays.size();
+		work.prepare(nArrays);
+
+		for (unsigned int i = 0; i < nArrays; i++)
+		{
+			work.num_peaks.push_back(PEAKS::get_peaks(*autocorr_arrays.at(i), work.peak_indices.at(i), work.max_values.at(i), params.widths.at(i), params.thresholds.at(i), work.window));
+			//Find max conveniently using iterator - array without peaks has max 0
+			if (work.max_values.at(i).empty() == true)
+				work.global_max_values.push_back(0.0);
+			else
+				work.global_max_values.push_back(*std::max_element(work.max_values.at(i).begin(), work.max_values.at(i).end()));
+		}
+
+		if (debug_active == true)
+			print_vec("global_max_values", work.global_max_values);
 	}
 
 	//For debug purposes, disable optimization
 	//#pragma optimize("", off)  
 
 	//Advanced 'PEAK' bpm extraction function
-	double extract_bpm_value_advanced(std::vector<buffer<double>*>& autocorr_arrays, params& params)
+	double extract_bpm_value_advanced(std::vector<buffer<double>*>& autocorr_arrays, params& params, scratch& work)
 	{
 		//Array index for calculation of return value
 		long array_index = 0;
@@ -239,27 +242,8 @@ namespace PEAKS
 		for (unsigned int i = 0; i < nArrays; i++)
 			DSP::apply_window(*autocorr_arrays.at(i), params.weight);
 
-		//Peak index values - x axis, indices
-		std::vector<std::vector<long>> peak_indices;
-		//Maximum values - y axis
-		std::vector<std::vector<double>> max_values;
-		std::vector<double> global_max_values;
-		//Number of peaks
-		std::vector<unsigned int> num_peaks;
-
 		//Calculate peaks and max values
-		for (unsigned int i = 0; i < nArrays; i++)
-		{
-			//We have to push something in the vectors before use
-			std::vector<long> init1; std::vector<double> init2;
-			peak_indices.push_back(init1); max_values.push_back(init2);
-			num_peaks.push_back(PEAKS::get_peaks(*autocorr_arrays.at(i), peak_indices.at(i), max_values.at(i), params.widths.at(i), params.thresholds.at(i)));
-			//Find max conveniently using iterator - returning pointer to double
-			global_max_values.push_back(*std::max_element(max_values.at(i).begin(), max_values.at(i).end()));
-		}
-		
-		if (debug_active == true)
-			print_vec("global_max_values", global_max_values);
+		PEAKS::get_all_peaks(autocorr_arrays, params, work);
 
 		//Get confidence for each peak - the higher the better
 		//Confidence is based on ratio max y value - peak value but it's decreased by number of peaks
@@ -267,66 +251,82 @@ namespace PEAKS
 		//We also check how close indices are to their counterparts from other passbands
 		//Adjacence is the amount of spreading along the x axis
 		//The higher the better
-		std::vector<double> confidence;
-		std::vector<unsigned int> adjacence;
-		std::vector<long> peaks;
-		std::vector<double> average;
-
-		//Create peak using outer for-loop (i,j)
-		//Then forward compare with created inner peak (n, k)
 		for (unsigned int i = 0; i < nArrays; i++)
 		{
-			for (unsigned int j = 0; j < num_peaks.at(i); j++)
+			for (unsigned int j = 0; j < work.num_peaks.at(i); j++)
 			{
-				peak peak_outer(i, j);
-				//Check if (i,j) is in already in vector
-				if (PEAKS::find_index(peaks, peak_outer, peak_indices, params.adjacence) == -1)
-				{
-					peaks.push_back(peak_indices.at(i).at(j));
-					average.push_back(peak_indices.at(i).at(j));
-					adjacence.push_back(0);
-					confidence.push_back(max_values.at(i).at(j) / global_max_values.at(i) / num_peaks.at(i));
-				}
+				band_peak p;
+				p.index = work.peak_indices.at(i).at(j);
+				p.array = i;
+				p.confidence = work.max_values.at(i).at(j) / work.global_max_values.at(i) / work.num_peaks.at(i);
+				work.sorted.push_back(p);
+			}
+		}
+
+		//Sort all peaks by index - close peaks are neighbours now
+		std::sort(work.sorted.begin(), work.sorted.end());
 
-				for (unsigned int n = i + 1; n < nArrays; n++)
+		//Linear sweep - a group is a peak and all following peaks within adjacence of it
+		//The group has the confidence of its peak from the first array, every pair of
+		//peaks from different arrays within adjacence increases the adjacence of the group
+		//and adds the peak of the later array to the average index
+		long adj = params.adjacence;
+		size_t first = 0;
+		while (first < work.sorted.size())
+		{
+			size_t last = first;
+			while ((last + 1 < work.sorted.size()) && (work.sorted.at(last + 1).index - work.sorted.at(first).index <= adj))
+				last++;
+
+			size_t rep = first;
+			for (size_t k = first + 1; k <= last; k++)
+			{
+				if (work.sorted.at(k).array < work.sorted.at(rep).array)
+					rep = k;
+			}
+
+			unsigned int pairs = 0;
+			double sum = work.sorted.at(rep).index;
+			for (size_t k = first; k <= last; k++)
+			{
+				for (size_t m = k + 1; (m <= last) && (work.sorted.at(m).index - work.sorted.at(k).index <= adj); m++)
 				{
-					for (unsigned int k = 0; k < num_peaks.at(n); k++)
-					{
-						peak peak_inner(n, k);
-						if (PEAKS::close_together(peak_outer, peak_inner, peak_indices, params.adjacence) == true)
-						{
-							int found_index = PEAKS::find_index(peaks, peak_outer, peak_indices, params.adjacence);
-							if (found_index != -1)
-							{
-								adjacence.at(found_index)++;
-								average.at(found_index) *= adjacence.at(found_index);
-								average.at(found_index) += peak_indices.at(n).at(k);
-								average.at(found_index) /= (adjacence.at(found_index) + 1);
-							}
-						}
-						//std::cout << "i" << i << " j" << j << " n" << n << " k" << k << std::endl;
-					}
+					if (work.sorted.at(m).array == work.sorted.at(k).array)
+						continue;
+					pairs++;
+					sum += (work.sorted.at(m).array > work.sorted.at(k).array) ? work.sorted.at(m).index : work.sorted.at(k).index;
 				}
 			}
+
+			work.peaks.push_back(work.sorted.at(rep).index);
+			work.confidence.push_back(work.sorted.at(rep).confidence);
+			work.adjacence.push_back(pairs);
+			work.average.push_back(sum / (pairs + 1));
+
+			first = last + 1;
 		}
 
 		if (debug_active == true)
 		{
 			dbgOut << "Results:" << std::endl;
-			dbgOut << "Num = " << peaks.size() << std::endl;
-			print_vec("peaks", peaks);
-			print_vec("confidence", confidence);
-			print_vec("adjacence", adjacence);
-			print_vec("average", average);
+			dbgOut << "Num = " << work.peaks.size() << std::endl;
+			print_vec("peaks", work.peaks);
+			print_vec("confidence", work.confidence);
+			print_vec("adjacence", work.adjacence);
+			print_vec("average", work.average);
 		}
 
+		//No peak in any array
+		if (work.peaks.empty() == true)
+			return 0.0;
+
 		//Now what we have to do basically is to merge the 2 vectors
 		//and get the max value adjacence * confidence
 		double max_conf_adj = 0;
 		unsigned int ind = 0;
-		for (unsigned int i = 0; i < confidence.size(); i++)
+		for (unsigned int i = 0; i < work.confidence.size(); i++)
 		{
-			double conf_adj = confidence.at(i) * ((double)adjacence.at(i));
+			double conf_adj = work.confidence.at(i) * ((double)work.adjacence.at(i));
 			if (conf_adj > max_conf_adj)
 			{
 				max_conf_adj = conf_adj;
@@ -335,9 +335,9 @@ namespace PEAKS
 		}
 
 		//Extract the index
-		array_index = average.at(ind);
+		array_index = work.average.at(ind);
 		if (debug_active == true)
-			dbgOut << "Selected index: " << average.at(ind) << "\n";
+			dbgOut << "Selected index: " << work.average.at(ind) << "\n";
 
 		double min_lag = (double)60 / params.bpm_max;
 		double max_lag = (double)60 / params.bpm_min;
@@ -355,7 +355,7 @@ namespace PEAKS
 
 	//More pragmatic algorithm, this one just selects the array with the least peaks
 	//and determines the maximum
-	double extract_bpm_value(std::vector<buffer<double>*>& autocorr_arrays, params& params)
+	double extract_bpm_value(std::vector<buffer<double>*>& autocorr_arrays, params& params, scratch& work)
 	{
 		//Debug information
 		static int count = 0;
@@ -376,36 +376,17 @@ namespace PEAKS
 		for (unsigned int i = 0; i < nArrays; i++)
 			DSP::apply_window(*autocorr_arrays.at(i), params.weight);
 
-		//Peak index values - x axis, indices
-		std::vector<std::vector<long>> peak_indices;
-		//Maximum values - y axis
-		std::vector<std::vector<double>> max_values;
-		std::vector<double> global_max_values;
-		//Number of peaks
-		std::vector<unsigned int> num_peaks;
-
 		//Calculate peaks and max values
-		for (unsigned int i = 0; i < nArrays; i++)
-		{
-			//We have to push something in the vectors before use
-			std::vector<long> init1; std::vector<double> init2;
-			peak_indices.push_back(init1); max_values.push_back(init2);
-			num_peaks.push_back(PEAKS::get_peaks(*autocorr_arrays.at(i), peak_indices.at(i), max_values.at(i), params.widths.at(i), params.thresholds.at(i)));
-			//Find max conveniently using iterator - returning pointer to double
-			global_max_values.push_back(*std::max_element(max_values.at(i).begin(), max_values.at(i).end()));
-		}
-
-		if (debug_active == true)
-			print_vec("global_max_values", global_max_values);
+		PEAKS::get_all_peaks(autocorr_arrays, params, work);
 
 		//Get array with least peaks
 		unsigned int selection = 0;
 		unsigned int value = std::numeric_limits<unsigned int>::max();
 		for (unsigned int i = 0; i < nArrays; i++)
 		{
-			if (num_peaks.at(i) < value)
+			if (work.num_peaks.at(i) < value)
 			{
-				value = num_peaks.at(i);
+				value = work.num_peaks.at(i);
 				selection = i;
 			}
 		}
@@ -414,10 +395,10 @@ namespace PEAKS
 			dbgOut << "Selection: " << selection << "\n";
 
 		//Find index with global maximum
-		for (unsigned int i = 0; i < num_peaks.at(selection); i ++)
+		for (unsigned int i = 0; i < work.num_peaks.at(selection); i ++)
 		{
-			if (max_values.at(selection).at(i) == global_max_values.at(selection))
-				array_index = peak_indices.at(selection).at(i);
+			if (work.max_values.at(selection).at(i) == work.global_max_values.at(selection))
+				array_index = work.peak_indices.at(selection).at(i);
 		}
 
 		if (debug_active == true)
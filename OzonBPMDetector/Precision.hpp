@@ -0,0 +1,259 @@
+#ifndef _PRECISION_H
+#define _PRECISION_H
+//Purpose: Sample type policies for the biquad analysis chain (algorithm 1)
+//The chain biquad filter -> downsampling -> envelope -> autocorrelation of one
+//passband runs with the sample types of a policy:
+//  filter_t - registers of the biquad filters (double or float), selects the
+//             overload of BiquadCascade::process
+//  sample_t - envelope and correlation samples
+//  accum_t  - correlation sums
+//  coeff_t  - envelope coefficients
+//The fixed point policies keep the scale of the 16 bit input:
+//  Q15 - one lsb is one pcm step (int16, products summed in int64)
+//  Q31 - 15 more fractional bits and one bit headroom (int32, products >> 16 summed in int64)
+//Variance and lag sums use the same kernel, so the normalized autocorrelation
+//does not depend on the scale of a policy.
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "buffer.hpp"
+#include "BiquadCascade.hpp"
+#include "AutocorrSearch.hpp"
+
+//Precision of the analysis chain - value of parameter "precision"
+enum ePrecision
+{
+	ePrecisionDouble,			//Double precision (reference)
+	ePrecisionFloat,			//Single precision filters, envelope and correlation
+	ePrecisionQ15,				//Single precision filters, Q15 envelope and correlation
+	ePrecisionQ31				//Single precision filters, Q31 envelope and correlation
+};
+
+struct PrecisionDouble
+{
+	typedef double filter_t;
+	typedef double sample_t;
+	typedef double accum_t;
+	typedef double coeff_t;
+
+	static sample_t from_filter(filter_t x) { return x; }
+	static coeff_t coeff(double c) { return c; }
+	static sample_t scale(sample_t x, coeff_t c) { return x * c; }
+	static accum_t product(sample_t a, sample_t b) { return a * b; }
+};
+
+struct PrecisionFloat
+{
+	typedef float filter_t;
+	typedef float sample_t;
+	typedef float accum_t;
+	typedef float coeff_t;
+
+	static sample_t from_filter(filter_t x) { return x; }
+	static coeff_t coeff(double c) { return (float)c; }
+	static sample_t scale(sample_t x, coeff_t c) { return x * c; }
+	static accum_t product(sample_t a, sample_t b) { return a * b; }
+};
+
+struct PrecisionQ15
+{
+	typedef float filter_t;
+	typedef int16_t sample_t;
+	typedef int64_t accum_t;
+	typedef int32_t coeff_t;
+
+	//Rounded and saturated - the filters may exceed the input range
+	static sample_t from_filter(filter_t x)
+	{
+		float r = roundf(x);
+		if (r > 32767.0f) return 32767;
+		if (r < -32767.0f) return -32767;
+		return (sample_t)r;
+	}
+	static coeff_t coeff(double c) { return (coeff_t)lround(c * 32768.0); }
+	static sample_t scale(sample_t x, coeff_t c) { return (sample_t)(((int32_t)x * c) >> 15); }
+	static accum_t product(sample_t a, sample_t b) { return (int32_t)a * b; }
+};
+
+struct PrecisionQ31
+{
+	typedef float filter_t;
+	typedef int32_t sample_t;
+	typedef int64_t accum_t;
+	typedef int64_t coeff_t;
+
+	//Rounded and saturated - one bit headroom above the input range
+	static sample_t from_filter(filter_t x)
+	{
+		double r = round((double)x * 32768.0);
+		if (r > 2147483647.0) return 2147483647;
+		if (r < -2147483647.0) return -2147483647;
+		return (sample_t)r;
+	}
+	static coeff_t coeff(double c) { return (coeff_t)llround(c * 2147483648.0); }
+	static sample_t scale(sample_t x, coeff_t c) { return (sample_t)(((int64_t)x * c) >> 31); }
+	static accum_t product(sample_t a, sample_t b) { return ((int64_t)a * b) >> 16; }
+};
+
+//Interface of the chain - the analyzer selects the policy at runtime
+class PrecisionChainBase
+{
+public:
+	virtual ~PrecisionChainBase() { }
+
+	//Biquad filter and downsampling - every sample passes the filter, every Nth is kept
+	virtual void filter(const buffer<short>& input, BiquadCascade& cascade) = 0;
+	//Envelope of filtered samples (see DSP::envelope_filter)
+	virtual void envelope(double recovery) = 0;
+	//Autocorrelation for the lag grid of DSP::build_autocorr_array (squared, normalized)
+	//With a window (see DSP::autocorr_window), only the marked entries are calculated.
+	virtual void autocorr(buffer<double>& autocorr_array, double bpm_min, double bpm_max, const std::vector<bool>* window = nullptr) = 0;
+	//Coarse to fine variant (see DSP::build_autocorr_array_search) - returns the number of evaluated lags
+	virtual long autocorr_search(buffer<double>& autocorr_array, double bpm_min, double bpm_max, long coarse_step, int candidates) = 0;
+};
+
+template <class P>
+class PrecisionChain : public PrecisionChainBase
+{
+public:
+	//size and sample_rate after downsampling
+	PrecisionChain(long size, long sample_rate, int downsample)
+	{
+		this->sample_rate = sample_rate;
+		this->downsample = downsample;
+		this->samples.resize(size);
+		this->env.resize(size);
+	}
+
+	void filter(const buffer<short>& input, BiquadCascade& cascade)
+	{
+		long size = (long)this->samples.size();
+		long size_in = std::min(input.get_size(), size * this->downsample);
+		for (long i = 0; i < size_in; i++)
+		{
+			typename P::filter_t output = cascade.process((typename P::filter_t)input[i]);
+			if (i % this->downsample == 0)
+				this->samples[i / this->downsample] = P::from_filter(output);
+		}
+	}
+
+	void envelope(double recovery)
+	{
+		long size = (long)this->samples.size();
+		double release = exp(-1.0 / (this->sample_rate * recovery));
+		typename P::coeff_t hold = P::coeff(release);
+		typename P::coeff_t attack = P::coeff(1.0 - release);
+
+		typename P::sample_t peak_env = 0;
+		for (long i = 0; i < size; i++)
+		{
+			typename P::sample_t env_in = (this->samples[i] < 0) ? -this->samples[i] : this->samples[i];
+			if (env_in > peak_env)
+				peak_env = env_in;
+			else
+				peak_env = P::scale(peak_env, hold) + P::scale(env_in, attack);
+			this->env[i] = peak_env;
+		}
+
+		//Remove mean value - the envelope is positive, so the difference stays in range
+		typename P::accum_t sum = 0;
+		for (long i = 0; i < size; i++)
+			sum += this->env[i];
+		typename P::sample_t average = (size > 0) ? (typename P::sample_t)(sum / size) : 0;
+		for (long i = 0; i < size; i++)
+			this->env[i] -= average;
+	}
+
+	void autocorr(buffer<double>& autocorr_array, double bpm_min, double bpm_max, const std::vector<bool>* window)
+	{
+		long size_autocorr = autocorr_array.get_size();
+		double variance = get_variance();
+
+		for (long i = 0; i < size_autocorr; i++)
+		{
+			autocorr_array[i] = 0.0;
+			if ((window != nullptr) && ((*window)[i] == false))
+				continue;
+			autocorr_array[i] = get_autocorr(get_lag_samples(i, size_autocorr, bpm_min, bpm_max), variance);
+		}
+	}
+
+	long autocorr_search(buffer<double>& autocorr_array, double bpm_min, double bpm_max, long coarse_step, int candidates)
+	{
+		long size_autocorr = autocorr_array.get_size();
+		double variance = get_variance();
+
+		auto lag_samples = [&](long i) -> long { return get_lag_samples(i, size_autocorr, bpm_min, bpm_max); };
+		auto autocorr = [&](long i) -> double { return get_autocorr(lag_samples(i), variance); };
+		return ::autocorr_search(autocorr_array, coarse_step, candidates, lag_samples, autocorr);
+	}
+
+private:
+	long sample_rate;
+	int downsample;
+	//Downsampled filter output and envelope without mean
+	std::vector<typename P::sample_t> samples;
+	std::vector<typename P::sample_t> env;
+
+	//Variance - same kernel as the lags
+	double get_variance()
+	{
+		long size = (long)this->env.size();
+		return (size > 1) ? (double)correlate(this->env.data(), this->env.data(), size) / (size - 1.0) : 0.0;
+	}
+
+	//Lag in samples of an entry - same rounding as DSP::get_autocorr
+	long get_lag_samples(long i, long size_autocorr, double bpm_min, double bpm_max)
+	{
+		//Calculate lag values -> beats/minute to seconds/beat
+		double min_lag = (double)60 / bpm_max;
+		double max_lag = (double)60 / bpm_min;
+		double lag = min_lag + (max_lag - min_lag) / (double)size_autocorr * (double)i;
+		return (long)ceil(lag * this->sample_rate);
+	}
+
+	//Squared normalized autocorrelation for a lag
+	double get_autocorr(long lag_samples, double variance)
+	{
+		long size = (long)this->env.size();
+		if ((lag_samples >= size) || (variance <= 0.0))
+			return 0.0;
+
+		double autocorr = (double)correlate(this->env.data(), this->env.data() + lag_samples, size - lag_samples);
+		autocorr = autocorr / (size - lag_samples) / variance;
+		return autocorr * autocorr;
+	}
+
+	//Sum of products - four independent sums, so the loop can be vectorized
+	static typename P::accum_t correlate(const typename P::sample_t* x, const typename P::sample_t* y, long n)
+	{
+		typename P::accum_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+		long i = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			s0 += P::product(x[i], y[i]);
+			s1 += P::product(x[i + 1], y[i + 1]);
+			s2 += P::product(x[i + 2], y[i + 2]);
+			s3 += P::product(x[i + 3], y[i + 3]);
+		}
+		for (; i < n; i++)
+			s0 += P::product(x[i], y[i]);
+		return (s0 + s1) + (s2 + s3);
+	}
+};
+
+//Create chain for a precision
+inline PrecisionChainBase* create_precision_chain(ePrecision precision, long size, long sample_rate, int downsample)
+{
+	switch (precision)
+	{
+		case ePrecisionFloat:	return new PrecisionChain<PrecisionFloat>(size, sample_rate, downsample);
+		case ePrecisionQ15:	return new PrecisionChain<PrecisionQ15>(size, sample_rate, downsample);
+		case ePrecisionQ31:	return new PrecisionChain<PrecisionQ31>(size, sample_rate, downsample);
+		default:		return new PrecisionChain<PrecisionDouble>(size, sample_rate, downsample);
+	}
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include <thread>
 #include <chrono>
 #include <fstream>
+#include <algorithm>
 #include "SplitConsole.hpp"
 #include "bpm_param.hpp"
 
@@ -24,6 +25,21 @@ extern ParamList param_list;
 	#include <stropts.h>
 #endif
 
+//Ring of the calling thread
+//When the thread terminates, the ring is released and can be reused
+//by another thread, so short-lived threads don't accumulate rings
+struct LogRingHandle
+{
+	LogRing* ring = nullptr;
+	SplitConsole* owner = nullptr;
+	~LogRingHandle()
+	{
+		if (this->ring != nullptr)
+			this->ring->in_use.store(false, std::memory_order_release);
+	}
+};
+static thread_local LogRingHandle ring_handle;
+
 SplitConsole::SplitConsole()
 {
 	//Default constructor, we assume 2 splits
@@ -31,6 +47,8 @@ SplitConsole::SplitConsole()
 	this->size.columns = dim.columns;
 	this->size.rows = dim.rows;
 	this->split = 2;
+	this->seq = 0;
+	this->logger_running = false;
 	init_splits();
 }
 
@@ -43,9 +61,20 @@ SplitConsole::SplitConsole(int split)
 	if (split > MAX_SPLIT)
 		split = MAX_SPLIT;
 	this->split = split;
+	this->seq = 0;
+	this->logger_running = false;
 	init_splits();
 }
 
+SplitConsole::~SplitConsole()
+{
+	//Render pending records and close log files
+	stop_logger();
+	for (int i = 0; i < MAX_SPLIT; i++)
+		if (this->logfile[i].is_open() == true)
+			this->logfile[i].close();
+}
+
 dimensions SplitConsole::get_console_size()
 {
 	#ifdef _WIN32
@@ -62,7 +91,12 @@ dimensions SplitConsole::get_console_size()
 		//Create struct and get console window size
 		dimensions retval;
 		struct winsize ws;
-		ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws);
+		//Output isn't a terminal (redirected, tests) - assume standard size
+		if ((ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) != 0) || (ws.ws_col == 0) || (ws.ws_row == 0))
+		{
+			ws.ws_col = 80;
+			ws.ws_row = 25;
+		}
 		retval.columns = ws.ws_col;
 		retval.rows = ws.ws_row;
 
@@ -282,10 +316,29 @@ void SplitConsole::flush_buffer(int split, bool read)
 void SplitConsole::WriteToSplitConsole(std::string in, int split)
 {
 	//Method for writing a line to the console window
-	//Location determined with 'split' parameter and the internal cursor 
-	//Lock the mutex
+	//If the logger is running, the message is copied into a record
+	if (this->logger_running.load(std::memory_order_acquire) == true)
+	{
+		LogRecord rec;
+		rec.ts = std::chrono::system_clock::now();
+		rec.split = split;
+		rec.fmt = nullptr;
+		rec.nargs = 0;
+		size_t len = in.copy(rec.text, LOG_TEXT_SIZE - 1);
+		rec.text[len] = '\0';
+		push_record(rec);
+		return;
+	}
+
+	//Otherwise write synchronously
 	this->mtx.lock();
-	
+	render_line(in, split, std::chrono::system_clock::now());
+	this->mtx.unlock();
+}
+
+void SplitConsole::render_line(const std::string& in, int split, std::chrono::system_clock::time_point ts)
+{
+	//Location determined with 'split' parameter and the internal cursor 
 	//Check if the size of the console window has changed in the meantime
 	//If yes, we have to re-initialize
 	dimensions new_dim = get_console_size();
@@ -306,7 +359,7 @@ void SplitConsole::WriteToSplitConsole(std::string in, int split)
 		split = this->split;
 
 	//Handle logging into file
-	log_message(s, split);
+	log_message(s, split, ts);
 
 	//Handle buffer - false for output
 	handle_buffer(s, split, false);
@@ -321,9 +374,177 @@ void SplitConsole::WriteToSplitConsole(std::string in, int split)
 	//Verify if std::cin is pending
 	if (this->awaiting_input == true)
 		set_console_location(this->inp_cursor.columns, this->inp_cursor.rows);
+}
+
+std::string SplitConsole::format_record(const LogRecord& rec)
+{
+	//Text records are already complete
+	if (rec.fmt == nullptr)
+		return std::string(rec.text);
+
+	//Replace placeholders with arguments
+	std::string s;
+	int arg = 0;
+	for (const char* c = rec.fmt; *c != '\0'; c++)
+	{
+		if ((c[0] == '{') && (c[1] == '}') && (arg < rec.nargs))
+		{
+			const LogArg& a = rec.args[arg++];
+			if (a.type == eLogArgBool)
+				s += (a.i != 0) ? "true" : "false";
+			else if (a.type == eLogArgDouble)
+				s += std::to_string(a.d);
+			else
+				s += std::to_string(a.i);
+			c++;
+		}
+		else
+			s += *c;
+	}
+
+	return s;
+}
+
+LogRing* SplitConsole::get_ring()
+{
+	//Fast path - thread already owns a ring
+	if ((ring_handle.ring != nullptr) && (ring_handle.owner == this))
+		return ring_handle.ring;
+
+	//Only the first write of a thread takes the lock
+	std::lock_guard<std::mutex> lock(this->rings_mtx);
+	if (ring_handle.ring != nullptr)
+		ring_handle.ring->in_use.store(false, std::memory_order_release);
+
+	//Reuse a ring released by a terminated thread
+	LogRing* ring = nullptr;
+	for (size_t i = 0; i < this->rings.size(); i++)
+	{
+		bool expected = false;
+		if (this->rings[i]->in_use.compare_exchange_strong(expected, true) == true)
+		{
+			ring = this->rings[i].get();
+			break;
+		}
+	}
 
-	//Unlock the mutex
+	//Otherwise create a new one
+	if (ring == nullptr)
+	{
+		this->rings.push_back(std::unique_ptr<LogRing>(new LogRing));
+		ring = this->rings.back().get();
+		ring->in_use.store(true, std::memory_order_relaxed);
+	}
+
+	ring_handle.ring = ring;
+	ring_handle.owner = this;
+	return ring;
+}
+
+void SplitConsole::push_record(LogRecord& rec)
+{
+	//Without logger thread, the record is rendered directly
+	if (this->logger_running.load(std::memory_order_acquire) == false)
+	{
+		std::string msg = format_record(rec);
+		this->mtx.lock();
+		render_line(msg, rec.split, rec.ts);
+		this->mtx.unlock();
+		return;
+	}
+
+	rec.seq = this->seq.fetch_add(1, std::memory_order_relaxed);
+	LogRing* ring = get_ring();
+
+	//If the ring is full, the record is dropped - the caller never waits
+	unsigned int head = ring->head.load(std::memory_order_relaxed);
+	unsigned int tail = ring->tail.load(std::memory_order_acquire);
+	if (head - tail >= LOG_RING_SIZE)
+	{
+		ring->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	ring->records[head & (LOG_RING_SIZE - 1)] = rec;
+	ring->head.store(head + 1, std::memory_order_release);
+}
+
+bool SplitConsole::drain_rings(std::vector<LogRecord>& batch)
+{
+	//Get current list of rings
+	std::vector<LogRing*> current;
+	this->rings_mtx.lock();
+	for (size_t i = 0; i < this->rings.size(); i++)
+		current.push_back(this->rings[i].get());
+	this->rings_mtx.unlock();
+
+	//Collect records of all rings
+	batch.clear();
+	unsigned long dropped = 0;
+	for (size_t i = 0; i < current.size(); i++)
+	{
+		LogRing* ring = current[i];
+		unsigned int tail = ring->tail.load(std::memory_order_relaxed);
+		unsigned int head = ring->head.load(std::memory_order_acquire);
+		while (tail != head)
+		{
+			batch.push_back(ring->records[tail & (LOG_RING_SIZE - 1)]);
+			tail++;
+		}
+		ring->tail.store(tail, std::memory_order_release);
+		dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+	}
+
+	if ((batch.empty() == true) && (dropped == 0))
+		return false;
+
+	//Restore the order of the records across threads - within this batch only
+	std::sort(batch.begin(), batch.end(), [](const LogRecord& a, const LogRecord& b) { return a.seq < b.seq; });
+
+	//Format and render the records
+	this->mtx.lock();
+	for (size_t i = 0; i < batch.size(); i++)
+		render_line(format_record(batch[i]), batch[i].split, batch[i].ts);
+	if (dropped > 0)
+		render_line("SplitConsole: Dropped " + std::to_string(dropped) + " log records.", param_list.get<int>(eParamSplitErrors), std::chrono::system_clock::now());
+	for (int i = 0; i < MAX_SPLIT; i++)
+		if (this->logfile[i].is_open() == true)
+			this->logfile[i].flush();
 	this->mtx.unlock();
+
+	return true;
+}
+
+void SplitConsole::logger_loop()
+{
+	//Background thread - formats, timestamps and renders records
+	std::vector<LogRecord> batch;
+	batch.reserve(LOG_RING_SIZE);
+	while (this->logger_running.load(std::memory_order_acquire) == true)
+	{
+		if (drain_rings(batch) == false)
+			std::this_thread::sleep_for(std::chrono::milliseconds(LOG_INTERVAL));
+	}
+
+	//Render remaining records
+	drain_rings(batch);
+}
+
+void SplitConsole::start_logger()
+{
+	if (this->logger_running.load() == true)
+		return;
+	this->logger_running.store(true, std::memory_order_release);
+	this->logger = std::thread(&SplitConsole::logger_loop, this);
+}
+
+void SplitConsole::stop_logger()
+{
+	if (this->logger_running.load() == false)
+		return;
+	this->logger_running.store(false, std::memory_order_release);
+	if (this->logger.joinable() == true)
+		this->logger.join();
 }
 
 std::string SplitConsole::ReadFromSplitConsole(std::string prompt, int split)
@@ -373,31 +594,33 @@ std::string SplitConsole::ReadFromSplitConsole(std::string prompt, int split)
 	return user_value;
 }
 
-void SplitConsole::log_message(std::string& message, int split)
+void SplitConsole::log_message(std::string& message, int split, std::chrono::system_clock::time_point ts)
 {
-	if (param_list.get<bool>("split logging") == true)
+	if (param_list.get<bool>(eParamSplitLogging) == true)
 	{
-		//Create logfile name
-		std::string fn = "console_log_" + std::to_string(split) + ".txt";
-		//Open file for output
-		std::ofstream fs(fn, std::ios_base::ate | std::ios_base::app);
+		//Open file for output - file is kept open
+		std::ofstream& fs = this->logfile[split];
 		if (fs.is_open() == false)
-			return;
-		//Get timestamp
+		{
+			//Create logfile name
+			std::string fn = "console_log_" + std::to_string(split) + ".txt";
+			fs.open(fn, std::ios_base::ate | std::ios_base::app);
+			if (fs.is_open() == false)
+				return;
+		}
+		//Get timestamp - time of the call, not of rendering
 		std::string msg = "";
-		create_timestamp(msg);
-		//Build message
-		msg = "<" + msg + "> " + message;
+		create_timestamp(msg, ts);
 		//Write log message to file
-		fs << msg << "\n";
-		//Close file handle
-		fs.close();
+		fs << "<" << msg << "> " << message << "\n";
+		//Logger thread flushes after each batch
+		if (this->logger_running.load(std::memory_order_relaxed) == false)
+			fs.flush();
 	}
 }
 
-void SplitConsole::create_timestamp(std::string& msg)
+void SplitConsole::create_timestamp(std::string& msg, std::chrono::system_clock::time_point now)
 {
-	std::chrono::time_point<std::chrono::system_clock> now = std::chrono::system_clock::now();
 	auto duration = now.time_since_epoch();
 
 	typedef std::chrono::duration<int, std::ratio_multiply<std::chrono::hours::period, std::ratio<8>>::type> Days; /* UTC: +8:00 */
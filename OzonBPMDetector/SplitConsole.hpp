@@ -2,8 +2,15 @@
 #define _SPLIT_CONSOLE_H
 
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <type_traits>
 
 #define MAX_SPLIT 6
 #define MAX_SIZE 128
@@ -11,6 +18,16 @@
 //Define for log file creation
 //Each split gets a logfile 'logX.txt' with X=SPLIT
 
+//Defines for the background logger
+//Number of records per thread ring (must be a power of 2)
+#define LOG_RING_SIZE 256
+//Maximum number of arguments per record
+#define LOG_MAX_ARGS 4
+//Maximum length of a text record (longer strings are truncated)
+#define LOG_TEXT_SIZE 160
+//Idle time of the logger thread in ms
+#define LOG_INTERVAL 5
+
 //Struct for width and height of console window
 struct dimensions
 {
@@ -18,6 +35,48 @@ struct dimensions
 	int rows;
 };
 
+//Type of a logger argument
+enum eLogArgType { eLogArgBool, eLogArgInt, eLogArgDouble };
+
+//Argument of a log record - numeric values only, so no allocation is needed
+struct LogArg
+{
+	eLogArgType type;
+	union
+	{
+		long long i;
+		double d;
+	};
+};
+
+//Compact log record
+//Either fmt points to a format string literal (placeholders '{}' are
+//replaced by the arguments) or fmt is nullptr and text holds a copy
+//of the message
+struct LogRecord
+{
+	unsigned long seq;
+	std::chrono::system_clock::time_point ts;
+	int split;
+	const char* fmt;
+	int nargs;
+	LogArg args[LOG_MAX_ARGS];
+	char text[LOG_TEXT_SIZE];
+};
+
+//Single producer/single consumer ring - every thread writing to
+//the console gets its own ring, the logger thread is the only consumer
+struct LogRing
+{
+	LogRecord records[LOG_RING_SIZE];
+	std::atomic<unsigned int> head { 0 };
+	std::atomic<unsigned int> tail { 0 };
+	//Number of records dropped because the ring was full
+	std::atomic<unsigned long> dropped { 0 };
+	//Ring is owned by a running thread
+	std::atomic<bool> in_use { false };
+};
+
 //Class for a horizontally splitted console
 class SplitConsole
 {
@@ -61,14 +120,77 @@ private:
 	std::mutex mtx;
 
 	//Handle log - creates an entry in the inter
-	void log_message(std::string& message, int split);
+	void log_message(std::string& message, int split, std::chrono::system_clock::time_point ts);
 	//Create timestamp string
-	void create_timestamp(std::string& ts);
+	void create_timestamp(std::string& ts, std::chrono::system_clock::time_point now);
+	//Open log files, one for each split
+	std::ofstream logfile[MAX_SPLIT];
+
+	//Write a processed line to the split - mutex must be held
+	void render_line(const std::string& in, int split, std::chrono::system_clock::time_point ts);
+	//Build the message string of a record
+	std::string format_record(const LogRecord& rec);
+
+	//Background logger
+	//Rings of all threads which have written to the console
+	std::vector<std::unique_ptr<LogRing>> rings;
+	std::mutex rings_mtx;
+	//Sequence number orders the records of different threads within one drained
+	//batch - a record pushed after its batch was drained is written with the next
+	//batch, so the order across batches is only guaranteed per thread
+	std::atomic<unsigned long> seq;
+	std::atomic<bool> logger_running;
+	std::thread logger;
+	//Get the ring of the calling thread
+	LogRing* get_ring();
+	//Push record into ring (or render directly if logger isn't running)
+	void push_record(LogRecord& rec);
+	//Logger thread function and ring draining
+	void logger_loop();
+	bool drain_rings(std::vector<LogRecord>& batch);
+
+	//Build logger arguments
+	template<typename T>
+	static LogArg make_arg(T value)
+	{
+		LogArg arg;
+		if (std::is_same<T, bool>::value)
+		{
+			arg.type = eLogArgBool;
+			arg.i = (long long)value;
+		}
+		else if (std::is_floating_point<T>::value)
+		{
+			arg.type = eLogArgDouble;
+			arg.d = (double)value;
+		}
+		else
+		{
+			arg.type = eLogArgInt;
+			arg.i = (long long)value;
+		}
+		return arg;
+	}
+	static void fill_args(LogRecord&) { }
+	template<typename T, typename... Args>
+	static void fill_args(LogRecord& rec, T value, Args... args)
+	{
+		if (rec.nargs < LOG_MAX_ARGS)
+			rec.args[rec.nargs++] = make_arg(value);
+		fill_args(rec, args...);
+	}
 
 public:
 	//Constructors
 	SplitConsole();
 	SplitConsole(int split);
+	~SplitConsole();
+
+	//Start and stop background logger thread
+	//While the logger is running, writing only enqueues a record and never
+	//blocks on terminal or file output. Otherwise output is synchronous.
+	void start_logger();
+	void stop_logger();
 
 	//Public methods (write, read and erase screen)
 	void WriteToSplitConsole(std::string in, int split);
@@ -78,6 +200,22 @@ public:
 	{
 		WriteToSplitConsole(in + std::to_string(value), split);
 	}
+	//Write formatted message to console - fmt must be a string literal,
+	//'{}' is replaced by the next argument (numeric types only)
+	//Formatting is deferred to the logger thread, so this is cheap to call
+	//from the audio and analysis path
+	template<typename... Args>
+	void LogToSplitConsole(int split, const char* fmt, Args... args)
+	{
+		LogRecord rec;
+		rec.ts = std::chrono::system_clock::now();
+		rec.split = split;
+		rec.fmt = fmt;
+		rec.nargs = 0;
+		rec.text[0] = '\0';
+		fill_args(rec, args...);
+		push_record(rec);
+	}
 	
 	std::string ReadFromSplitConsole(std::string prompt, int split);
 	void erase_screen();
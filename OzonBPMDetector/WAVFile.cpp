@@ -1,5 +1,6 @@
 #include "WAVFile.h"
 #include "buffer.hpp"
+#include "WAVReader.hpp"
 #include <iostream>
 #include <string>
 
@@ -90,6 +91,41 @@ int WAVFile::read_wav_file(std::ifstream& file)
 	return 0;
 }
 
+int WAVFile::read_wav_file(const std::string& filename)
+{
+#ifndef _WIN32
+	WAVReader reader;
+	if (reader.open(filename) != eSuccess)
+		return -1;
+
+	//Samples are taken directly from the mapped file
+	buffer_view<short> view = reader.get_view();
+	if (view.is_initialized() == false)
+		return -1;
+
+	//Create header struct
+	const WAVFormat& format = reader.get_format();
+	this->header.file_size = (unsigned int)(format.data_offset + format.data_size);
+	this->header.header_size = PCM_WAV_FMT_LENGTH;
+	this->header.audio_format = format.audio_format;
+	this->header.num_channels = format.num_channels;
+	this->header.sample_rate = format.sample_rate;
+	this->header.byte_rate = format.byte_rate;
+	this->header.frame_size = format.frame_size;
+	this->header.bits_sample = format.bits_sample;
+	this->header.data_size = (unsigned int)format.data_size;
+
+	//Prepare buffer and transfer data
+	this->data.init_buffer(view.get_size(), format.sample_rate);
+	for (long i = 0; i < view.get_size(); i++)
+		this->data[i] = view[i];
+
+	return 0;
+#else
+	return -1;
+#endif
+}
+
 int WAVFile::write_wav_file(std::ofstream& file)
 {
 	if (this->header.file_size == 0)
@@ -3,6 +3,7 @@
 
 #include "buffer.hpp"
 #include <fstream>
+#include <string>
 
 //Defines for .wav file creation
 //Length of header
@@ -40,6 +41,8 @@ public:
 	~WAVFile();
 
 	int read_wav_file(std::ifstream& file);
+	//Read file through the memory mapped reader - not available on WIN32
+	int read_wav_file(const std::string& filename);
 	int write_wav_file(std::ofstream& file);
 
 	WAVHeader* get_header_info() { return &this->header; }
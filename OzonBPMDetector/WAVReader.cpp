@@ -0,0 +1,325 @@
+//Memory mapping is not available on WIN32
+#ifndef _WIN32
+
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "WAVReader.hpp"
+#include "bpm_globals.hpp"
+#include "bpm_param.hpp"
+#include "SplitConsole.hpp"
+
+//Extern split console instance
+extern SplitConsole my_console;
+//Extern parameter list
+extern ParamList param_list;
+
+//Files above 2 GB need a 64 bit off_t on 32 bit systems (-D_FILE_OFFSET_BITS=64),
+//offsets which don't fit are rejected instead of being truncated
+static bool offset_valid(unsigned long long offset)
+{
+	return (offset <= (unsigned long long)std::numeric_limits<off_t>::max());
+}
+
+//Helper functions for little endian values
+static unsigned int get_u16(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static unsigned int get_u32(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static unsigned long long get_u64(const unsigned char* p)
+{
+	return get_u32(p) | ((unsigned long long)get_u32(p + 4) << 32);
+}
+
+WAVChunkIterator::WAVChunkIterator(WAVReader* reader, unsigned long long frame, long frames)
+{
+	this->reader = reader;
+	this->frame = frame;
+	this->frames = frames;
+}
+
+buffer_view<short> WAVChunkIterator::operator*()
+{
+	return this->reader->get_view(this->frame, this->frames);
+}
+
+WAVChunkIterator& WAVChunkIterator::operator++()
+{
+	//Stop at the end, so the iterator matches end()
+	unsigned long long total = this->reader->get_frames();
+	this->frame += this->frames;
+	if (this->frame > total)
+		this->frame = total;
+	return *this;
+}
+
+WAVChunkIterator WAVChunks::begin()
+{
+	//No chunks if frames is invalid
+	if (this->frames <= 0)
+		return end();
+	return WAVChunkIterator(this->reader, 0, this->frames);
+}
+
+WAVChunkIterator WAVChunks::end()
+{
+	return WAVChunkIterator(this->reader, this->reader->get_frames(), this->frames);
+}
+
+WAVReader::WAVReader()
+{
+	this->fd = -1;
+	this->file_size = 0;
+	memset(&this->format, 0, sizeof(this->format));
+	this->map = nullptr;
+	this->map_offset = 0;
+	this->map_length = 0;
+}
+
+WAVReader::~WAVReader()
+{
+	close();
+}
+
+eError WAVReader::open(const std::string& filename)
+{
+	close();
+
+	this->fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if (this->fd < 0)
+		return eAudio_ErrorInputStreamNotOpen;
+
+	struct stat st;
+	if (fstat(this->fd, &st) != 0)
+	{
+		close();
+		return eAudio_ErrorInputStreamNotOpen;
+	}
+	this->file_size = st.st_size;
+
+	eError retval = parse();
+	if (retval != eSuccess)
+	{
+		close();
+		return retval;
+	}
+
+	//Try to map all the data at once, otherwise windows are mapped on demand
+	map_range(this->format.data_offset, this->format.data_size);
+
+	if (param_list.get<bool>(eParamDebugWavfile) == true)
+	{
+		my_console.WriteToSplitConsole("WAV Reader: " + filename + ", " + std::to_string(get_frames()) + " frames, " + std::to_string(this->format.sample_rate) + " Hz, " + std::to_string(this->format.num_channels) + " channels.", param_list.get<int>(eParamSplitAudio));
+		my_console.WriteToSplitConsole("WAV Reader: Data at " + std::to_string(this->format.data_offset) + ", rf64 = " + std::to_string(this->format.rf64) + ", mapped = " + std::to_string(this->map_length), param_list.get<int>(eParamSplitAudio));
+	}
+
+	return eSuccess;
+}
+
+void WAVReader::close()
+{
+	unmap();
+	if (this->fd >= 0)
+		::close(this->fd);
+	this->fd = -1;
+	this->file_size = 0;
+	memset(&this->format, 0, sizeof(this->format));
+}
+
+unsigned long long WAVReader::get_frames()
+{
+	if (this->format.frame_size == 0)
+		return 0;
+	return this->format.data_size / this->format.frame_size;
+}
+
+buffer_view<short> WAVReader::get_view(unsigned long long frame, long count)
+{
+	unsigned long long frames = get_frames();
+	if ((frame >= frames) || (count <= 0))
+		return buffer_view<short>();
+	if ((unsigned long long)count > frames - frame)
+		count = (long)(frames - frame);
+
+	unsigned long long offset = this->format.data_offset + frame * this->format.frame_size;
+	unsigned long long size = (unsigned long long)count * this->format.frame_size;
+	if (map_range(offset, size) == false)
+		return buffer_view<short>();
+
+	const short* values = (const short*)((const char*)this->map + (offset - this->map_offset));
+	return buffer_view<short>(values, count * this->format.num_channels, this->format.sample_rate);
+}
+
+buffer_view<short> WAVReader::get_view()
+{
+	//Only possible if the data has been mapped at once
+	if ((this->map == nullptr) || (this->map_offset > this->format.data_offset)
+	    || (this->map_offset + this->map_length < this->format.data_offset + this->format.data_size))
+		return buffer_view<short>();
+
+	return get_view(0, (long)get_frames());
+}
+
+eError WAVReader::parse()
+{
+	//RIFF header: 'RIFF' or 'RF64', size, 'WAVE'
+	unsigned char header[12];
+	if (read_at(0, header, 12) == false)
+		return eAudio_InvalidWavFile;
+
+	if (memcmp(header + 8, "WAVE", 4) != 0)
+		return eAudio_InvalidWavFile;
+	if (memcmp(header, "RIFF", 4) == 0)
+		this->format.rf64 = false;
+	else if (memcmp(header, "RF64", 4) == 0)
+		this->format.rf64 = true;
+	else
+		return eAudio_InvalidWavFile;
+
+	//Data size of RF64 files is stored in the ds64 chunk
+	unsigned long long ds64_data_size = 0;
+	bool ds64_found = false;
+	bool fmt_found = false;
+	bool data_found = false;
+
+	//Walk through the chunks - unknown chunks (LIST, fact, cue...) are skipped
+	unsigned long long pos = 12;
+	while (pos + 8 <= this->file_size)
+	{
+		unsigned char chunk[8];
+		if (read_at(pos, chunk, 8) == false)
+			break;
+
+		unsigned long long size = get_u32(chunk + 4);
+		unsigned long long body = pos + 8;
+
+		if (memcmp(chunk, "ds64", 4) == 0)
+		{
+			//RIFF size (8 bytes), data size (8 bytes), sample count (8 bytes), table
+			unsigned char ds64[16];
+			if ((size < 16) || (read_at(body, ds64, 16) == false))
+				return eAudio_InvalidWavFile;
+			ds64_data_size = get_u64(ds64 + 8);
+			ds64_found = true;
+		}
+		else if (memcmp(chunk, "fmt ", 4) == 0)
+		{
+			//Standard format (16 bytes), extensible format has the sub format at byte 24
+			unsigned char fmt[40];
+			memset(fmt, 0, sizeof(fmt));
+			if ((size < 16) || (read_at(body, fmt, (size < 40) ? (unsigned long)size : 40) == false))
+				return eAudio_InvalidWavFile;
+
+			this->format.audio_format = get_u16(fmt);
+			this->format.num_channels = get_u16(fmt + 2);
+			this->format.sample_rate = get_u32(fmt + 4);
+			this->format.byte_rate = get_u32(fmt + 8);
+			this->format.frame_size = get_u16(fmt + 12);
+			this->format.bits_sample = get_u16(fmt + 14);
+			if ((this->format.audio_format == WAV_FORMAT_EXTENSIBLE) && (size >= 40))
+				this->format.audio_format = get_u16(fmt + 24);
+			fmt_found = true;
+		}
+		else if (memcmp(chunk, "data", 4) == 0)
+		{
+			//The ds64 chunk comes before the data, without it the size is unknown
+			if ((this->format.rf64 == true) && (size == WAV_RF64_SIZE))
+			{
+				if (ds64_found == false)
+					return eAudio_InvalidWavFile;
+				size = ds64_data_size;
+			}
+
+			//Files which have been cut off while recording keep the original size
+			if (size > this->file_size - body)
+				size = this->file_size - body;
+
+			this->format.data_offset = body;
+			this->format.data_size = size;
+			data_found = true;
+		}
+
+		if ((fmt_found == true) && (data_found == true))
+			break;
+
+		//Chunks are padded to an even size
+		pos = body + size + (size & 1);
+	}
+
+	if ((fmt_found == false) || (data_found == false))
+		return eAudio_InvalidWavFile;
+
+	//Views are only possible for 16 bit PCM
+	if ((this->format.audio_format != WAV_FORMAT_PCM) || (this->format.bits_sample != 16)
+	    || (this->format.num_channels == 0) || (this->format.frame_size != 2 * this->format.num_channels))
+		return eAudio_InvalidWavFile;
+
+	return eSuccess;
+}
+
+bool WAVReader::read_at(unsigned long long offset, unsigned char* dst, unsigned long size)
+{
+	//Only used for the chunk headers
+	if (offset_valid(offset + size) == false)
+		return false;
+	return (pread(this->fd, dst, size, (off_t)offset) == (ssize_t)size);
+}
+
+bool WAVReader::map_range(unsigned long long offset, unsigned long long size)
+{
+	//Range already mapped?
+	if ((this->map != nullptr) && (offset >= this->map_offset)
+	    && (offset + size <= this->map_offset + this->map_length))
+		return true;
+
+	unmap();
+
+	//Mapping must start at a page boundary
+	unsigned long long page = sysconf(_SC_PAGESIZE);
+	unsigned long long start = offset - (offset % page);
+	unsigned long long end = offset + size;
+
+	//Map at least one window, so streaming doesn't map every chunk
+	if (end - start < WAV_WINDOW_SIZE)
+		end = start + WAV_WINDOW_SIZE;
+	if (end > this->file_size)
+		end = this->file_size;
+
+	//Range doesn't fit into the address space or the file offset type
+	if (end - start > (unsigned long long)(size_t)-1)
+		return false;
+	if (offset_valid(start) == false)
+		return false;
+
+	void* map = mmap(nullptr, (size_t)(end - start), PROT_READ, MAP_SHARED, this->fd, (off_t)start);
+	if (map == MAP_FAILED)
+		return false;
+
+	//Data is usually read from start to end
+	madvise(map, (size_t)(end - start), MADV_SEQUENTIAL);
+
+	this->map = map;
+	this->map_offset = start;
+	this->map_length = end - start;
+	return true;
+}
+
+void WAVReader::unmap()
+{
+	if (this->map != nullptr)
+		munmap(this->map, (size_t)this->map_length);
+	this->map = nullptr;
+	this->map_offset = 0;
+	this->map_length = 0;
+}
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef _WAV_READER_H
+#define _WAV_READER_H
+
+#include <string>
+#include "bpm_globals.hpp"
+#include "buffer.hpp"
+
+//Defines for the wav reader
+//Size of the mapped window if the data can't be mapped at once
+#define WAV_WINDOW_SIZE (16 * 1024 * 1024)
+//Format tags
+#define WAV_FORMAT_PCM 1
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+//Chunk size of RF64 files which is replaced by the value in the ds64 chunk
+#define WAV_RF64_SIZE 0xFFFFFFFF
+
+//Format of a wav file
+struct WAVFormat
+{
+	unsigned short audio_format;
+	unsigned short num_channels;
+	unsigned int   sample_rate;
+	unsigned int   byte_rate;
+	unsigned short frame_size;
+	unsigned short bits_sample;
+	//Position and size of the sample data in the file
+	unsigned long long data_offset;
+	unsigned long long data_size;
+	//File uses the RF64 extension (sizes above 4GB)
+	bool rf64;
+};
+
+class WAVReader;
+
+//Iterator over the sample data in chunks of a fixed number of frames
+//Dereferencing gives a view of the current chunk, the last chunk may be shorter
+class WAVChunkIterator
+{
+public:
+	WAVChunkIterator(WAVReader* reader, unsigned long long frame, long frames);
+
+	buffer_view<short> operator*();
+	WAVChunkIterator& operator++();
+	bool operator!=(const WAVChunkIterator& rhs) const { return (this->frame != rhs.frame); }
+
+private:
+	WAVReader* reader;
+	unsigned long long frame;
+	long frames;
+};
+
+//Range of chunks - used in range based for loops
+class WAVChunks
+{
+public:
+	WAVChunks(WAVReader* reader, long frames) : reader(reader), frames(frames) { }
+
+	WAVChunkIterator begin();
+	WAVChunkIterator end();
+
+private:
+	WAVReader* reader;
+	long frames;
+};
+
+//Reader for PCM wav files (RIFF and RF64)
+//The file is memory mapped and the samples are handed out as views,
+//so no sample is copied or converted. Only 16 bit PCM is supported.
+//Samples are little endian in the file, so the views are only valid
+//on little endian machines (Raspberry Pi, x86).
+//If the sample data doesn't fit into the address space (e.g. a long
+//recording on a 32 bit system), it is mapped in windows of WAV_WINDOW_SIZE.
+//Usage:
+//	WAVReader reader;
+//	reader.open("set.wav");
+//	for (buffer_view<short> chunk : reader.chunks(PCM_BUF_SIZE))
+//		... process chunk ...
+class WAVReader
+{
+public:
+	WAVReader();
+	~WAVReader();
+
+	//Open file and parse chunks
+	eError open(const std::string& filename);
+	void close();
+	bool is_open() { return (this->fd >= 0); }
+
+	//Getter methods
+	const WAVFormat& get_format() { return this->format; }
+	unsigned long long get_frames();
+
+	//View of count frames starting at frame - count is limited to the end of the data
+	//If the data is mapped in windows, the view is only valid until the next call
+	//Channels are interleaved, so the view contains count * channels samples
+	buffer_view<short> get_view(unsigned long long frame, long count);
+	//View of all frames - empty if the data can't be mapped at once
+	buffer_view<short> get_view();
+
+	//Chunks of frames for streaming through the file
+	WAVChunks chunks(long frames) { return WAVChunks(this, frames); }
+
+private:
+	//File handle and size
+	int fd;
+	unsigned long long file_size;
+	//Format of the file
+	WAVFormat format;
+
+	//Mapped part of the file
+	void* map;
+	unsigned long long map_offset;
+	unsigned long long map_length;
+
+	//Parse RIFF chunks
+	eError parse();
+	//Read bytes at position of the file
+	bool read_at(unsigned long long offset, unsigned char* dst, unsigned long size);
+	//Make sure the range of the file is mapped
+	bool map_range(unsigned long long offset, unsigned long long size);
+	void unmap();
+};
+
+#endif
@@ -44,10 +44,10 @@ eError init_appl()
 	//Declare return value
 	eError retval = eSuccess;
 
-	int split = param_list.get<int>("split main");
-	if (param_list.get<bool>("debug main") == true)
+	int split = param_list.get<int>(eParamSplitMain);
+	if (param_list.get<bool>(eParamDebugMain) == true)
 	{
-		my_console.WriteToSplitConsole("Application init function.", param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("Application init function.", param_list.get<int>(eParamSplitMain));
 		std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_WAIT));
 	}
 
@@ -89,17 +89,17 @@ eError init_gpio()
 
 	#ifndef _WIN32
 
-	if (param_list.get<bool>("debug main") == true)
+	if (param_list.get<bool>(eParamDebugMain) == true)
 	{
-		my_console.WriteToSplitConsole("GPIO init function.", param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("GPIO init function.", param_list.get<int>(eParamSplitMain));
 		std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_WAIT));
 	}
 
 	//Initialize GPIO
 	int result = GPIOPin::init_gpio();
 
-	if (param_list.get<bool>("debug main") == true)
-		my_console.WriteToSplitConsole("Initialize wiringPi... return = " + std::to_string(result), param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugMain) == true)
+		my_console.WriteToSplitConsole("Initialize wiringPi... return = " + std::to_string(result), param_list.get<int>(eParamSplitMain));
 
 	if (result != 0)
 	{
@@ -109,8 +109,21 @@ eError init_gpio()
 	//Create GPIO writer
 	gpio_info.gpio_writer = new(std::nothrow) GPIOWriter();
 
+	//Display is multiplexed by the refresh thread of the writer
+	if (gpio_info.gpio_writer != nullptr)
+		gpio_info.gpio_writer->start_refresh();
+
 	//Create GPIO button
-	gpio_info.gpio_button = new(std::nothrow) GPIOButton();
+	//Edge events are used if the line can be requested from the GPIO character device,
+	//otherwise the button is polled by the SIR
+	GPIOLineChardev* line = new(std::nothrow) GPIOLineChardev(RESET_PIN_1);
+	if ((line != nullptr) && (line->check_init() == eSuccess))
+		gpio_info.gpio_button = new(std::nothrow) GPIOButton(line);
+	else
+	{
+		delete line;
+		gpio_info.gpio_button = new(std::nothrow) GPIOButton();
+	}
 
 	//Check if objects have been created successfully
 	if ((gpio_info.gpio_writer == nullptr) || (gpio_info.gpio_button == nullptr)
@@ -130,9 +143,9 @@ eError init_bpm()
 	eError retval = eSuccess;
 
 	//Initialize BPM - audio and analysis
-	if (param_list.get<bool>("debug main") == true)
+	if (param_list.get<bool>(eParamDebugMain) == true)
 	{
-		my_console.WriteToSplitConsole("BPM init function.", param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("BPM init function.", param_list.get<int>(eParamSplitMain));
 		std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_WAIT));
 	}
 
@@ -152,12 +165,90 @@ eError init_bpm()
 	return retval;
 }
 
+void simulate_keyb_quit()
+{
+	#ifndef _WIN32
+		//Simulate keyboard input '0' and enter
+		//No other possibility to cancel std::cin from remote  (in 'ReadFromSplitConsole')
+		//Since std::cin is blocking until data from keyboard is available
+		//So we do it by simulating a keyboard keypress
+		if (param_list.get<bool>(eParamDebugMain) == true)
+			my_console.WriteToSplitConsole("Simulated quit command.", param_list.get<int>(eParamSplitMain));
+
+		xdo_t* x = xdo_new(NULL);
+		xdo_enter_text_window(x, CURRENTWINDOW, "0", 100000);
+		xdo_send_keysequence_window(x, CURRENTWINDOW, "Return", 100000);
+		xdo_free(x);
+	#endif
+}
+
+//Button events - executed by the queue
+//Commands are executed only once
+void button_pressed()
+{
+	//Restart the program
+	static bool restart_issued = false;
+	if (restart_issued == false)
+	{
+		simulate_keyb_quit();
+		system("./bpm_restart.sh &"); //The ampersand is important here, making the execution async!
+		restart_issued = true;
+	}
+}
+
+void button_held_short()
+{
+	//Reboot the PI
+	static bool reboot_issued = false;
+	if (reboot_issued == false)
+	{
+		simulate_keyb_quit();
+		system("./bpm_reboot.sh &"); //The ampersand is important here, making the execution async!
+		reboot_issued = true;
+	}
+}
+
+void button_held_long()
+{
+	//Shutdown the PI
+	static bool shutdown_issued = false;
+	if (shutdown_issued == false)
+	{
+		simulate_keyb_quit();
+		system("./bpm_shutdown.sh &"); //The ampersand is important here, making the execution async!
+		shutdown_issued = true;
+	}
+}
+
+#ifndef _WIN32
+//Send button state to the queue
+//Called by the event thread of the button or by the SIR
+void button_handler(eButtonHandlerState state)
+{
+	switch (state)
+	{
+		case Handler_ButtonPressed:
+			SEND_EVENT(eButtonPressed);
+			break;
+		case Handler_ButtonHeldShort:
+			SEND_EVENT(eButtonHeldShort);
+			break;
+		case Handler_ButtonHeldLong:
+			SEND_EVENT(eButtonHeldLong);
+			break;
+		default:
+			//Here, we don't do anything
+			break;
+	}
+}
+#endif
+
 eError init_events()
 {
 	//We create and initialize all the events and timers used
-	if (param_list.get<bool>("debug main") == true)
+	if (param_list.get<bool>(eParamDebugMain) == true)
 	{
-		my_console.WriteToSplitConsole("Event/timer init function.", param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("Event/timer init function.", param_list.get<int>(eParamSplitMain));
 		std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_WAIT));
 	}
 
@@ -180,6 +271,9 @@ eError init_events()
 	event_info.push_back(new(std::nothrow) FCEvent(eCheckRMSValue));
 	event_info.push_back(new(std::nothrow) FCEvent(eReadWavFile));
 	event_info.push_back(new(std::nothrow) FCEvent(eStopRecording));
+	event_info.push_back(new(std::nothrow) FCEvent(eButtonPressed));
+	event_info.push_back(new(std::nothrow) FCEvent(eButtonHeldShort));
+	event_info.push_back(new(std::nothrow) FCEvent(eButtonHeldLong));
 	
 	//Create the timers
 	event_info.push_back(new(std::nothrow) FCTimer(eTestTimer1, 5000000));
@@ -213,6 +307,9 @@ eError init_events()
 	retval.push_back(event_info[eCheckRMSValue]->init_event(&BPMAnalyze::check_rms_value, bpm_info.bpm_analyze));
 	retval.push_back(event_info[eReadWavFile]->init_event(&BPMAudio::read_std_wav_file, bpm_info.bpm_audio));
 	retval.push_back(event_info[eStopRecording]->init_event(&BPMAudio::stop_recording, bpm_info.bpm_audio));
+	retval.push_back(event_info[eButtonPressed]->init_event(button_pressed));
+	retval.push_back(event_info[eButtonHeldShort]->init_event(button_held_short));
+	retval.push_back(event_info[eButtonHeldLong]->init_event(button_held_long));
 
 	//Initialize the timers
 	retval.push_back(event_info[eTestTimer1]->init_event(timer1_elapsed));
@@ -243,12 +340,47 @@ eError init_events()
 	return success;
 }
 
+void dump_timing()
+{
+	//Write stage timing statistics to console and file
+	int split = param_list.get<int>(eParamSplitMain);
+	my_console.WriteToSplitConsole("Timing of bpm analysis:", split);
+	for (int i = 0; i < eNumberOfStages; i++)
+	{
+		std::string line = bpm_timing.get_stage_report((eStages)i);
+		if (line != "")
+			my_console.WriteToSplitConsole(line, split);
+	}
+
+	//Display refresh jitter
+	#ifndef _WIN32
+		std::string refresh = gpio_info.gpio_writer->get_refresh_report("\n");
+		size_t pos = 0;
+		size_t eol;
+		while ((eol = refresh.find('\n', pos)) != std::string::npos)
+		{
+			my_console.WriteToSplitConsole(refresh.substr(pos, eol - pos), split);
+			pos = eol + 1;
+		}
+	#endif
+
+	std::ofstream fs("bpm_timing.txt", std::ios_base::out | std::ios_base::trunc);
+	if (fs.is_open() == true)
+	{
+		fs << bpm_timing.get_report("\n");
+		#ifndef _WIN32
+			fs << refresh;
+		#endif
+		fs.close();
+	}
+}
+
 void exit_application()
 {
 	//The user entered exit code
 	//Stop all the async threads and exit application
 	eError exit_retval;
-	my_console.WriteToSplitConsole("Exiting!", param_list.get<int>("split main"));
+	my_console.WriteToSplitConsole("Exiting!", param_list.get<int>(eParamSplitMain));
 	SEND_EVENT(eQuit);
 	
 	//Wait for a short amount of time to display the quit string
@@ -259,15 +391,15 @@ void exit_application()
 
 	//Retrieve exit return value
 	exit_retval = appl_info.os_thread.get();
-	my_console.WriteToSplitConsole("Return value of queue = " + std::to_string((int)exit_retval) + ".", param_list.get<int>("split main")); 
+	my_console.WriteToSplitConsole("Return value of queue = " + std::to_string((int)exit_retval) + ".", param_list.get<int>(eParamSplitMain)); 
 	exit_retval = appl_info.os_SIR.get();
-	my_console.WriteToSplitConsole("Return value of SIR = " + std::to_string((int)exit_retval) + ".", param_list.get<int>("split main"));
+	my_console.WriteToSplitConsole("Return value of SIR = " + std::to_string((int)exit_retval) + ".", param_list.get<int>(eParamSplitMain));
 	
 	//Stop socket
 	#ifndef _WIN32
 		appl_info.os_socket->stop_listening();
 		exit_retval = appl_info.socket_thread.get();
-		my_console.WriteToSplitConsole("Return value of socket = " + std::to_string((int)exit_retval) + ".", param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("Return value of socket = " + std::to_string((int)exit_retval) + ".", param_list.get<int>(eParamSplitMain));
 	#endif
 
 	//We stop the machine
@@ -275,7 +407,10 @@ void exit_application()
 
 	//Retrieve the exit return value
 	exit_retval = appl_info.machine_thread.get();
-	my_console.WriteToSplitConsole("Return value of state machine = " + std::to_string((int)exit_retval) + ".", param_list.get<int>("split main"));							
+	my_console.WriteToSplitConsole("Return value of state machine = " + std::to_string((int)exit_retval) + ".", param_list.get<int>(eParamSplitMain));							
+
+	//Dump timing statistics of bpm analysis
+	dump_timing();
 }
 
 void control_statemachine()
@@ -307,33 +442,33 @@ void control_statemachine()
 				break;
 			case eKeyBPMCounter:
 				//We go to state BPM
-				my_console.WriteToSplitConsole("Going to state BPM...", param_list.get<int>("split main"));
+				my_console.WriteToSplitConsole("Going to state BPM...", param_list.get<int>(eParamSplitMain));
 				SEND_EVENT(eGoToStateBPM);
 				break;
 			case eKeyTimer:
 				//We go to state Timer
-				my_console.WriteToSplitConsole("Going to state Timer...", param_list.get<int>("split main"));
+				my_console.WriteToSplitConsole("Going to state Timer...", param_list.get<int>(eParamSplitMain));
 				SEND_EVENT(eGoToStateTimer);
 				break;
 			case eKeyClock:
 				//We go to state Clock
-				my_console.WriteToSplitConsole("Going to state Clock...", param_list.get<int>("split main"));
+				my_console.WriteToSplitConsole("Going to state Clock...", param_list.get<int>(eParamSplitMain));
 				SEND_EVENT(eGoToStateClock);
 				break;
 			case eKeyManual:
 				//We go to state Manual Console
-				my_console.WriteToSplitConsole("Going to state Manual Console...", param_list.get<int>("split main"));
+				my_console.WriteToSplitConsole("Going to state Manual Console...", param_list.get<int>(eParamSplitMain));
 				SEND_EVENT(eGoToStateManual);
 				manual_mode();
 				break;
 			case eKeyTCP:
 				//We go to state Manual TCP
-				my_console.WriteToSplitConsole("Going to state Manual TCP...", param_list.get<int>("split main"));
+				my_console.WriteToSplitConsole("Going to state Manual TCP...", param_list.get<int>(eParamSplitMain));
 				SEND_INT_EVENT(eChangeState, eStateTCP);
 				break;
 			default:
 				//Unknown command - we just ignore it
-				my_console.WriteToSplitConsole("Unknown command.", param_list.get<int>("split main"));
+				my_console.WriteToSplitConsole("Unknown command.", param_list.get<int>(eParamSplitMain));
 				break;
 		}
 	}
@@ -342,23 +477,6 @@ void control_statemachine()
 	std::this_thread::sleep_for(std::chrono::milliseconds(EXIT_WAIT));
 }
 
-void simulate_keyb_quit()
-{
-	#ifndef _WIN32
-		//Simulate keyboard input '0' and enter
-		//No other possibility to cancel std::cin from remote  (in 'ReadFromSplitConsole')
-		//Since std::cin is blocking until data from keyboard is available
-		//So we do it by simulating a keyboard keypress
-		if (param_list.get<bool>("debug main") == true)
-			my_console.WriteToSplitConsole("Simulated quit command.", param_list.get<int>("split main"));
-
-		xdo_t* x = xdo_new(NULL);
-		xdo_enter_text_window(x, CURRENTWINDOW, "0", 100000);
-		xdo_send_keysequence_window(x, CURRENTWINDOW, "Return", 100000);
-		xdo_free(x);
-	#endif
-}
-
 void software_interrupt_routine()
 {
 	//Important: code in here is not allowed to block the application
@@ -374,8 +492,8 @@ void software_interrupt_routine()
 	{
 		//The state machine thread has finished with an error - get error code
 		eError error_code = appl_info.machine_thread.get();
-		my_console.WriteToSplitConsole("Error in state machine - detected in SIR...", param_list.get<int>("split errors"));
-		my_console.WriteToSplitConsole("The error code was " + std::to_string((int)error_code) + ".", param_list.get<int>("split errors"));
+		my_console.WriteToSplitConsole("Error in state machine - detected in SIR...", param_list.get<int>(eParamSplitErrors));
+		my_console.WriteToSplitConsole("The error code was " + std::to_string((int)error_code) + ".", param_list.get<int>(eParamSplitErrors));
 		exit(error_code);
 	}
 
@@ -385,8 +503,8 @@ void software_interrupt_routine()
 	{
 		//The queue thread has finished with an error - get error code
 		eError error_code = appl_info.os_thread.get();
-		my_console.WriteToSplitConsole("Error in queue - detected in SIR...", param_list.get<int>("split errors"));
-		my_console.WriteToSplitConsole("The error code was " + std::to_string((int)error_code) + ".", param_list.get<int>("split errors"));
+		my_console.WriteToSplitConsole("Error in queue - detected in SIR...", param_list.get<int>(eParamSplitErrors));
+		my_console.WriteToSplitConsole("The error code was " + std::to_string((int)error_code) + ".", param_list.get<int>(eParamSplitErrors));
 		exit(error_code);
 	}
 
@@ -396,51 +514,15 @@ void software_interrupt_routine()
 
 	#ifndef _WIN32
 		//Check reset pin status - periodically call get_state
-		eButtonHandlerState state = gpio_info.gpio_button->get_state();
-
-		//Execute commands only once
-		static bool restart_issued = false;
-		static bool reboot_issued = false;
-		static bool shutdown_issued = false;
-		switch (state)
+		//Only needed if the button doesn't have edge events
+		if (gpio_info.gpio_button->is_edge_triggered() == false)
 		{
-			case Handler_ButtonReleased:
-				//Do nothing
-				break;
-
-			case Handler_ButtonPressed:
-				//Restart the program
-				if (restart_issued == false)
-				{
-					simulate_keyb_quit();
-					system("./bpm_restart.sh &"); //The ampersand is important here, making the execution async!
-					restart_issued = true;
-				}	
-				break;
-
-			case Handler_ButtonHeldShort:
-				//Reboot the PI
-				if (reboot_issued == false)
-				{
-					simulate_keyb_quit();
-					system("./bpm_reboot.sh &"); //The ampersand is important here, making the execution async!
-					reboot_issued = true;
-				}
-				break;
-
-			case Handler_ButtonHeldLong:
-				//Shutdown the PI
-				if (shutdown_issued == false)
-				{
-					simulate_keyb_quit();
-					system("./bpm_shutdown.sh &"); //The ampersand is important here, making the execution async!
-					shutdown_issued = true;
-				}
-				break;
-
-			default:
-				//Here, we don't do anything
-				break;
+			//Send event only once per state change
+			static eButtonHandlerState state_old = Handler_ButtonReleased;
+			eButtonHandlerState state = gpio_info.gpio_button->get_state();
+			if (state != state_old)
+				button_handler(state);
+			state_old = state;
 		}
 
 		//Check if there is some command pending from the socket
@@ -478,12 +560,15 @@ void software_interrupt_routine()
 int main(int argc, char **argv)
 {
 	//Begin of main routine
-	if (param_list.get<bool>("debug main") == true)
+	//Console output is rendered by the logger thread from now on
+	my_console.start_logger();
+
+	if (param_list.get<bool>(eParamDebugMain) == true)
 	{
-    		my_console.WriteToSplitConsole("Starting main...", param_list.get<int>("split main"));
+    		my_console.WriteToSplitConsole("Starting main...", param_list.get<int>(eParamSplitMain));
 		std::string s = "Path: ";
 		s.append(FILE_PATH);
-		my_console.WriteToSplitConsole(s, param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole(s, param_list.get<int>(eParamSplitMain));
 	}
 
 	//Declare return value
@@ -493,8 +578,8 @@ int main(int argc, char **argv)
 	retval = init_appl();
 	if (retval != eSuccess)
 	{
-		my_console.WriteToSplitConsole("Error during application init.", param_list.get<int>("split errors"));
-		my_console.WriteToSplitConsole("Errorcode: " + std::to_string(retval), param_list.get<int>("split errors"));
+		my_console.WriteToSplitConsole("Error during application init.", param_list.get<int>(eParamSplitErrors));
+		my_console.WriteToSplitConsole("Errorcode: " + std::to_string(retval), param_list.get<int>(eParamSplitErrors));
 		
 		//If socket was initialized properly, stop it
 		#ifndef _WIN32
@@ -509,7 +594,7 @@ int main(int argc, char **argv)
 		if (HDMI::get_HDMI_state() == true)
 		{
 			appl_info.hdmi_attached = true;
-			my_console.WriteToSplitConsole("HDMI display detected.", param_list.get<int>("split main"));
+			my_console.WriteToSplitConsole("HDMI display detected.", param_list.get<int>(eParamSplitMain));
 	
 			//Initialize window
 			FCWindowManager::init(argc, argv);
@@ -519,7 +604,7 @@ int main(int argc, char **argv)
 		else
 		{
 			appl_info.hdmi_attached = false;
-			my_console.WriteToSplitConsole("HDMI display NOT detected.", param_list.get<int>("split main"));
+			my_console.WriteToSplitConsole("HDMI display NOT detected.", param_list.get<int>(eParamSplitMain));
 		}
 	#endif	
 
@@ -527,8 +612,8 @@ int main(int argc, char **argv)
 	retval = init_gpio();
 	if (retval != eSuccess)
 	{
-		my_console.WriteToSplitConsole("Error during GPIO init.", param_list.get<int>("split errors"));
-		my_console.WriteToSplitConsole("Errorcode: " + std::to_string(retval), param_list.get<int>("split errors"));
+		my_console.WriteToSplitConsole("Error during GPIO init.", param_list.get<int>(eParamSplitErrors));
+		my_console.WriteToSplitConsole("Errorcode: " + std::to_string(retval), param_list.get<int>(eParamSplitErrors));
 		exit(retval);
 	}
 
@@ -536,8 +621,8 @@ int main(int argc, char **argv)
 	retval = init_bpm();
 	if (retval != eSuccess)
 	{
-		my_console.WriteToSplitConsole("Error during BPM init.", param_list.get<int>("split errors"));
-		my_console.WriteToSplitConsole("Errorcode: " + std::to_string(retval), param_list.get<int>("split errors"));
+		my_console.WriteToSplitConsole("Error during BPM init.", param_list.get<int>(eParamSplitErrors));
+		my_console.WriteToSplitConsole("Errorcode: " + std::to_string(retval), param_list.get<int>(eParamSplitErrors));
 		exit(retval);
 	}
 
@@ -545,8 +630,8 @@ int main(int argc, char **argv)
 	retval = init_events();
 	if (retval != eSuccess)
 	{
-		my_console.WriteToSplitConsole("Error during event/timer init.", param_list.get<int>("split errors"));
-		my_console.WriteToSplitConsole("Errorcode: " + std::to_string(retval), param_list.get<int>("split errors"));
+		my_console.WriteToSplitConsole("Error during event/timer init.", param_list.get<int>(eParamSplitErrors));
+		my_console.WriteToSplitConsole("Errorcode: " + std::to_string(retval), param_list.get<int>(eParamSplitErrors));
 		exit(retval);
 	}
 	
@@ -578,30 +663,30 @@ int main(int argc, char **argv)
 	appl_info.os_machine->bind_function(StateX_exit,  	eStateTCP);
 
 	//Write debug line
-	if (param_list.get<bool>("debug main") == true)
+	if (param_list.get<bool>(eParamDebugMain) == true)
 	{
-		my_console.WriteToSplitConsole("Binding done.", param_list.get<int>("split main"));
-		my_console.WriteToSplitConsole("Starting state machine...", param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("Binding done.", param_list.get<int>(eParamSplitMain));
+		my_console.WriteToSplitConsole("Starting state machine...", param_list.get<int>(eParamSplitMain));
 		std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_WAIT));
 	}
 		
 	//Start the state machine
 	appl_info.machine_thread = appl_info.os_machine->start_machine();
 
-	if (param_list.get<bool>("debug main") == true)
+	if (param_list.get<bool>(eParamDebugMain) == true)
 	{
-		my_console.WriteToSplitConsole("State machine running.", param_list.get<int>("split main"));
-		my_console.WriteToSplitConsole("Binding software interrupt routine...", param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("State machine running.", param_list.get<int>(eParamSplitMain));
+		my_console.WriteToSplitConsole("Binding software interrupt routine...", param_list.get<int>(eParamSplitMain));
 		std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_WAIT));
 	}
 		
 	//Bind software interrupt routine to queue
 	appl_info.os_queue->set_SIR(software_interrupt_routine);	
 	
-	if (param_list.get<bool>("debug main") == true)
+	if (param_list.get<bool>(eParamDebugMain) == true)
 	{
-		my_console.WriteToSplitConsole("SIR bound to FC queue.", param_list.get<int>("split main"));
-		my_console.WriteToSplitConsole("Starting queue...", param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("SIR bound to FC queue.", param_list.get<int>(eParamSplitMain));
+		my_console.WriteToSplitConsole("Starting queue...", param_list.get<int>(eParamSplitMain));
 		std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_WAIT));
 	}
 
@@ -609,11 +694,17 @@ int main(int argc, char **argv)
 	appl_info.os_thread = appl_info.os_queue->start_queue();
 	appl_info.os_SIR = appl_info.os_queue->start_SIR();
 
-	if (param_list.get<bool>("debug main") == true)
+	#ifndef _WIN32
+		//Button presses are sent to the queue by the event thread of the button
+		if (gpio_info.gpio_button->is_edge_triggered() == true)
+			gpio_info.gpio_button->start_events(button_handler);
+	#endif
+
+	if (param_list.get<bool>(eParamDebugMain) == true)
 	{
-		my_console.WriteToSplitConsole("Operating system queue running.", param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("Operating system queue running.", param_list.get<int>(eParamSplitMain));
 		#ifndef _WIN32
-			my_console.WriteToSplitConsole("Starting TCP listener...", param_list.get<int>("split main"));
+			my_console.WriteToSplitConsole("Starting TCP listener...", param_list.get<int>(eParamSplitMain));
 		#endif	
 		std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_WAIT));
 	}
@@ -622,13 +713,13 @@ int main(int argc, char **argv)
 		//Create thread for TCP socket
 		appl_info.socket_thread = appl_info.os_socket->start_listening();
 
-		if (param_list.get<bool>("debug main") == true)
+		if (param_list.get<bool>(eParamDebugMain) == true)
 		{
-			my_console.WriteToSplitConsole("Socket listener running.", param_list.get<int>("split main"));
+			my_console.WriteToSplitConsole("Socket listener running.", param_list.get<int>(eParamSplitMain));
 			std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_WAIT));
 		}
 	#else
-		if (param_list.get<bool>("debug main") == true)
+		if (param_list.get<bool>(eParamDebugMain) == true)
 		{
 			std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_WAIT));
 		}
@@ -649,7 +740,7 @@ int main(int argc, char **argv)
 	#endif
 	{
 		//Start prompt thread
-		my_console.WriteToSplitConsole("Entering prompt mode...", param_list.get<int>("split main"));
+		my_console.WriteToSplitConsole("Entering prompt mode...", param_list.get<int>(eParamSplitMain));
 		std::thread prompt_thread(control_statemachine);
 		prompt_thread.join();	
 	}
@@ -658,6 +749,8 @@ int main(int argc, char **argv)
 	//GPIO not used on WIN32
 	#ifndef _WIN32
 		gpio_info.gpio_writer->reset_display(0);
+		//Button must not send events anymore
+		gpio_info.gpio_button->stop_events();
 	#endif
 	
 	//We have to release resources - malloc -> free, new -> delete
@@ -684,8 +777,11 @@ int main(int argc, char **argv)
 		delete (*iter);
 	event_info.clear();
 		
-	if (param_list.get<bool>("debug main") == true)
-		my_console.WriteToSplitConsole("Main end.", param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugMain) == true)
+		my_console.WriteToSplitConsole("Main end.", param_list.get<int>(eParamSplitMain));
+
+	//Render remaining console output
+	my_console.stop_logger();
 
     return 0;
 }
@@ -15,6 +15,7 @@
 #include "bpm_audio.hpp"
 #include "bpm_analyze.hpp"
 #include "bpm_param.hpp"
+#include "BPMTiming.hpp"
 #include <sstream>
 #include <iomanip>
 #include <string>
@@ -29,6 +30,9 @@ SplitConsole my_console(NUMBER_OF_SPLITS);
 //Generate parameter list for application
 //Has to be defined 'external' in files that use parameter list
 ParamList param_list;
+//Stage timers of the bpm analysis
+//Has to be defined 'external' in files that use the timers
+BPMTiming bpm_timing;
 
 //Struct for application information
 struct FCApplInfo
@@ -110,7 +114,7 @@ std::string get_user_input()
 	std::string user_value = "";
 
 	//Get split param
-	int split = param_list.get<int>("split input");
+	int split = param_list.get<int>(eParamSplitInput);
 	
 	//Display command prompt
 	user_value = my_console.ReadFromSplitConsole("OZON BPM prompt -> ", split);
@@ -176,7 +180,7 @@ void manual_mode()
 	std::string user_value = "";
 
 	//Get split param
-	int split = param_list.get<int>("split fc");
+	int split = param_list.get<int>(eParamSplitFC);
 
 	//Check user input
 	while (cont == true)
@@ -15,19 +15,22 @@
 #include "bpm_globals.hpp"
 #include "bpm_param.hpp"
 #include "SplitConsole.hpp"
+#include "BPMTiming.hpp"
 #include "PEAKS.hpp"
-#include "WAVFile.h"
+#include "OnsetDetector.hpp"
 
 //Extern split console instance
 extern SplitConsole my_console;
 //Extern parameter list
 extern ParamList param_list;
+//Extern stage timers
+extern BPMTiming bpm_timing;
 
 BPMAnalyze::BPMAnalyze()
 {
 	//Constructor for analyzer class instance
-	if (param_list.get<bool>("debug analyze") == true)
-		my_console.WriteToSplitConsole("BPM Analyzer Class: Instantiating audio analyzer class.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugAnalyze) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Analyzer Class: Instantiating audio analyzer class.");
 
 	//Store sample rate information
 	this->sample_rate = PCM_SAMPLE_RATE;
@@ -69,11 +72,26 @@ BPMAnalyze::BPMAnalyze()
 	this->biquad_buffer_env.init_buffer(sample_rate_DS * duration, sample_rate_DS);
 	this->biquad_buffer_autocorr_L.init_buffer(AUTOCORR_RES, sample_rate_DS);
 	this->biquad_buffer_autocorr_H.init_buffer(AUTOCORR_RES, sample_rate_DS);
+	this->peak_scratch = new PEAKS::scratch();
+
+	//Initialize onset detector
+	this->onset = new OnsetDetector(sample_rate);
+	this->onset_autocorr.init_buffer(AUTOCORR_RES, sample_rate / ONSET_HOP_SIZE);
+	this->onset_curve.init_buffer(ONSET_HISTORY, sample_rate / ONSET_HOP_SIZE);
+
+	//Initialize streaming autocorrelation - range is updated with every calculation
+	this->onset_acc = new AutocorrAccumulator(this->onset->get_rate(), param_list.get<double>(eParamBPMMin));
+
+	//Initialize comb filter tracker - range is updated with every calculation
+	this->comb = new CombTracker(this->onset->get_rate(), param_list.get<double>(eParamBPMMin), param_list.get<double>(eParamBPMMax));
 
 	//Initialize timestamps
 	this->start = std::chrono::high_resolution_clock::now();
 	this->stop = std::chrono::high_resolution_clock::now();
 
+	//Start background writer for debug files
+	this->debug_writer.start_writer();
+
 	//Set state - constructor executed, instance created
 	this->state = eReadyForData;
 }
@@ -81,14 +99,24 @@ BPMAnalyze::BPMAnalyze()
 BPMAnalyze::~BPMAnalyze()
 {
 	//Constructor for audio analyer instance
-	if (param_list.get<bool>("debug analyze") == true)
-		my_console.WriteToSplitConsole("BPM Analyzer Class: Releasing audio analyzer resources.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugAnalyze) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Analyzer Class: Releasing audio analyzer resources.");
 
 	//Buffers free their memory upon destructor's call
+
+	//Pending debug files are written before the writer ends
+	this->debug_writer.stop_writer();
 	
 	//Delete biquads
 	delete this->passband_L;
 	delete this->passband_H;
+	delete this->peak_scratch;
+	delete this->chain_L;
+	delete this->chain_H;
+	//Delete onset detector and tracker
+	delete this->onset;
+	delete this->onset_acc;
+	delete this->comb;
 }
 
 eError BPMAnalyze::reset_state()
@@ -118,8 +146,8 @@ eError BPMAnalyze::prepare_audio_data(short* data)
 	this->state = eDataIsBeingCopied;
 
 	//Write debug message
-	if (param_list.get<bool>("debug analyze") == true)
-		my_console.WriteToSplitConsole("BPM Analyzer Class: Preparing audio data.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugAnalyze) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Analyzer Class: Preparing audio data.");
 	
 	//Read PCM samples
 	long size = this->duration * this->sample_rate;
@@ -138,10 +166,15 @@ eError BPMAnalyze::prepare_audio_data(short* data)
 double BPMAnalyze::get_bpm_value()
 {
 	//Check parameter value and call according method
-	if (param_list.get<int>("algorithm") == 0)
+	int algorithm = param_list.get<int>(eParamAlgorithm);
+	if (algorithm == 0)
 		return this->get_bpm_value_0();
-	if (param_list.get<int>("algorithm") == 1)
+	if (algorithm == 1)
 		return this->get_bpm_value_1();
+	if (algorithm == 2)
+		return this->get_bpm_value_2();
+	if (algorithm == 3)
+		return this->get_bpm_value_3();
 	
 	//If algo not found, nevertheless return value
 	return 0.0;
@@ -162,20 +195,33 @@ double BPMAnalyze::get_bpm_value_0()
 	//Declare return value
 	double bpm_value = 0.0;
 
-	//Get params
-	double bpm_max = param_list.get<double>("bpm max");
-	double bpm_min = param_list.get<double>("bpm min");
-	double env_filt_rec = param_list.get<double>("env filt rec");
-	double lo_freq = param_list.get<double>("lo freq");
-	double hi_freq = param_list.get<double>("hi freq");
+	//Get params - consistent snapshot, a parameter change from socket
+	//or console can't mix old and new values within one calculation
+	double bpm_max, bpm_min, env_filt_rec, lo_freq, hi_freq;
+	bool search, tracking;
+	param_list.snapshot([&]()
+	{
+		bpm_max = param_list.get<double>(eParamBPMMax);
+		bpm_min = param_list.get<double>(eParamBPMMin);
+		env_filt_rec = param_list.get<double>(eParamEnvFiltRec);
+		lo_freq = param_list.get<double>(eParamLoFreq);
+		hi_freq = param_list.get<double>(eParamHiFreq);
+		search = param_list.get<bool>(eParamAutocorrSearch);
+		tracking = param_list.get<bool>(eParamTempoTracking);
+	});
+	bool tracked = begin_tracking(tracking, bpm_min, bpm_max);
 
 	//Save timestamp
 	this->start = std::chrono::high_resolution_clock::now();
+	BPMTiming::time_point t_start = bpm_timing.begin();
+	BPMTiming::time_point t = t_start;
 
 	//Downsample and Perform FFT
 	DSP::create_fft_buffer(this->bf, this->time_domain);
 	DSP::downsample_buffer(this->time_domain, this->time_downsample, DOWNSAMPLE_FACTOR);
+	bpm_timing.lap(eStageDownsample, t);
 	DSP::perform_fft(this->time_downsample, this->freq_domain, +1);
+	bpm_timing.lap(eStageFFT, t);
 
 	//Cut non relevant frequencies
 	DSP::cut_freq(this->freq_domain, this->freq_filt, lo_freq, hi_freq);
@@ -183,18 +229,33 @@ double BPMAnalyze::get_bpm_value_0()
 	DSP::perform_fft(this->freq_filt, this->time_filt, -1);
 	//Scaling of the time values
 	DSP::gain(this->time_filt, 1.0 / (double)this->sample_rate);
+	bpm_timing.lap(eStageFilter, t);
 
-	//Perform autocorrelation
-	DSP::build_autocorr_array(this->time_filt, this->autocorr_array, bpm_min, bpm_max);
+	//Perform autocorrelation - lag window, full lag grid or coarse to fine search
+	if (tracked == true)
+		DSP::build_autocorr_array_window(this->time_filt, this->autocorr_array, bpm_min, bpm_max, this->track_window);
+	else if (search == true)
+		DSP::build_autocorr_array_search(this->time_filt, this->autocorr_array, bpm_min, bpm_max, AUTOCORR_COARSE_STEP, AUTOCORR_CANDIDATES);
+	else
+		DSP::build_autocorr_array(this->time_filt, this->autocorr_array, bpm_min, bpm_max);
+	bpm_timing.lap(eStageAutocorr, t);
 
 	//Add envelope filtering
 	DSP::envelope_filter(this->autocorr_array, this->env_filt, env_filt_rec);
+	bpm_timing.lap(eStageEnvelope, t);
 
-	//Extract bpm value
-	bpm_value = DSP::extract_bpm_value(this->env_filt, bpm_min, bpm_max);
+	//Extract bpm value - the search interpolates the peak between the lags
+	if (search == true)
+		bpm_value = DSP::extract_bpm_value_interp(this->env_filt, bpm_min, bpm_max);
+	else
+		bpm_value = DSP::extract_bpm_value(this->env_filt, bpm_min, bpm_max);
+	end_tracking(tracked, bpm_value);
+	bpm_timing.lap(eStagePeaks, t);
 	
 	//Stop timestamp
 	this->stop = std::chrono::high_resolution_clock::now();
+	this->duration_us = std::chrono::duration_cast<std::chrono::microseconds>(this->stop - this->start).count();
+	bpm_timing.lap(eStageTotal, t_start);
 
 	//Set state and return the calculated BPM value
 	this->state = eReadyForData;
@@ -203,8 +264,8 @@ double BPMAnalyze::get_bpm_value_0()
 	this->mtx.unlock();
 
 	//Write debug message
-	if (param_list.get<bool>("debug analyze") == true)
-		my_console.WriteToSplitConsole("BPM Analyzer Class: Calculated BPM value = " + std::to_string(bpm_value) + "bpm.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugAnalyze) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Analyzer Class: Calculated BPM value = {}bpm.", bpm_value);
 
 	return bpm_value;
 }
@@ -225,51 +286,139 @@ double BPMAnalyze::get_bpm_value_1()
 	double bpm_value = 0.0;
 
 	//Get params and activate debug
-	if (param_list.get<bool>("create peak data") == true)
+	if (param_list.get<bool>(eParamCreatePeakData) == true)
 		PEAKS::activate_debug();
 	else
 		PEAKS::deactivate_debug();
 
-	double bpm_max = param_list.get<double>("bpm max");
-	double bpm_min = param_list.get<double>("bpm min");
-	double env_filt_rec = param_list.get<double>("env filt rec");
-	double width = param_list.get<double>("peak width");
-	double threshold = param_list.get<double>("peak threshold");
-	double adj = param_list.get<double>("peak adjacence");
+	double bpm_max, bpm_min, env_filt_rec, width, threshold, adj;
+	bool search, tracking;
+	int precision;
+	param_list.snapshot([&]()
+	{
+		precision = param_list.get<int>(eParamPrecision);
+		search = param_list.get<bool>(eParamAutocorrSearch);
+		tracking = param_list.get<bool>(eParamTempoTracking);
+		bpm_max = param_list.get<double>(eParamBPMMax);
+		bpm_min = param_list.get<double>(eParamBPMMin);
+		env_filt_rec = param_list.get<double>(eParamEnvFiltRec);
+		width = param_list.get<double>(eParamPeakWidth);
+		threshold = param_list.get<double>(eParamPeakThreshold);
+		adj = param_list.get<double>(eParamPeakAdjacence);
+	});
+	bool tracked = begin_tracking(tracking, bpm_min, bpm_max);
 
 	//Save timestamp
 	this->start = std::chrono::high_resolution_clock::now();
+	BPMTiming::time_point t_start = bpm_timing.begin();
+	BPMTiming::time_point t = t_start;
 
-	//Biquad filter cascade
-	long size = this->duration * this->sample_rate;
-	for (long i = 0; i < size; i++)
+	//Filter registers and chain of the previous precision are stale after a change
+	if (this->chain_precision != precision)
 	{
-		this->biquad_buffer_L[i] = this->passband_L->process(this->bf[i]);
-		this->biquad_buffer_H[i] = this->passband_H->process(this->bf[i]);
+		this->passband_L->reset();
+		this->passband_H->reset();
+		delete this->chain_L;
+		delete this->chain_H;
+		this->chain_L = nullptr;
+		this->chain_H = nullptr;
+		this->chain_precision = precision;
+	}
+
+	if (precision == ePrecisionDouble)
+	{
+		//Biquad filter cascade
+		long size = this->duration * this->sample_rate;
+		for (long i = 0; i < size; i++)
+		{
+			this->biquad_buffer_L[i] = this->passband_L->process((double)this->bf[i]);
+			this->biquad_buffer_H[i] = this->passband_H->process((double)this->bf[i]);
+		}
+		bpm_timing.lap(eStageBiquad, t);
+
+		//After filter process, reset the filters
+		//this->passband_L->reset();
+		//this->passband_H->reset();
+
+		//Downsample
+		DSP::downsample_buffer(this->biquad_buffer_L, this->biquad_buffer_DS_L, DOWNSAMPLE_FACTOR);
+		DSP::downsample_buffer(this->biquad_buffer_H, this->biquad_buffer_DS_H, DOWNSAMPLE_FACTOR);
+		bpm_timing.lap(eStageDownsample, t);
+
+		//Stage times of both passbands are summed up
+		long long t_env = 0;
+		long long t_autocorr = 0;
+
+		//LOW PASSBAND
+		//Envelope
+		DSP::envelope_filter(this->biquad_buffer_DS_L, this->biquad_buffer_env, env_filt_rec);
+		t_env += bpm_timing.elapsed(t);
+		//Autocorrelation - lag window, full lag grid or coarse to fine search
+		if (tracked == true)
+			DSP::build_autocorr_array_window(this->biquad_buffer_env, this->biquad_buffer_autocorr_L, bpm_min, bpm_max, this->track_window);
+		else if (search == true)
+			DSP::build_autocorr_array_search(this->biquad_buffer_env, this->biquad_buffer_autocorr_L, bpm_min, bpm_max, AUTOCORR_COARSE_STEP, AUTOCORR_CANDIDATES);
+		else
+			DSP::build_autocorr_array(this->biquad_buffer_env, this->biquad_buffer_autocorr_L, bpm_min, bpm_max);
+		t_autocorr += bpm_timing.elapsed(t);
+	
+		//HIGH PASSBAND
+		//Envelope
+		DSP::envelope_filter(this->biquad_buffer_DS_H, this->biquad_buffer_env, env_filt_rec);
+		t_env += bpm_timing.elapsed(t);
+		//Autocorrelation
+		if (tracked == true)
+			DSP::build_autocorr_array_window(this->biquad_buffer_env, this->biquad_buffer_autocorr_H, bpm_min, bpm_max, this->track_window);
+		else if (search == true)
+			DSP::build_autocorr_array_search(this->biquad_buffer_env, this->biquad_buffer_autocorr_H, bpm_min, bpm_max, AUTOCORR_COARSE_STEP, AUTOCORR_CANDIDATES);
+		else
+			DSP::build_autocorr_array(this->biquad_buffer_env, this->biquad_buffer_autocorr_H, bpm_min, bpm_max);
+		t_autocorr += bpm_timing.elapsed(t);
+
+		bpm_timing.add(eStageEnvelope, t_env);
+		bpm_timing.add(eStageAutocorr, t_autocorr);
 	}
+	else
+	{
+		//Chains are created with the first calculation of a precision
+		if (this->chain_L == nullptr)
+		{
+			this->chain_L = create_precision_chain((ePrecision)precision, this->sample_rate_DS * this->duration, this->sample_rate_DS, DOWNSAMPLE_FACTOR);
+			this->chain_H = create_precision_chain((ePrecision)precision, this->sample_rate_DS * this->duration, this->sample_rate_DS, DOWNSAMPLE_FACTOR);
+		}
 
-	//After filter process, reset the filters
-	//this->passband_L->reset();
-	//this->passband_H->reset();
+		//Biquad filter cascade with downsampling
+		this->chain_L->filter(this->bf, *this->passband_L);
+		this->chain_H->filter(this->bf, *this->passband_H);
+		bpm_timing.lap(eStageBiquad, t);
 
-	//Downsample
-	DSP::downsample_buffer(this->biquad_buffer_L, this->biquad_buffer_DS_L, DOWNSAMPLE_FACTOR);
-	DSP::downsample_buffer(this->biquad_buffer_H, this->biquad_buffer_DS_H, DOWNSAMPLE_FACTOR);
+		//Envelope
+		this->chain_L->envelope(env_filt_rec);
+		this->chain_H->envelope(env_filt_rec);
+		bpm_timing.lap(eStageEnvelope, t);
 
-	//LOW PASSBAND
-	//Envelope
-	DSP::envelope_filter(this->biquad_buffer_DS_L, this->biquad_buffer_env, env_filt_rec);
-	//Autocorrelation
-	DSP::build_autocorr_array(this->biquad_buffer_env, this->biquad_buffer_autocorr_L, bpm_min, bpm_max);
-	
-	//HIGH PASSBAND
-	//Envelope
-	DSP::envelope_filter(this->biquad_buffer_DS_H, this->biquad_buffer_env, env_filt_rec);
-	//Autocorrelation
-	DSP::build_autocorr_array(this->biquad_buffer_env, this->biquad_buffer_autocorr_H, bpm_min, bpm_max);
+		//Autocorrelation - lag window, full lag grid or coarse to fine search
+		if (tracked == true)
+		{
+			this->chain_L->autocorr(this->biquad_buffer_autocorr_L, bpm_min, bpm_max, &this->track_window);
+			this->chain_H->autocorr(this->biquad_buffer_autocorr_H, bpm_min, bpm_max, &this->track_window);
+		}
+		else if (search == true)
+		{
+			this->chain_L->autocorr_search(this->biquad_buffer_autocorr_L, bpm_min, bpm_max, AUTOCORR_COARSE_STEP, AUTOCORR_CANDIDATES);
+			this->chain_H->autocorr_search(this->biquad_buffer_autocorr_H, bpm_min, bpm_max, AUTOCORR_COARSE_STEP, AUTOCORR_CANDIDATES);
+		}
+		else
+		{
+			this->chain_L->autocorr(this->biquad_buffer_autocorr_L, bpm_min, bpm_max);
+			this->chain_H->autocorr(this->biquad_buffer_autocorr_H, bpm_min, bpm_max);
+		}
+		bpm_timing.lap(eStageAutocorr, t);
+	}
 
 	//Debug output of autocorr arrays and wavfiles
 	write_debug_files();
+	bpm_timing.lap(eStageDebugFiles, t);
 	
 	//BPM extraction
 	//Build vector with buffers
@@ -283,10 +432,18 @@ double BPMAnalyze::get_bpm_value_1()
 	PEAKS::params bpm_params(bpm_min, bpm_max, widths, thres, DSP::weight, (unsigned int)adj);
 
 	//Extract bpm value
-	bpm_value = PEAKS::extract_bpm_value(buffers, bpm_params);
+	bpm_value = PEAKS::extract_bpm_value(buffers, bpm_params, *this->peak_scratch);
+	end_tracking(tracked, bpm_value);
+	bpm_timing.lap(eStagePeaks, t);
+
+	//Hand over peak debug output
+	if (PEAKS::debug_active == true)
+		this->debug_writer.append_text(FN_PEAK_DATA, PEAKS::take_debug());
 	
 	//Stop timestamp
 	this->stop = std::chrono::high_resolution_clock::now();
+	this->duration_us = std::chrono::duration_cast<std::chrono::microseconds>(this->stop - this->start).count();
+	bpm_timing.lap(eStageTotal, t_start);
 
 	//Set state and return the calculated BPM value
 	this->state = eReadyForData;
@@ -295,12 +452,200 @@ double BPMAnalyze::get_bpm_value_1()
 	this->mtx.unlock();
 
 	//Write debug message
-	if (param_list.get<bool>("debug analyze") == true)
-		my_console.WriteToSplitConsole("BPM Analyzer Class: Calculated BPM value = " + std::to_string(bpm_value) + "bpm.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugAnalyze) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Analyzer Class: Calculated BPM value = {}bpm.", bpm_value);
 
 	return bpm_value;
 }
 
+double BPMAnalyze::get_bpm_value_2()
+{
+	//Check state - only possible if state is eDataCopyFinished
+	if (this->state != eDataCopyFinished)
+		return 0.0;
+
+	//Lock mutex - section after here writes state member
+	this->mtx.lock();
+
+	//We may start the calculation
+	this->state = eCalculationInProgress;
+
+	//Declare return value
+	double bpm_value = 0.0;
+
+	//Get params
+	double bpm_max, bpm_min;
+	bool tracking, stream;
+	param_list.snapshot([&]()
+	{
+		bpm_max = param_list.get<double>(eParamBPMMax);
+		bpm_min = param_list.get<double>(eParamBPMMin);
+		tracking = param_list.get<bool>(eParamTempoTracking);
+		stream = param_list.get<bool>(eParamAutocorrStream);
+	});
+	bool tracked = begin_tracking(tracking, bpm_min, bpm_max);
+
+	//Save timestamp
+	this->start = std::chrono::high_resolution_clock::now();
+	BPMTiming::time_point t_start = bpm_timing.begin();
+	BPMTiming::time_point t = t_start;
+
+	//Novelty curve - buffers are not contiguous, so every buffer is a new signal
+	this->onset->reset();
+	this->onset->process(this->bf);
+	bpm_timing.lap(eStageOnset, t);
+
+	//Autocorrelation on novelty curve - only inside the lag window if tracked
+	const std::vector<bool>* window = (tracked == true) ? &this->track_window : nullptr;
+	if (stream == true)
+	{
+		//Running lag sums - the capture is a new segment, products over the gap are not added
+		long size = this->onset->get_novelty(this->onset_curve);
+		this->onset_acc->configure(bpm_min);
+		this->onset_acc->restart();
+		this->onset_acc->process(this->onset_curve.data(), size);
+		this->onset_acc->build_autocorr_array(this->onset_autocorr, bpm_min, bpm_max, window);
+	}
+	else
+		this->onset->build_autocorr_array(this->onset_autocorr, bpm_min, bpm_max, window);
+	bpm_timing.lap(eStageAutocorr, t);
+
+	//Debug output of autocorr array
+	if (param_list.get<bool>(eParamCreateAutocorrFiles) == true)
+	{
+		static int counter = 0;
+		this->debug_writer.write_series("ac_data_onset" + std::to_string(counter++) + ".bin", this->onset_autocorr);
+	}
+	bpm_timing.lap(eStageDebugFiles, t);
+
+	//Extract bpm value
+	bpm_value = DSP::extract_bpm_value(this->onset_autocorr, bpm_min, bpm_max);
+	end_tracking(tracked, bpm_value);
+	bpm_timing.lap(eStagePeaks, t);
+
+	//Stop timestamp
+	this->stop = std::chrono::high_resolution_clock::now();
+	this->duration_us = std::chrono::duration_cast<std::chrono::microseconds>(this->stop - this->start).count();
+	bpm_timing.lap(eStageTotal, t_start);
+
+	//Set state and return the calculated BPM value
+	this->state = eReadyForData;
+
+	//Unlock mutex
+	this->mtx.unlock();
+
+	//Write debug message
+	if (param_list.get<bool>(eParamDebugAnalyze) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Analyzer Class: Calculated BPM value = {}bpm.", bpm_value);
+
+	return bpm_value;
+}
+
+double BPMAnalyze::get_bpm_value_3()
+{
+	//Check state - only possible if state is eDataCopyFinished
+	if (this->state != eDataCopyFinished)
+		return 0.0;
+
+	//Lock mutex - section after here writes state member
+	this->mtx.lock();
+
+	//We may start the calculation
+	this->state = eCalculationInProgress;
+
+	//Declare return value
+	double bpm_value = 0.0;
+
+	//Get params
+	double bpm_max, bpm_min;
+	param_list.snapshot([&]()
+	{
+		bpm_max = param_list.get<double>(eParamBPMMax);
+		bpm_min = param_list.get<double>(eParamBPMMin);
+	});
+
+	//Save timestamp
+	this->start = std::chrono::high_resolution_clock::now();
+	BPMTiming::time_point t_start = bpm_timing.begin();
+	BPMTiming::time_point t = t_start;
+
+	//Novelty curve of this buffer
+	this->onset->reset();
+	this->onset->process(this->bf);
+	long size = this->onset->get_novelty(this->onset_curve);
+	bpm_timing.lap(eStageOnset, t);
+
+	//The gap between two buffers has an unknown length, so the resonator outputs
+	//don't continue in phase - they are cleared, only the tempo energies are kept
+	this->comb->configure(bpm_min, bpm_max);
+	this->comb->restart();
+	this->comb->process(this->onset_curve.data(), size);
+	bpm_timing.lap(eStageComb, t);
+
+	//Tempo and phase of strongest resonator
+	bpm_value = this->comb->get_bpm();
+	this->beat_phase = this->comb->get_phase();
+	bpm_timing.lap(eStagePeaks, t);
+
+	//Stop timestamp
+	this->stop = std::chrono::high_resolution_clock::now();
+	this->duration_us = std::chrono::duration_cast<std::chrono::microseconds>(this->stop - this->start).count();
+	bpm_timing.lap(eStageTotal, t_start);
+
+	//Set state and return the calculated BPM value
+	this->state = eReadyForData;
+
+	//Unlock mutex
+	this->mtx.unlock();
+
+	//Write debug message
+	if (param_list.get<bool>(eParamDebugAnalyze) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Analyzer Class: Calculated BPM value = {}bpm, phase = {}, confidence = {}.", bpm_value, (double)this->beat_phase, this->comb->get_confidence());
+
+	return bpm_value;
+}
+
+bool BPMAnalyze::begin_tracking(bool enabled, double bpm_min, double bpm_max)
+{
+	//Full range scan - tracking off, no confident tempo or periodic rescan
+	double bpm = this->lock_bpm;
+	if ((enabled == false) || (bpm <= 0.0) || (this->lock_confidence < TRACK_MIN_CONFIDENCE) || (this->track_cycles >= TRACK_RESCAN_CYCLES))
+	{
+		this->track_cycles = 0;
+		return false;
+	}
+
+	//Window around the tempo and its half/double - the autocorrelation has peaks there too
+	this->track_tempos.assign({ bpm, bpm / 2.0, bpm * 2.0 });
+	if (DSP::autocorr_window(AUTOCORR_RES, bpm_min, bpm_max, this->track_tempos, TRACK_WINDOW, this->track_window) == 0)
+	{
+		//Tempo is outside of the range (changed parameters)
+		this->track_cycles = 0;
+		return false;
+	}
+
+	this->track_cycles++;
+	return true;
+}
+
+void BPMAnalyze::end_tracking(bool tracked, double bpm_value)
+{
+	if (tracked == false)
+		return;
+
+	//Value well inside the window - tempo is still tracked
+	for (size_t i = 0; i < this->track_tempos.size(); i++)
+	{
+		if (fabs(bpm_value - this->track_tempos[i]) < 0.75 * TRACK_WINDOW)
+			return;
+	}
+
+	//Tempo has moved - next calculation scans the full range
+	this->track_cycles = TRACK_RESCAN_CYCLES;
+	if (param_list.get<bool>(eParamDebugAnalyze) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Analyzer Class: Tempo {}bpm left tracking window, full range scan.", bpm_value);
+}
+
 eError BPMAnalyze::check_rms_value()
 {
 	//Declare return value
@@ -313,13 +658,14 @@ eError BPMAnalyze::check_rms_value()
 	//Calculate the rms value of the recorded data
 	//If below threshold, no analysis is possible
 	double rms = DSP::get_rms_value(this->bf);
+	this->rms = rms;
 
 	//Write debug message
-	if (param_list.get<bool>("debug analyze") == true)
-		my_console.WriteToSplitConsole("BPM Analyzer Class: RMS value = ", rms, param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugAnalyze) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Analyzer Class: RMS value = {}", rms);
 
 	//Check threshold and modify return value if necessary
-	if (rms > param_list.get<double>("rms threshold"))
+	if (rms > param_list.get<double>(eParamRMSThreshold))
 		retval = eSuccess;
 
 	return retval;
@@ -331,8 +677,8 @@ long long BPMAnalyze::get_calc_time()
 	long long us = std::chrono::duration_cast<std::chrono::microseconds>(this->stop - this->start).count();
 	
 	//Write debug message
-	if (param_list.get<bool>("debug analyze") == true)
-		my_console.WriteToSplitConsole("BPM Analyzer Class: Processing time = " + std::to_string(us / 1000.0) + "ms.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugAnalyze) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Analyzer Class: Processing time = {}ms.", us / 1000.0);
 
 	return us;
 }
@@ -344,55 +690,35 @@ void BPMAnalyze::tic()
 	long long us = std::chrono::duration_cast<std::chrono::microseconds>(yet - this->start).count();
 	
 	//Output of lap time
-	my_console.WriteToSplitConsole("BPM Analyzer Class: Lap time = " + std::to_string(us / 1000.0) + "ms.", param_list.get<int>("split audio"));
+	my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Analyzer Class: Lap time = {}ms.", us / 1000.0);
 }
 
 void BPMAnalyze::write_debug_files()
 {
-	if (param_list.get<bool>("create wavfiles") == true)
+	//Only snapshots are taken here - if the writer can't keep up, files are dropped
+	bool complete = true;
+	if (param_list.get<bool>(eParamCreateWavfiles) == true)
 	{
 		//Debug code for wav file generation
-		buffer<short> wavfile_buffer_L;
-		buffer<short> wavfile_buffer_H;
-		wavfile_buffer_L.init_buffer(biquad_buffer_L.get_size(), biquad_buffer_L.get_sample_rate());
-		wavfile_buffer_H.init_buffer(biquad_buffer_H.get_size(), biquad_buffer_H.get_sample_rate());
-		DSP::shortify(biquad_buffer_L, wavfile_buffer_L);
-		DSP::shortify(biquad_buffer_H, wavfile_buffer_H);
-		WAVFile wavfile_L;
-		WAVFile wavfile_H;
-		wavfile_L.set_buffer(wavfile_buffer_L);
-		wavfile_H.set_buffer(wavfile_buffer_H);
+		//Filtered signals are scaled to full range by the writer
+		//Only the double precision path fills the filter buffers
 		static int count = 0;
-		std::string filename_L = "filt_Lwav" + std::to_string(count) + ".wav";
-		std::string filename_H = "filt_Hwav" + std::to_string(count) + ".wav";
-		std::ofstream file_L(filename_L, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
-		std::ofstream file_H(filename_H, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
-		wavfile_L.write_wav_file(file_L);
-		wavfile_H.write_wav_file(file_H);
-		file_L.close();
-		file_H.close();
-	
-		WAVFile wavfile;
-		wavfile.set_buffer(this->bf);
-		std::string filename = "raw_wav" + std::to_string(count++) + ".wav";
-		std::ofstream file(filename, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
-		wavfile.write_wav_file(file);
-		file.close();
+		if (this->chain_precision == ePrecisionDouble)
+		{
+			complete &= this->debug_writer.write_wav("filt_Lwav" + std::to_string(count) + ".wav", this->biquad_buffer_L);
+			complete &= this->debug_writer.write_wav("filt_Hwav" + std::to_string(count) + ".wav", this->biquad_buffer_H);
+		}
+		complete &= this->debug_writer.write_wav("raw_wav" + std::to_string(count++) + ".wav", this->bf);
 	}
 
-	if (param_list.get<bool>("create autocorr files") == true)
+	if (param_list.get<bool>(eParamCreateAutocorrFiles) == true)
 	{
+		//Autocorrelation arrays are written as raw doubles
 		static int counter = 0;
-		std::string filename_autocorr_L = "ac_data_L" + std::to_string(counter) + ".txt";
-		std::string filename_autocorr_H = "ac_data_H" + std::to_string(counter++) + ".txt";
-		std::ofstream file_autocorr_L(filename_autocorr_L, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
-		std::ofstream file_autocorr_H(filename_autocorr_H, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
-		for (long i = 0; i < biquad_buffer_autocorr_L.get_size(); i++)
-		{
-			file_autocorr_L << i << "; " << biquad_buffer_autocorr_L[i] << "\n";
-			file_autocorr_H << i << "; " << biquad_buffer_autocorr_H[i] << "\n";
-		}
-		file_autocorr_L.close();
-		file_autocorr_H.close();
+		complete &= this->debug_writer.write_series("ac_data_L" + std::to_string(counter) + ".bin", this->biquad_buffer_autocorr_L);
+		complete &= this->debug_writer.write_series("ac_data_H" + std::to_string(counter++) + ".bin", this->biquad_buffer_autocorr_H);
 	}
+
+	if ((complete == false) && (param_list.get<bool>(eParamDebugAnalyze) == true))
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Analyzer Class: Debug writer busy, files dropped = {}", this->debug_writer.get_dropped());
 }
\ No newline at end of file
@@ -2,11 +2,21 @@
 #define _BPM_ANALYZE
 
 #include <iostream>
+#include <vector>
 #include <chrono>
 #include <mutex>
+#include <atomic>
 #include "bpm_globals.hpp"
 #include "buffer.hpp"
 #include "BiquadCascade.hpp"
+#include "DebugWriter.hpp"
+#include "CombTracker.hpp"
+#include "AutocorrAccumulator.hpp"
+#include "Precision.hpp"
+
+//Onset detector and PEAKS use DSP.hpp - only included in bpm_analyze.cpp
+class OnsetDetector;
+namespace PEAKS { struct scratch; }
 
 //Enum for analyzer state
 enum eAnalyzerState
@@ -33,6 +43,12 @@ enum eAnalyzerState
 //deleting those frequencies from the signal. In fact it's the same as adding frequency
 //components of multiple of frequency resolution with phase opposition, thus giving some
 //aliasing effects in the lower frequencies -> strange sounds.
+//Tempo tracking (parameter "tempo tracking", algorithms 0 to 2): once the bpm value handler
+//has a confident tempo, step 5 only evaluates a narrow lag window around this tempo and its
+//half/double. A result at the border of the window, a confidence drop or a periodic rescan
+//(TRACK_RESCAN_CYCLES) go back to the full range.
+//With parameter "autocorr search", step 5 evaluates a coarse lag grid first and only the
+//neighbourhood of its strongest maxima exactly, step 7 interpolates the peak between the lags.
 
 //Function get_bpm_value_adv
 //This is a more advanced algo, as it uses biquad filter bands to isolate bass frequency and
@@ -48,6 +64,32 @@ enum eAnalyzerState
 //Note: this algo uses the "PEAK.hpp" functions. For every passband, a number of most explicit
 //peaks are determined and the peaks are compared with each other to find the most "confident" peak.
 //See "PEAKS.hpp" for further info.
+//Parameter "precision" selects the sample types of steps 2 to 5 (see "Precision.hpp"): 0 is the
+//double precision reference, 1 single precision, 2 and 3 single precision filters with Q15/Q31
+//envelope and autocorrelation. Debug wav files of the filter output are only written with 0.
+
+//Function get_bpm_value_2
+//Spectral flux onset detection - the autocorrelation is done on a novelty curve with ~172 Hz
+//instead of the envelope with 11 kHz, so it is much cheaper.
+//1. Get buffer from bpm_audio (short*)
+//2. Short time spectra (hop 256 samples), compressed to log frequency bands
+//3. Novelty curve - sum of band increases between two spectra
+//4. Autocorrelation of novelty curve, lags interpolated
+//5. BPM extraction
+//See "OnsetDetector.hpp" for further info.
+//With parameter "autocorr stream", step 4 adds the novelty values to running lag sums
+//which are kept (and slowly forgotten) from one capture to the next, instead of
+//calculating the autocorrelation of the curve for every lag. See "AutocorrAccumulator.hpp".
+
+//Function get_bpm_value_3
+//Same novelty curve as algorithm 2, but the tempo is tracked by a bank of comb filter
+//resonators (one per candidate bpm), which keeps running from one capture to the next.
+//Besides the tempo, the resonators also give the beat phase.
+//1. Get buffer from bpm_audio (short*)
+//2. Novelty curve (see algorithm 2)
+//3. Feed novelty values to the resonator bank
+//4. Tempo and phase of the strongest resonator
+//See "CombTracker.hpp" for further info.
 
 class BPMAnalyze
 {
@@ -68,10 +110,18 @@ public:
 	double get_bpm_value();
 	double get_bpm_value_0();
 	double get_bpm_value_1();
+	double get_bpm_value_2();
+	double get_bpm_value_3();
 
 	//Method for rms value evaluation
 	//If value is below a threshold, no bpm analysis is possible
 	eError check_rms_value();
+	//Getter method for last rms value
+	double get_rms() { return this->rms; }
+	//Getter method for beat phase at the end of the last buffer (algorithm 3)
+	double get_beat_phase() { return this->beat_phase; }
+	//Setter method for tempo tracking - smoothed bpm value and confidence of the bpm value handler
+	void set_tempo_lock(double bpm, double confidence) { this->lock_bpm = bpm; this->lock_confidence = confidence; }
 
 	//Getter method
 	eAnalyzerState get_state() { return this->state; }
@@ -82,6 +132,8 @@ public:
 	//executed bpm calculation
 	long long get_calc_time();
 	void tic();
+	//Duration of the last bpm calculation in us - without debug output
+	long long get_duration() { return this->duration_us; }
 
 private:
 	//Duration of one buffer
@@ -131,17 +183,50 @@ private:
 	buffer<double> biquad_buffer_autocorr_L;	//After autocorrelation
 	//buffer<double> biquad_buffer_autocorr_M;
 	buffer<double> biquad_buffer_autocorr_H;
+	PEAKS::scratch* peak_scratch;			//Work memory of peak extraction
+
+	//Analysis chains with other precision than double - created when the parameter changes
+	PrecisionChainBase* chain_L = nullptr;
+	PrecisionChainBase* chain_H = nullptr;
+	int chain_precision = ePrecisionDouble;
+
+	//Onset detection - algorithm 2
+	OnsetDetector* onset;
+	buffer<double> onset_autocorr;			//Autocorrelation of novelty curve
+	buffer<double> onset_curve;			//Novelty curve of one buffer
+	AutocorrAccumulator* onset_acc;			//Streaming autocorrelation of novelty curve
+
+	//Comb filter tempo tracker - algorithm 3
+	CombTracker* comb;
+
+	//Tempo tracking - the lock is set from the state machine thread
+	std::atomic<double> lock_bpm { 0.0 };
+	std::atomic<double> lock_confidence { 0.0 };
+	long track_cycles = 0;				//Tracked calculations since last full range scan
+	std::vector<double> track_tempos;		//Tempos of the current lag window
+	std::vector<bool> track_window;			//Autocorr entries inside the lag window
+	//Prepare lag window - returns false if the full range must be scanned
+	bool begin_tracking(bool enabled, double bpm_min, double bpm_max);
+	//Check tracked result - a value at the border of the window forces a full range scan
+	void end_tracking(bool tracked, double bpm_value);
 
 	//Time measurement
 	std::chrono::time_point<std::chrono::high_resolution_clock> start;
 	std::chrono::time_point<std::chrono::high_resolution_clock> stop;
 
+	//Results of last calculation - read from other threads (telemetry)
+	std::atomic<double> rms { 0.0 };
+	std::atomic<long long> duration_us { 0 };
+	std::atomic<double> beat_phase { 0.0 };
+
 	//Mutex for multi-thread handling
 	//The state can be accessed from multiple locations
 	//Therefore we must use this in any function that sets the state
 	std::mutex mtx;
 
 	//Debug functions
+	//Files are written by the debug writer thread, the analyzer only hands over snapshots
+	DebugWriter debug_writer;
 	void write_debug_files();
 };
 
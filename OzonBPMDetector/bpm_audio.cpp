@@ -1,10 +1,12 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <cstring>
 #include "bpm_audio.hpp"
 #include "bpm_globals.hpp"
 #include "bpm_param.hpp"
 #include "SplitConsole.hpp"
+#include "WAVReader.hpp"
 
 //Extern split console instance
 extern SplitConsole my_console;
@@ -14,8 +16,8 @@ extern ParamList param_list;
 BPMAudio::BPMAudio()
 {
 	//Constructor for audio handler instance
-	if (param_list.get<bool>("debug audio") == true)
-		my_console.WriteToSplitConsole("BPM Audio Class: Instantiating audio handler class.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugAudio) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Instantiating audio handler class.");
 
 	//Define return value
 	this->init_state = eSuccess;
@@ -67,23 +69,23 @@ BPMAudio::BPMAudio()
 			s = s + "," + std::to_string(PCM_SUBDEVICE);
 
 			//Open audio device
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Opening audio device " + s, param_list.get<int>("split audio"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.WriteToSplitConsole("BPM Audio Class: Opening audio device " + s, param_list.get<int>(eParamSplitAudio));
 
 			int err;
 			err = snd_pcm_open(&pcm_handle, s.c_str(), PCM_CAPTURE_MODE, 0);
 
 			if (err < 0)
 			{
-				if (param_list.get<bool>("debug audio") == true)
-					my_console.WriteToSplitConsole("BPM Audio Class: Error opening audio device.", param_list.get<int>("split errors"));
+				if (param_list.get<bool>(eParamDebugAudio) == true)
+					my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Error opening audio device.");
 
 				this->init_state = eAudio_ErrorOpeningAudioDevice;
 			}
 			else
 			{
-				if (param_list.get<bool>("debug audio") == true)
-					my_console.WriteToSplitConsole("BPM Audio Class: Success opening audio device.", param_list.get<int>("split audio"));
+				if (param_list.get<bool>(eParamDebugAudio) == true)
+					my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Success opening audio device.");
 			}
 		}
 	}
@@ -100,15 +102,15 @@ BPMAudio::BPMAudio()
 		err = snd_pcm_hw_params_malloc(&hw_params);
 		if (err < 0)
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Error allocating audio hw parameter structure.", param_list.get<int>("split errors"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Error allocating audio hw parameter structure.");
 
 			this->init_state = eAudio_ErrorAllocatingHwStruc;
 		}
 		else
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Success allocating hw parameter structure.", param_list.get<int>("split audio"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Success allocating hw parameter structure.");
 		}
 	}
 
@@ -119,15 +121,15 @@ BPMAudio::BPMAudio()
 		err = snd_pcm_hw_params_any(pcm_handle, hw_params);
 		if (err < 0)
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Error initializing audio hw parameter structure.", param_list.get<int>("split errors"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Error initializing audio hw parameter structure.");
 
 			this->init_state = eAudio_ErrorInitHwStruc;
 		}
 		else
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Success initializing hw parameter structure.", param_list.get<int>("split audio"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Success initializing hw parameter structure.");
 		}
 	}
 
@@ -138,15 +140,15 @@ BPMAudio::BPMAudio()
 		err = snd_pcm_hw_params_set_access(pcm_handle, hw_params, PCM_ACCESS_MODE);
 		if (err < 0)
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Error setting access mode.", param_list.get<int>("split errors"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Error setting access mode.");
 
 			this->init_state = eAudio_ErrorSettingAccessMode;
 		}
 		else
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Success setting access mode.", param_list.get<int>("split audio"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Success setting access mode.");
 		}
 	}
 
@@ -157,15 +159,15 @@ BPMAudio::BPMAudio()
 		err = snd_pcm_hw_params_set_format(pcm_handle, hw_params, PCM_AUDIO_FORMAT);
 		if (err < 0)
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Error setting audio format.", param_list.get<int>("split errors"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Error setting audio format.");
 
 			this->init_state = eAudio_ErrorSettingFormat;
 		}
 		else
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Success setting audio format.", param_list.get<int>("split audio"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Success setting audio format.");
 		}
 	}
 
@@ -177,15 +179,15 @@ BPMAudio::BPMAudio()
 		err = snd_pcm_hw_params_set_rate_near(pcm_handle, hw_params, &rate, 0);
 		if (err < 0)
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Error setting sample rate.", param_list.get<int>("split errors"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Error setting sample rate.");
 
 			this->init_state = eAudio_ErrorSettingSampleRate;
 		}
 		else
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Success setting sample rate.", param_list.get<int>("split audio"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Success setting sample rate.");
 		}
 	}
 
@@ -196,15 +198,15 @@ BPMAudio::BPMAudio()
 		err = snd_pcm_hw_params_set_channels(pcm_handle, hw_params, PCM_CHANNELS);
 		if (err < 0)
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Error setting channels.", param_list.get<int>("split errors"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Error setting channels.");
 
 			this->init_state = eAudio_ErrorSettingChannels;
 		}
 		else
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Success setting channels.", param_list.get<int>("split audio"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Success setting channels.");
 		}
 	}
 
@@ -215,15 +217,15 @@ BPMAudio::BPMAudio()
 		err = snd_pcm_hw_params(pcm_handle, hw_params);
 		if (err < 0)
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Error setting hardware parameters.", param_list.get<int>("split errors"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Error setting hardware parameters.");
 
 			this->init_state = eAudio_ErrorSettingHwParameters;
 		}
 		else
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Success setting hardware parameters.", param_list.get<int>("split audio"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Success setting hardware parameters.");
 
 			//Free memory 
 			snd_pcm_hw_params_free(hw_params);
@@ -237,15 +239,15 @@ BPMAudio::BPMAudio()
 		err = snd_pcm_prepare(pcm_handle);
 		if (err < 0)
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Error activating audio interface.", param_list.get<int>("split errors"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Error activating audio interface.");
 
 			this->init_state = eAudio_ErrorActivateAudioInterf;
 		}
 		else
 		{
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Success activating audio interface.", param_list.get<int>("split audio"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Success activating audio interface.");
 		}
 	}
 
@@ -269,8 +271,8 @@ BPMAudio::BPMAudio()
 BPMAudio::~BPMAudio()
 {
 	//Destructor
-	if (param_list.get<bool>("debug audio") == true)
-		my_console.WriteToSplitConsole("BPM Audio Class: Closing audio device.", param_list.get<int>("split main"));
+	if (param_list.get<bool>(eParamDebugAudio) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitMain), "BPM Audio Class: Closing audio device.");
 
 #ifndef _WIN32
 
@@ -365,8 +367,8 @@ std::vector<std::string> BPMAudio::list_names()
 		else
 		{
 			std::string s = snd_ctl_card_info_get_name(cardInfo);
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Card " + std::to_string(i) + " = " + s, param_list.get<int>("split audio"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.WriteToSplitConsole("BPM Audio Class: Card " + std::to_string(i) + " = " + s, param_list.get<int>(eParamSplitAudio));
 
 			retval.push_back(s);
 		}
@@ -411,14 +413,14 @@ eError BPMAudio::capture_samples()
 	if (err < 0)
 	{
 		retval = eAudio_ErrorCapturingAudio;
-		if (param_list.get<bool>("debug audio") == true)
-			my_console.WriteToSplitConsole("BPM Audio Class: Error during capture of audio data: " + std::to_string(err), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugAudio) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Error during capture of audio data: {}", err);
 		int err_drop = snd_pcm_drop(pcm_handle);
-		if (param_list.get<bool>("debug audio") == true)
-			my_console.WriteToSplitConsole("BPM Audio Class: Dropping samples: " + std::to_string(err_drop), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugAudio) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Dropping samples: {}", err_drop);
 		int err_rec = snd_pcm_recover(pcm_handle, err, 0);
-		if (param_list.get<bool>("debug audio") == true)
-			my_console.WriteToSplitConsole("BPM Audio Class: Recovering: " + std::to_string(err_rec), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugAudio) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Recovering: {}", err_rec);
 
 	}
 	else
@@ -427,8 +429,8 @@ eError BPMAudio::capture_samples()
 		this->buffer_ready = true;
 
 		static int counter = 0;
-		if (param_list.get<bool>("debug audio") == true)
-			my_console.WriteToSplitConsole("BPM Audio Class: Successfully captured audio: " + std::to_string(err) + ", #" + std::to_string(counter++), param_list.get<int>("split audio"));
+		if (param_list.get<bool>(eParamDebugAudio) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Successfully captured audio: {}, #{}", err, counter++);
 	}
 
 	//Unlock the mutex
@@ -449,15 +451,15 @@ eError BPMAudio::stop_recording()
 	//Stop the PCM recording
 	int err = snd_pcm_drop(pcm_handle);
 
-	if (param_list.get<bool>("debug audio") == true)
-		my_console.WriteToSplitConsole("BPM Audio Class: Stopping.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugAudio) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Stopping.");
 
 	//Check if everything went fine
 	if (err < 0)
 	{
 		retval = eAudio_ErrorCapturingAudio;
-		if (param_list.get<bool>("debug audio") == true)
-			my_console.WriteToSplitConsole("BPM Audio Class: Error during stopping: " + std::to_string(err), param_list.get<int>("split errors"));
+		if (param_list.get<bool>(eParamDebugAudio) == true)
+			my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Error during stopping: {}", err);
 	}
 	else
 	{
@@ -467,8 +469,8 @@ eError BPMAudio::stop_recording()
 		if (err_prep < 0)
 		{
 			retval = eAudio_ErrorCapturingAudio;
-			if (param_list.get<bool>("debug audio") == true)
-				my_console.WriteToSplitConsole("BPM Audio Class: Error during prepare: " + std::to_string(err_prep), param_list.get<int>("split errors"));
+			if (param_list.get<bool>(eParamDebugAudio) == true)
+				my_console.LogToSplitConsole(param_list.get<int>(eParamSplitErrors), "BPM Audio Class: Error during prepare: {}", err_prep);
 		}
 
 	}
@@ -636,8 +638,8 @@ eError BPMAudio::read_wav_file(std::ifstream& file, WAVFile& wav_file)
 
 	//Now we read the total file size
 	unsigned int file_size = read_word<unsigned int>(file, true);
-	if (param_list.get<bool>("debug wavfile") == true)
-		my_console.WriteToSplitConsole("Reading wav file. Size = " + std::to_string(file_size) + " bytes.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugWavfile) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "Reading wav file. Size = {} bytes.", file_size);
 
 	//Ignore next 8 bytes - WAVE, fmt_
 	ignore = read_word<int>(file, false);
@@ -645,41 +647,41 @@ eError BPMAudio::read_wav_file(std::ifstream& file, WAVFile& wav_file)
 
 	//Header size
 	unsigned int header_size = read_word<unsigned int>(file, true);
-	if (param_list.get<bool>("debug wavfile") == true)
-		my_console.WriteToSplitConsole("BPM Audio Class: Header size = " + std::to_string(header_size) + " bytes.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugWavfile) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Header size = {} bytes.", header_size);
 
 	//Get audio format and number of channels
 	short audio_format = read_word<short>(file, true);
 	short num_channels = read_word<short>(file, true);
-	if (param_list.get<bool>("debug wavfile") == true)
+	if (param_list.get<bool>(eParamDebugWavfile) == true)
 	{
-		my_console.WriteToSplitConsole("BPM Audio Class: Audio format = " + std::to_string(audio_format), param_list.get<int>("split audio"));
-		my_console.WriteToSplitConsole("BPM Audio Class: Channels = " + std::to_string(num_channels), param_list.get<int>("split audio"));
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Audio format = {}", audio_format);
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Channels = {}", num_channels);
 	}
 
 	//Get sample rate and byte rate
 	unsigned int sample_rate = read_word<unsigned int>(file, true);
 	unsigned int byte_rate = read_word<unsigned int>(file, true);
-	if (param_list.get<bool>("debug wavfile") == true)
+	if (param_list.get<bool>(eParamDebugWavfile) == true)
 	{
-		my_console.WriteToSplitConsole("BPM Audio Class: Sample rate = " + std::to_string(sample_rate) + " Hz.", param_list.get<int>("split audio"));
-		my_console.WriteToSplitConsole("BPM Audio Class: Byte rate = " + std::to_string(byte_rate) + " Hz.", param_list.get<int>("split audio"));
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Sample rate = {} Hz.", sample_rate);
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Byte rate = {} Hz.", byte_rate);
 	}
 
 	//Get frame size and bits per sample
 	short frame_size = read_word<short>(file, true);
 	short bits_sample = read_word<short>(file, true);
-	if (param_list.get<bool>("debug wavfile") == true)
+	if (param_list.get<bool>(eParamDebugWavfile) == true)
 	{
-		my_console.WriteToSplitConsole("BPM Audio Class: Frame size = " + std::to_string(frame_size) + " bytes.", param_list.get<int>("split audio"));
-		my_console.WriteToSplitConsole("BPM Audio Class: Bits per sample = " + std::to_string(bits_sample) + " bits.", param_list.get<int>("split audio"));
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Frame size = {} bytes.", frame_size);
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Bits per sample = {} bits.", bits_sample);
 	}
 
 	//Now at last, get the data chunk size - first 4 bytes "data" ignored
 	ignore = read_word<int>(file, false);
 	unsigned int data_size = read_word<unsigned int>(file, true);
-	if (param_list.get<bool>("debug wavfile") == true)
-		my_console.WriteToSplitConsole("BPM Audio Class: Data bytes = " + std::to_string(data_size) + " bytes.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugWavfile) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Data bytes = {} bytes.", data_size);
 
 	//Create wav file struct
 	wav_file.file_size = file_size;
@@ -696,72 +698,52 @@ eError BPMAudio::read_wav_file(std::ifstream& file, WAVFile& wav_file)
 	//Important! Caller has to handle corresponding 'free' for this memory block!
 	wav_file.buffer = (short*)malloc(data_size);
 
-	if (param_list.get<bool>("debug wavfile") == true)
-		my_console.WriteToSplitConsole("BPM Audio Class: Reading " + std::to_string(data_size / frame_size) + " frames.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugWavfile) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Reading {} frames.", data_size / frame_size);
 
 	//Transfer data to struct
 	for (long i = 0; i < (data_size / frame_size); ++i)
 		wav_file.buffer[i] = read_word<short>(file, true);
 
-	if (param_list.get<bool>("debug wavfile") == true)
-		my_console.WriteToSplitConsole("BPM Audio Class: Success.", param_list.get<int>("split audio"));
+	if (param_list.get<bool>(eParamDebugWavfile) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Success.");
 
 	return eSuccess;
 }
 
-eError BPMAudio::read_wav_file(std::ifstream& file)
+eError BPMAudio::read_wav_file(const std::string& filename)
 {
-	//Declare return value
-	eError retval = eSuccess;
-
-	//Check if the audio interface has been properly set up
-	if (file.is_open() == false)
-		return eAudio_ErrorInputStreamNotOpen;
+#ifndef _WIN32
+	//The file is mapped, the samples are copied once into the buffer
+	WAVReader reader;
+	eError retval = reader.open(filename);
+	if (retval != eSuccess)
+		return retval;
 
-	//Prepare struct
-	WAVFile temp_wav_file;
+	//Only the first channel would make sense for the analyzer
+	if (reader.get_format().num_channels != PCM_CHANNELS)
+		return eAudio_InvalidWavFile;
 
-	//Call member function to read wav file
-	read_wav_file(file, temp_wav_file);
+	//The buffer holds PCM_BUF_SIZE samples - longer files are cut
+	buffer_view<short> view = reader.get_view(0, PCM_BUF_SIZE);
+	if (view.is_initialized() == false)
+		return eAudio_InvalidWavFile;
 
-	//Now we just copy the received samples into the buffer
-	for (long i = 0; i < (temp_wav_file.data_size / temp_wav_file.frame_size); ++i)
-		this->buffer[i] = temp_wav_file.buffer[i];
+	if (param_list.get<bool>(eParamDebugWavfile) == true)
+		my_console.LogToSplitConsole(param_list.get<int>(eParamSplitAudio), "BPM Audio Class: Copying {} samples.", view.get_size());
 
-	//We have to free the memory allocated with malloc in the other read_wav_file function
-	free(temp_wav_file.buffer);
+	this->mtx.lock();
+	memcpy(this->buffer, view.data(), view.get_size() * sizeof(short));
+	this->mtx.unlock();
 
 	return eSuccess;
+#else
+	return eAudio_ErrorInputStreamNotOpen;
+#endif
 }
 
 eError BPMAudio::read_std_wav_file()
 {
-	//Declare return value
-	eError retval = eSuccess;
-
 	//Here, we set the wav file ourselves
-	std::ifstream file(STANDARD_WAVFILE, std::ios_base::out);
-
-	//Check if the audio interface has been properly set up
-	if (file.is_open() == false)
-		return eAudio_ErrorInputStreamNotOpen;
-
-	//Prepare struct
-	WAVFile temp_wav_file;
-
-	//Call member function to read wav file
-	read_wav_file(file, temp_wav_file);
-
-	//Now we just copy the received samples into the buffer
-	for (long i = 0; i < (temp_wav_file.data_size / temp_wav_file.frame_size); ++i)
-		this->buffer[i] = temp_wav_file.buffer[i];
-
-	//We have to free the memory allocated with malloc in the other read_wav_file function
-	free(temp_wav_file.buffer);
-
-	//Close the file handle
-	file.close();
-
-	return eSuccess;
-
+	return read_wav_file(STANDARD_WAVFILE);
 }
\ No newline at end of file
@@ -67,8 +67,9 @@ public:
 	eError read_wav_file(std::ifstream& file, WAVFile& wav_file);
 
 	//Capture wav file in class member buffer - overloaded method
-	//If no struct is provided, data is copied to this->buffer
-	eError read_wav_file(std::ifstream& file);
+	//The file is memory mapped and copied once to this->buffer
+	//Files longer than the buffer are cut
+	eError read_wav_file(const std::string& filename);
 
 	//Read standard wav file
 	eError read_std_wav_file();
@@ -1,3 +1,4 @@
 #!/bin/bash
 #sudo g++ *.cpp -o bpm -lwiringPi -std=c++11 -lpthread -lasound -lrt -lxdo -O3
-sudo g++ *.cpp -o bpm -lwiringPi -std=c++11 -lpthread -lasound -lrt -lxdo -O3 -lGL -lGLU -lglut
+#64 bit file offsets - WAV files (RF64) above 2 GB on the 32 bit Pi
+sudo g++ *.cpp -o bpm -D_FILE_OFFSET_BITS=64 -lwiringPi -std=c++11 -lpthread -lasound -lrt -lxdo -O3 -lGL -lGLU -lglut
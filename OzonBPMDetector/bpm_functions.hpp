@@ -78,8 +78,8 @@ void init_done()
 
 void StateInit_entry()
 {
-	if (param_list.get<bool>("debug functions") == true)
-		my_console.WriteToSplitConsole("Init state.", param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugFunctions) == true)
+		my_console.WriteToSplitConsole("Init state.", param_list.get<int>(eParamSplitFC));
 
 	//Start timer - if it elapses, we continue to next state (BPM)
 	START_TIMER(eInitDone);
@@ -122,31 +122,26 @@ bool rms_timer_started = false;
 void supervision_queue()
 {
 	//Display message
-	my_console.WriteToSplitConsole("Timeout supervision of OS queue!", param_list.get<int>("split errors"));
+	my_console.WriteToSplitConsole("Timeout supervision of OS queue!", param_list.get<int>(eParamSplitErrors));
 }
 
 void supervision_capture()
 {
 	capture_timeout = true;
-	my_console.WriteToSplitConsole("Timeout during audio capture!", param_list.get<int>("split errors"));
+	my_console.WriteToSplitConsole("Timeout during audio capture!", param_list.get<int>(eParamSplitErrors));
 }
 
 void rms_hyst_callback()
 {
 	rms_hyst_ok = true;
-	my_console.WriteToSplitConsole("RMS hysteresis elapsed!", param_list.get<int>("split errors"));
+	my_console.WriteToSplitConsole("RMS hysteresis elapsed!", param_list.get<int>(eParamSplitErrors));
 }
 
 void StateBPM_entry()
 {
-	if (param_list.get<bool>("debug functions") == true)
-		my_console.WriteToSplitConsole("State_entry. BPM counter.", param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugFunctions) == true)
+		my_console.WriteToSplitConsole("State_entry. BPM counter.", param_list.get<int>(eParamSplitFC));
 
-	//Activate timer interrupt
-	//Not possible yet. Interrupt is blocking rest of process
-	//because it is executed far too frequently
-	//gpio_info.gpio_writer->activate_timer_interrupt();
-	
 	//Reset state machine
 	eCaptureState = eBPM_CaptureStartAudio;
 	eAnalyzeState = eBPM_AnalyzeReady;
@@ -311,13 +306,13 @@ FCStates StateBPM_loop()
 	}
 
 	//Log the capture and analyze state if one of it has changed
-	if (param_list.get<bool>("debug bpm state") == true)
+	if (param_list.get<bool>(eParamDebugBPMState) == true)
 	{
 		if ((eCaptureStateOld != eCaptureState) || (eAnalyzeStateOld != eAnalyzeState))
 		{
 			std::string s = "Capture State = " + std::to_string((int)eCaptureState);
 			s += "; Analyze State = " + std::to_string((int)eAnalyzeState);
-			my_console.WriteToSplitConsole(s, param_list.get<int>("split fc"));
+			my_console.WriteToSplitConsole(s, param_list.get<int>(eParamSplitFC));
 		}
 	}
 
@@ -335,6 +330,22 @@ FCStates StateBPM_loop()
 	{
 		bpm_value = value_handler.process_value(bpm);
 		bpm_old = bpm;
+
+		//Smoothed value is the lock for tempo tracking of the analyzer
+		bpm_info.bpm_analyze->set_tempo_lock(bpm_value, value_handler.get_confidence());
+
+		//Push update to subscribed socket clients
+		#ifndef _WIN32
+			FCTelemetry telemetry;
+			telemetry.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+			telemetry.bpm_raw = bpm;
+			telemetry.bpm_smoothed = bpm_value;
+			telemetry.rms = bpm_info.bpm_analyze->get_rms();
+			telemetry.duration = bpm_info.bpm_analyze->get_duration();
+			telemetry.confidence = value_handler.get_confidence();
+			telemetry.phase = bpm_info.bpm_analyze->get_beat_phase();
+			appl_info.os_socket->publish(telemetry);
+		#endif
 	}
 
 	//Display the value using gpio writer
@@ -355,17 +366,13 @@ FCStates StateBPM_loop()
 		else
 		{		
 			//Display according sentence
-			int cycle = param_list.get<int>("man cycle");
+			int cycle = param_list.get<int>(eParamManCycle);
 			eError finished = gpio_info.gpio_writer->print_string(sentences[number], cycle);
 			//Check if we have to generate a new random number
 			if (finished == eSuccess)
 				number = rand() % NUM_SENTENCES;
 		}
 
-		//gpio_info.gpio_writer->print_number((float)bpm_value);
-		//Timer interrupt function, not used yet
-		//gpio_info.gpio_writer->set_value(bpm_value);
-
 		//Display value using window
 		if (appl_info.hdmi_attached == true)
 		{
@@ -398,10 +405,6 @@ int StateBPM_exit()
 	//Clear rms flag
 	rms_value_ok = false;
 
-	//Deactivate timer interrupt
-	//Not used yet
-	//gpio_info.gpio_writer->deactivate_timer_interrupt();
-
 	//We shut down all pins
 	//GPIO not used on WIN32
 	#ifndef _WIN32
@@ -415,8 +418,8 @@ int StateBPM_exit()
 	rms_timer_started = false;
 	rms_hyst_ok = false;
 
-	if (param_list.get<bool>("debug functions") == true)
-		my_console.WriteToSplitConsole("State BPM counter exit.", param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugFunctions) == true)
+		my_console.WriteToSplitConsole("State BPM counter exit.", param_list.get<int>(eParamSplitFC));
 
 	NEXT_STATE;
 }
@@ -428,8 +431,8 @@ long long ms_old2 = 0;
 
 void StateTimer_entry()
 {
-	if (param_list.get<bool>("debug functions") == true)
-		my_console.WriteToSplitConsole("State_entry. Click counter.", param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugFunctions) == true)
+		my_console.WriteToSplitConsole("State_entry. Click counter.", param_list.get<int>(eParamSplitFC));
 
 	ms_old2 = 0;
 
@@ -450,12 +453,12 @@ FCStates StateTimer_loop()
 	#endif
 
 	//Write debug line
-	if (param_list.get<bool>("debug functions") == true)
+	if (param_list.get<bool>(eParamDebugFunctions) == true)
 	{
 		if (ms - ms_old2 > 1000)
 		{
 			std::string s = "Timervalue : " + std::to_string((float)ms / 1000);
-			my_console.WriteToSplitConsole(s, param_list.get<int>("split fc"));
+			my_console.WriteToSplitConsole(s, param_list.get<int>(eParamSplitFC));
 			ms_old2 = ms;
 		}
 	}
@@ -466,7 +469,7 @@ FCStates StateTimer_loop()
 void timer1_elapsed()
 {
 	//Write some message
-	my_console.WriteToSplitConsole("The timer has elapsed!", param_list.get<int>("split fc"));
+	my_console.WriteToSplitConsole("The timer has elapsed!", param_list.get<int>(eParamSplitFC));
 }
 
 //***************************
@@ -488,8 +491,8 @@ int *f = &second;
 
 void StateClock_entry()
 {
-	if (param_list.get<bool>("debug functions") == true)
-		my_console.WriteToSplitConsole("State_entry. Clock.", param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugFunctions) == true)
+		my_console.WriteToSplitConsole("State_entry. Clock.", param_list.get<int>(eParamSplitFC));
 
 	//Start timer
 	START_TIMER(eTestTimer1);
@@ -525,8 +528,8 @@ std::string str_old = "";
 
 void StateManual_entry()
 {
-	if (param_list.get<bool>("debug functions") == true)
-		my_console.WriteToSplitConsole("State_entry. Manual mode.", param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugFunctions) == true)
+		my_console.WriteToSplitConsole("State_entry. Manual mode.", param_list.get<int>(eParamSplitFC));
 
 	my_string = "";
 	str_old = my_string;
@@ -545,15 +548,15 @@ FCStates StateManual_loop()
 	//Check if it has changed
 	if (str_old != my_string)
 	{
-		my_console.WriteToSplitConsole("Displaying: " + my_string, param_list.get<int>("split fc"));
-		my_console.WriteToSplitConsole("Length: " + std::to_string(len), param_list.get<int>("split fc"));
+		my_console.WriteToSplitConsole("Displaying: " + my_string, param_list.get<int>(eParamSplitFC));
+		my_console.WriteToSplitConsole("Length: " + std::to_string(len), param_list.get<int>(eParamSplitFC));
 		str_old = my_string;
 	}
 	
 	//Display the string using GPIO writer
 	//GPIO not used on WIN32
 	#ifndef _WIN32
-		int cycle = param_list.get<int>("man cycle");
+		int cycle = param_list.get<int>(eParamManCycle);
 		gpio_info.gpio_writer->print_string(my_string.c_str(), cycle);
 	#endif
 
@@ -565,8 +568,8 @@ FCStates StateManual_loop()
 //******************************************
 void StateQuit_entry()
 {
-	if (param_list.get<bool>("debug functions") == true)
-		my_console.WriteToSplitConsole("Quit state.", param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugFunctions) == true)
+		my_console.WriteToSplitConsole("Quit state.", param_list.get<int>(eParamSplitFC));
 
 	CURRENT_STATE;
 }
@@ -593,8 +596,8 @@ int StateX_exit()
 		gpio_info.gpio_writer->reset_display(0);
 	#endif
 
-	if (param_list.get<bool>("debug functions") == true)
-		my_console.WriteToSplitConsole("State exit.", param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugFunctions) == true)
+		my_console.WriteToSplitConsole("State exit.", param_list.get<int>(eParamSplitFC));
 
 	NEXT_STATE;
 }
@@ -608,8 +611,8 @@ bool quit_TCP = false;
 
 void StateTCP_entry()
 {
-	if (param_list.get<bool>("debug functions") == true)
-		my_console.WriteToSplitConsole("State_entry. TCP mode.", param_list.get<int>("split fc"));
+	if (param_list.get<bool>(eParamDebugFunctions) == true)
+		my_console.WriteToSplitConsole("State_entry. TCP mode.", param_list.get<int>(eParamSplitFC));
 
 	my_string_tcp = "";
 	str_tcp_old = my_string_tcp;
@@ -642,15 +645,15 @@ FCStates StateTCP_loop()
 		{
 			//Retrieve lenght of string to display
 			int len = my_string_tcp.length();
-			my_console.WriteToSplitConsole("Displaying: " + my_string_tcp, param_list.get<int>("split fc"));
-			my_console.WriteToSplitConsole("Length: " + std::to_string(len), param_list.get<int>("split fc"));
+			my_console.WriteToSplitConsole("Displaying: " + my_string_tcp, param_list.get<int>(eParamSplitFC));
+			my_console.WriteToSplitConsole("Length: " + std::to_string(len), param_list.get<int>(eParamSplitFC));
 			str_tcp_old = my_string_tcp;
 		}
 	
 		//Display the string using GPIO writer
 		//GPIO not used on WIN32
 		#ifndef _WIN32
-			int cycle = param_list.get<int>("man cycle");
+			int cycle = param_list.get<int>(eParamManCycle);
 			gpio_info.gpio_writer->print_string(str_tcp_old.c_str(), cycle);
 		#endif
 	}
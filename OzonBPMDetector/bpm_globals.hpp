@@ -37,6 +37,7 @@ enum eError
 	eGPIONumberNotValid		=	0x01,
 	eGPIOConfiguredAsInput		=	0x02,
 	eGPIOWriterNotInitialized	=	0x03,
+	eGPIOBackendNotInitialized	=	0x04,
 
 	eGPIOWriterResetInvalidOption   =       0x06,
 	eGPIOWriterInvalidCharacter     =	0x07,
@@ -75,6 +76,7 @@ enum eError
 	eAudio_ErrorCapturingAudio	= 0x3C,
 	eAudio_ErrorInputStreamNotOpen  = 0x3D,
 	eAudio_ErrorBufferNotReady	= 0x3E,
+	eAudio_InvalidWavFile		= 0x3F,
 
 	//Analyzer errors
 	eAnalyzer_NotInitialized	= 0x50,
@@ -106,6 +108,9 @@ enum eEvents
 	eCheckRMSValue			=	11,
 	eReadWavFile			=	12,
 	eStopRecording			=	13,
+	eButtonPressed			=	14,
+	eButtonHeldShort		=	15,
+	eButtonHeldLong			=	16,
 
 	eLastEvent /* used for array size determination */
 };
@@ -285,10 +290,6 @@ struct SevenSegTiming
 	long int pause_seg_addr;
 };
 
-//Cycle time used for timer interrupt controlled gpio writer
-//(not working yet)
-#define DISPLAY_CYCLE 200
-
 //Time we wait after exiting prompt while loop
 #define EXIT_WAIT 3000
 
@@ -332,12 +333,36 @@ struct SevenSegTiming
 //Defines for bpm detection
 #define DOWNSAMPLE_FACTOR 4
 #define AUTOCORR_RES 1200 // MaxBPM - MinBPM * 10 (resolution 7seg)
+//Coarse to fine autocorrelation search - grid step of coarse search and number of refined maxima
+#define AUTOCORR_COARSE_STEP 8
+#define AUTOCORR_CANDIDATES 4
+//Tempo tracking - lag window around the locked tempo (and half/double) in bpm,
+//full range rescan after this number of tracked calculations and minimum
+//confidence of the bpm value handler for a lock
+#define TRACK_WINDOW 3.0
+#define TRACK_RESCAN_CYCLES 16
+#define TRACK_MIN_CONFIDENCE 0.5
+
+//Onset detection (algorithm 2)
+//Frame size and hop of the spectral flux - novelty rate is 44100 / 256 = 172 Hz
+#define ONSET_FRAME_SIZE 1024
+#define ONSET_HOP_SIZE 256
+//Log frequency bands for the flux - third octaves
+#define ONSET_BANDS_PER_OCTAVE 3
+#define ONSET_FREQ_MIN 30.0
+#define ONSET_FREQ_MAX 16000.0
+//Log compression of band magnitudes - log(1 + C * x)
+#define ONSET_COMPRESSION 1000.0
+//Maximum number of novelty values kept (~6s)
+#define ONSET_HISTORY 1024
 
 //Biquad filtering
 #define BIQ_FILT_ORDER  12
 //File names for coefficients file
 #define FN_COEFFS_L "coeffs_L2.txt"
 #define FN_COEFFS_H "coeffs_H2.txt"
+//Peak extraction debug output
+#define FN_PEAK_DATA "peak_data.txt"
 
 //Some sentences to display
 #define NUM_SENTENCES 10
@@ -5,11 +5,75 @@
 #include <vector>
 #include <limits>
 #include <typeinfo>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 //Basic parameter data type
 //All parameters are inherited from this type
 typedef enum { TypeUNKNOWN, TypeBOOL, TypeINT, TypeDOUBLE } Type;
 
+//Enum for parameter keys - used as index into the parameter list
+//Hot paths use these compile-time keys instead of the parameter names,
+//so no string comparison or hashing is needed to access a value
+enum eParams
+{
+	//Debug output
+	eParamDebugMain,
+	eParamDebugGPIO,
+	eParamDebugWriter,
+	eParamDebugListener,
+	eParamDebugButton,
+	eParamDebugQueue,
+	eParamDebugState,
+	eParamDebugMachine,
+	eParamDebugFunctions,
+	eParamDebugBPMState,
+	eParamDebugAudio,
+	eParamDebugWavfile,
+	eParamDebugAnalyze,
+	eParamDebugBiquad,
+	//FC Queue
+	eParamQueueSize,
+	eParamQueueWaitTime,
+	//Split Console
+	eParamSplitLogging,
+	eParamSplitErrors,
+	eParamSplitFC,
+	eParamSplitAudio,
+	eParamSplitMain,
+	eParamSplitInput,
+	//Timing of segment display
+	eParamControlMode,
+	eParamHoldAddrSeg,
+	eParamPauseAddrSeg,
+	eParamHoldSegAddr,
+	eParamPauseSegAddr,
+	//Debug output file creation
+	eParamCreateWavfiles,
+	eParamCreateAutocorrFiles,
+	eParamCreatePeakData,
+	//Audio analysis
+	eParamAlgorithm,
+	eParamLoFreq,
+	eParamHiFreq,
+	eParamBPMMin,
+	eParamBPMMax,
+	eParamEnvFiltRec,
+	eParamPeakWidth,
+	eParamPeakThreshold,
+	eParamPeakAdjacence,
+	eParamRMSThreshold,
+	eParamAutocorrSearch,
+	eParamTempoTracking,
+	eParamAutocorrStream,
+	eParamPrecision,
+	//Functions
+	eParamManCycle,
+
+	eNumberOfParams /* used for array size determination */
+};
+
 class Param
 {
 public:
@@ -23,46 +87,63 @@ protected:
 	Type type;
 };
 
+//The value is stored as atomic, so it can be read from any thread
+//without locking. Writers are serialized by the parameter list.
 template <typename T>
 class TypedParam : public Param
 {
 public:
-	TypedParam(const std::string& name, const T& data, const T& min = std::numeric_limits<T>::min(), const T& max = std::numeric_limits<T>::max()) 
-	: Param(name), data(data), max(max), min(min) { check(); }
-	T get() { return this->data; }
+	TypedParam(const std::string& name, const T& data, const T& min = std::numeric_limits<T>::min(), const T& max = std::numeric_limits<T>::max())
+	: Param(name), data(data), max(max), min(min) { init_type(); check(); }
+	T get() { return this->data.load(std::memory_order_relaxed); }
 	T get_min() { return this->min; }
 	T get_max() { return this->max; }
-	void set(T val) { this->data = val; check(); }
+	//Value is clamped before the store - lock free readers never see an out of range value
+	void set(T val) { this->data.store(clamp(val), std::memory_order_relaxed); }
 	void set_min(T val) { this->min = val; check(); }
 	void set_max(T val) { this->max = val; check(); }
 
 private:
-	T data;
+	std::atomic<T> data;
 	T min, max;
+	T clamp(T val)
+	{
+		if (val < this->min)
+			return this->min;
+		if (val > this->max)
+			return this->max;
+		return val;
+	}
 	void check()
 	{
-		if (this->data < this->min)
-			this->data = this->min;
-		if (this->data > this->max)
-			this->data = this->max;
-
+		T val = this->data.load(std::memory_order_relaxed);
+		T clamped = clamp(val);
+		if (clamped != val)
+			this->data.store(clamped, std::memory_order_relaxed);
+	}
+	void init_type()
+	{
+		//The type never changes, so we determine it once
 		this->type = TypeUNKNOWN;
-		if (typeid(this->data) == typeid(bool))
+		if (typeid(T) == typeid(bool))
 			this->type = TypeBOOL;
-		if (typeid(this->data) == typeid(int))
+		if (typeid(T) == typeid(int))
 			this->type = TypeINT;
-		if (typeid(this->data) == typeid(double))
+		if (typeid(T) == typeid(double))
 			this->type = TypeDOUBLE;
 	}
 };
 
 //Parameter list handler
 //This is basically a simple container for various data types
-//Usage: add() adds elements to the parameter list. Lookup is done by
-//the name property. Note that data type must be supplied by user.
-//get() retrieves a parameter value indexed by its name
-//set() sets a parameter value indexed by its name
+//Usage: add() adds elements to the parameter list. Lookup is done either by
+//the key (enum eParams, O(1) array access) or by the name property (hashed).
+//Note that data type must be supplied by user.
+//get() retrieves a parameter value indexed by its key or name
+//set() sets a parameter value indexed by its key or name
 //If name is not found or data type is wrong, an empty value is returned.
+//Readers never lock: values are atomics and every write bumps a version
+//counter (seqlock). Use snapshot() to read several values consistently.
 
 //Forward declaration of init function
 void init_param();
@@ -70,57 +151,61 @@ void init_param();
 class ParamList
 {
 public:
-	ParamList() 
+	ParamList() : list(eNumberOfParams, nullptr), version(0)
 	{
 		//Create parameters
 		//Debug output
-		add(new TypedParam<bool>("debug main", true));
-		add(new TypedParam<bool>("debug gpio", false));
-		add(new TypedParam<bool>("debug writer", false));
-		add(new TypedParam<bool>("debug listener", false));
-		add(new TypedParam<bool>("debug button", true));
-		add(new TypedParam<bool>("debug queue", false));
-		add(new TypedParam<bool>("debug state", false));
-		add(new TypedParam<bool>("debug machine", false));
-		add(new TypedParam<bool>("debug functions", true));
-		add(new TypedParam<bool>("debug bpm state", false));
-		add(new TypedParam<bool>("debug audio", true));
-		add(new TypedParam<bool>("debug wavfile", false));
-		add(new TypedParam<bool>("debug analyze", true));
-		add(new TypedParam<bool>("debug biquad", false));
+		add(eParamDebugMain, new TypedParam<bool>("debug main", true));
+		add(eParamDebugGPIO, new TypedParam<bool>("debug gpio", false));
+		add(eParamDebugWriter, new TypedParam<bool>("debug writer", false));
+		add(eParamDebugListener, new TypedParam<bool>("debug listener", false));
+		add(eParamDebugButton, new TypedParam<bool>("debug button", true));
+		add(eParamDebugQueue, new TypedParam<bool>("debug queue", false));
+		add(eParamDebugState, new TypedParam<bool>("debug state", false));
+		add(eParamDebugMachine, new TypedParam<bool>("debug machine", false));
+		add(eParamDebugFunctions, new TypedParam<bool>("debug functions", true));
+		add(eParamDebugBPMState, new TypedParam<bool>("debug bpm state", false));
+		add(eParamDebugAudio, new TypedParam<bool>("debug audio", true));
+		add(eParamDebugWavfile, new TypedParam<bool>("debug wavfile", false));
+		add(eParamDebugAnalyze, new TypedParam<bool>("debug analyze", true));
+		add(eParamDebugBiquad, new TypedParam<bool>("debug biquad", false));
 		//FC Queue
-		add(new TypedParam<int>("queue size", 32, 16, 256));
-		add(new TypedParam<int>("queue wait time", 100, 0, 1000));
+		add(eParamQueueSize, new TypedParam<int>("queue size", 32, 16, 256));
+		add(eParamQueueWaitTime, new TypedParam<int>("queue wait time", 100, 0, 1000));
 		//Split Console
-		add(new TypedParam<bool>("split logging", 0, 0, 1));
-		add(new TypedParam<int>("split errors", 4, 0, 4));
-		add(new TypedParam<int>("split fc", 3, 0, 4));
-		add(new TypedParam<int>("split audio", 2, 0, 4));
-		add(new TypedParam<int>("split main", 1, 0, 4));
-		add(new TypedParam<int>("split input", 0, 0, 4));
+		add(eParamSplitLogging, new TypedParam<bool>("split logging", 0, 0, 1));
+		add(eParamSplitErrors, new TypedParam<int>("split errors", 4, 0, 4));
+		add(eParamSplitFC, new TypedParam<int>("split fc", 3, 0, 4));
+		add(eParamSplitAudio, new TypedParam<int>("split audio", 2, 0, 4));
+		add(eParamSplitMain, new TypedParam<int>("split main", 1, 0, 4));
+		add(eParamSplitInput, new TypedParam<int>("split input", 0, 0, 4));
 		//Timing of segment display
-		add(new TypedParam<int>("control mode", 1, 0, 1));
-		add(new TypedParam<int>("hold addr seg", 400, 100, 5000));
-		add(new TypedParam<int>("pause addr seg", 50, 10, 5000));
-		add(new TypedParam<int>("hold seg addr", 400, 100, 5000));
-		add(new TypedParam<int>("pause seg addr", 50, 10, 5000));
+		add(eParamControlMode, new TypedParam<int>("control mode", 1, 0, 1));
+		add(eParamHoldAddrSeg, new TypedParam<int>("hold addr seg", 400, 100, 5000));
+		add(eParamPauseAddrSeg, new TypedParam<int>("pause addr seg", 50, 10, 5000));
+		add(eParamHoldSegAddr, new TypedParam<int>("hold seg addr", 400, 100, 5000));
+		add(eParamPauseSegAddr, new TypedParam<int>("pause seg addr", 50, 10, 5000));
 		//Debug output file creation
-		add(new TypedParam<bool>("create wavfiles", false));
-		add(new TypedParam<bool>("create autocorr files", false));
-		add(new TypedParam<bool>("create peak data", false));
+		add(eParamCreateWavfiles, new TypedParam<bool>("create wavfiles", false));
+		add(eParamCreateAutocorrFiles, new TypedParam<bool>("create autocorr files", false));
+		add(eParamCreatePeakData, new TypedParam<bool>("create peak data", false));
 		//Audio analysis
-		add(new TypedParam<int>("algorithm", 1, 0, 1));
-		add(new TypedParam<double>("lo freq", 20.0, 20.0, 200.0));
-		add(new TypedParam<double>("hi freq", 150.0, 100.0, 300.0));
-		add(new TypedParam<double>("bpm min", 100.0, 100.0, 120.0));
-		add(new TypedParam<double>("bpm max", 200.0, 160.0, 240.0));
-		add(new TypedParam<double>("env filt rec", 0.005, 0.001, 0.05));
-		add(new TypedParam<double>("peak width", 200.0, 20.0, 1000.0));
-		add(new TypedParam<double>("peak threshold", 0.3, 0.01, 0.9));
-		add(new TypedParam<double>("peak adjacence", 60.0, 5.0, 200.0));
-		add(new TypedParam<double>("rms threshold", 1200.0, 0.0, 32767.0));
+		add(eParamAlgorithm, new TypedParam<int>("algorithm", 1, 0, 3));
+		add(eParamLoFreq, new TypedParam<double>("lo freq", 20.0, 20.0, 200.0));
+		add(eParamHiFreq, new TypedParam<double>("hi freq", 150.0, 100.0, 300.0));
+		add(eParamBPMMin, new TypedParam<double>("bpm min", 100.0, 100.0, 120.0));
+		add(eParamBPMMax, new TypedParam<double>("bpm max", 200.0, 160.0, 240.0));
+		add(eParamEnvFiltRec, new TypedParam<double>("env filt rec", 0.005, 0.001, 0.05));
+		add(eParamPeakWidth, new TypedParam<double>("peak width", 200.0, 20.0, 1000.0));
+		add(eParamPeakThreshold, new TypedParam<double>("peak threshold", 0.3, 0.01, 0.9));
+		add(eParamPeakAdjacence, new TypedParam<double>("peak adjacence", 60.0, 5.0, 200.0));
+		add(eParamRMSThreshold, new TypedParam<double>("rms threshold", 1200.0, 0.0, 32767.0));
+		add(eParamAutocorrSearch, new TypedParam<bool>("autocorr search", false));
+		add(eParamTempoTracking, new TypedParam<bool>("tempo tracking", false));
+		add(eParamAutocorrStream, new TypedParam<bool>("autocorr stream", false));
+		add(eParamPrecision, new TypedParam<int>("precision", 0, 0, 3));
 		//Functions
-		add(new TypedParam<int>("man cycle", 500, 100, 2000));
+		add(eParamManCycle, new TypedParam<int>("man cycle", 500, 100, 2000));
 	}
 
 	~ParamList()
@@ -129,76 +214,114 @@ public:
 		for (iter = this->list.begin(); iter < this->list.end(); ++iter)
 			delete (*iter);
 		this->list.clear();
+		this->index.clear();
+	}
+
+	void add(eParams key, Param* p)
+	{
+		//Store parameter at its key and register the name for string lookup
+		this->list[key] = p;
+		this->index[p->get_name()] = key;
 	}
 
-	void add(Param* p) { this->list.push_back(p); }
-	
 	Type get_type(const std::string& name)
 	{
 		Type retval = TypeUNKNOWN;
-		std::vector<Param*>::iterator iter, end;
-		for (iter = this->list.begin(), end = this->list.end(); iter < end; ++iter)
-		{
-			if (name == (*iter)->get_name())
-			{
-				retval = (*iter)->get_type();
-			}
-		}
+		int key = find(name);
+		if (key != -1)
+			retval = this->list[key]->get_type();
 		return retval;
 	}
 
 	bool valid(const std::string& name)
 	{
-		bool success = false;
-		std::vector<Param*>::iterator iter, end;
-		for (iter = this->list.begin(), end = this->list.end(); iter < end; ++iter)
-		{
-			if (name == (*iter)->get_name())
-			{
-				success = true;
-			}
-		}
-		return success;
+		return (find(name) != -1);
 	}
 
+	//Access by key - used in hot paths
+	template <typename T>
+	T get(eParams key)
+	{
+		return ((TypedParam<T>*)this->list[key])->get();
+	}
+
+	template <typename T>
+	bool set(eParams key, T val)
+	{
+		//Writers are serialized, readers are never blocked
+		std::lock_guard<std::mutex> lock(this->mtx);
+		unsigned long v = this->version.load(std::memory_order_relaxed);
+		this->version.store(v + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		((TypedParam<T>*)this->list[key])->set(val);
+		this->version.store(v + 2, std::memory_order_release);
+		return true;
+	}
+
+	//Access by name - used for parameters from socket or console
 	template <typename T>
 	T get(const std::string& name)
 	{
 		T retval { };
-		std::vector<Param*>::iterator iter, end;
-		for (iter = this->list.begin(), end = this->list.end(); iter < end; ++iter)
-		{
-			if (name == (*iter)->get_name())
-			{
-				retval = ((TypedParam<T>*)(*iter))->get();
-			}
-		}
+		int key = find(name);
+		if (key != -1)
+			retval = get<T>((eParams)key);
 		return retval;
 	}
 
 	template <typename T>
 	bool set(const std::string& name, T val)
 	{
-		bool success = false;
-		std::vector<Param*>::iterator iter, end;
-		for (iter = this->list.begin(), end = this->list.end(); iter < end; ++iter)
+		int key = find(name);
+		if (key == -1)
+			return false;
+		return set<T>((eParams)key, val);
+	}
+
+	//Version is increased on every change of a parameter
+	//Readers can compare it to decide if cached values are still valid
+	unsigned long get_version()
+	{
+		return this->version.load(std::memory_order_acquire);
+	}
+
+	//Read several parameters as one consistent snapshot
+	//The reader function is repeated if a writer changed the list meanwhile,
+	//so all values read belong to the same version. Returns that version.
+	template <typename F>
+	unsigned long snapshot(F read)
+	{
+		unsigned long v1, v2;
+		do
 		{
-			if (name == (*iter)->get_name())
-			{
-				((TypedParam<T>*)(*iter))->set(val);
-				success = true;
-			}
-		}
-		return success;
+			v1 = this->version.load(std::memory_order_acquire);
+			read();
+			std::atomic_thread_fence(std::memory_order_acquire);
+			v2 = this->version.load(std::memory_order_relaxed);
+		} while ((v1 & 1) != 0 || v1 != v2);
+		return v1;
 	}
 
 	//Some explanation for type cast:
-	//To access iterator, it must be dereferenced -> *iter (access underlying pointer)
-	//This underlying pointer is of type Param* and must be cast 
-	//from base to derived type -> (TypedParam<T>*)
-	
+	//To access the parameter, the underlying pointer of type Param*
+	//must be cast from base to derived type -> (TypedParam<T>*)
+
 private:
 	std::vector<Param*> list;
+	//Hash index for lookup by name
+	std::unordered_map<std::string, int> index;
+	//Version counter for lock-free readers
+	std::atomic<unsigned long> version;
+	//Mutex used by writers only
+	std::mutex mtx;
+
+	int find(const std::string& name)
+	{
+		std::unordered_map<std::string, int>::const_iterator iter = this->index.find(name);
+		if (iter == this->index.end())
+			return -1;
+		return iter->second;
+	}
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -88,6 +88,27 @@ public:
 		}
 	}
 
+	//Confidence of the current value [0..1]
+	//Share of the last values close to their mean, reduced by
+	//the number of 'bad' values in a row
+	double get_confidence()
+	{
+		if (this->first_value == true)
+			return 0.0;
+
+		double average = mean();
+		int close = 0;
+		for (int i = 0; i < BPMVALUE_ARRAY_SIZE; i++)
+		{
+			if (fabs(this->values[i] - average) < THRES_CHANGE_LOW)
+				close++;
+		}
+
+		double confidence = (double)close / BPMVALUE_ARRAY_SIZE;
+		confidence *= 1.0 - (double)this->bad_values / (MAX_BAD_VALUES + 1);
+		return confidence;
+	}
+
 private:
 	//Array for holding the last measured values
 	double values[BPMVALUE_ARRAY_SIZE];
@@ -56,6 +56,8 @@ public:
 		return this->values[index];
 	}
 
+	T* data() { return this->values; }
+	const T* data() const { return this->values; }
 	long get_size() const { return this->size; }
 	long get_sample_rate() const { return this->sample_rate; }
 	bool is_initialized() const { return this->initialized; }
@@ -87,4 +89,52 @@ private:
 	bool initialized;
 };
 
+//Non-owning view of samples
+//Used to hand out data without copying it, e.g. samples of a memory
+//mapped file. The view is only valid as long as the owner of the data.
+template <typename T>
+class buffer_view
+{
+public:
+	buffer_view<T>()
+	{
+		this->values = nullptr;
+		this->size = 0;
+		this->sample_rate = 0;
+	}
+
+	buffer_view<T>(const T* values, long size, long sample_rate)
+	{
+		this->values = values;
+		this->size = size;
+		this->sample_rate = sample_rate;
+	}
+
+	const T& operator[](long index) const
+	{
+		assert(this->values != nullptr && index < this->size);
+		return this->values[index];
+	}
+
+	const T* data() const { return this->values; }
+	long get_size() const { return this->size; }
+	long get_sample_rate() const { return this->sample_rate; }
+	bool is_initialized() const { return (this->values != nullptr); }
+
+	//Get part of the view - count is limited to the end of the view
+	buffer_view<T> subview(long offset, long count) const
+	{
+		if (offset > this->size)
+			offset = this->size;
+		if (count > this->size - offset)
+			count = this->size - offset;
+		return buffer_view<T>(this->values + offset, count, this->sample_rate);
+	}
+
+private:
+	const T* values;
+	long size;
+	long sample_rate;
+};
+
 #endif
@@ -0,0 +1,149 @@
+//Purpose: Test of the edge triggered reset button with a simulated line (GPIOLineSim)
+//Bouncing presses of different durations are injected. Durations are taken from the
+//injected timestamps, only the debounce time runs in real time. Every release has
+//to be reported once with the classification of its press duration, glitches shorter
+//than the debounce time not at all. A line with failing edge events has to fall back
+//to polling.
+
+#include <cstdio>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <unistd.h>
+#include <fcntl.h>
+#include "bpm_globals.hpp"
+#include "bpm_param.hpp"
+#include "SplitConsole.hpp"
+#include "GPIOButton.hpp"
+#include "GPIOLine.hpp"
+
+//Wait after a bounce sequence - longer than the debounce time
+#define SETTLE_MS (3 * DEBOUNCE_MS)
+
+SplitConsole my_console;
+ParamList param_list;
+
+//Presses reported by the event thread of the button
+static std::mutex reports_mtx;
+static std::vector<eButtonHandlerState> reports;
+
+static void button_handler(eButtonHandlerState state)
+{
+	std::lock_guard<std::mutex> lock(reports_mtx);
+	reports.push_back(state);
+}
+
+static std::vector<eButtonHandlerState> take_reports()
+{
+	std::lock_guard<std::mutex> lock(reports_mtx);
+	std::vector<eButtonHandlerState> result;
+	result.swap(reports);
+	return result;
+}
+
+static void settle()
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(SETTLE_MS));
+}
+
+//Injects a bouncing edge - the level toggles a few times within 2 ms
+static void inject_bounce(GPIOLineSim* line, bool value, long long timestamp)
+{
+	line->inject(value, timestamp);
+	line->inject(!value, timestamp + 500000);
+	line->inject(value, timestamp + 1000000);
+	line->inject(!value, timestamp + 1500000);
+	line->inject(value, timestamp + 2000000);
+}
+
+//Line whose edge events fail - the write end of the pipe is closed, so poll() reports POLLHUP
+class GPIOLineBroken : public GPIOLine
+{
+public:
+	GPIOLineBroken()
+	{
+		if (pipe2(this->fds, O_CLOEXEC) != 0)
+			this->fds[0] = -1;
+		else
+			close(this->fds[1]);
+	}
+	~GPIOLineBroken() { if (this->fds[0] >= 0) close(this->fds[0]); }
+
+	eError check_init() { return (this->fds[0] >= 0) ? eSuccess : eGPIOListenerNotInitialized; }
+	int get_fd() { return this->fds[0]; }
+	bool read_edge(GPIOEdge&) { return false; }
+	bool get_value() { return false; }
+
+private:
+	int fds[2];
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* text)
+{
+	printf("%-60s - %s\n", text, (ok == true) ? "ok" : "FAILED");
+	if (ok == false)
+		failures++;
+}
+
+int main()
+{
+	GPIOLineSim* line = new GPIOLineSim();
+	GPIOButton button(line);
+	check(button.check_init() == eSuccess, "Button with simulated line initialized");
+	check(button.is_edge_triggered() == true, "Button is edge triggered");
+	check(button.start_events(button_handler) == eSuccess, "Event thread started");
+
+	//Presses with bouncing edges: duration in ms and expected classification
+	struct Press
+	{
+		long ms;
+		eButtonHandlerState expected;
+		const char* text;
+	};
+	const Press presses[] =
+	{
+		{ 300, Handler_ButtonPressed, "Short press with bounces -> PRESSED" },
+		{ TIME_SHORT_MS - 100, Handler_ButtonPressed, "Press just below 2 s -> PRESSED" },
+		{ TIME_SHORT_MS + 500, Handler_ButtonHeldShort, "2.5 s press -> HELD SHORT" },
+		{ TIME_LONG_MS - 100, Handler_ButtonHeldShort, "Press just below 5 s -> HELD SHORT" },
+		{ TIME_LONG_MS + 500, Handler_ButtonHeldLong, "5.5 s press -> HELD LONG" }
+	};
+
+	long long timestamp = 1000000000LL;
+	for (const Press& press : presses)
+	{
+		inject_bounce(line, true, timestamp);
+		settle();
+		check(take_reports().empty() == true, "  no report while the button is held");
+
+		timestamp += press.ms * 1000000LL;
+		inject_bounce(line, false, timestamp);
+		settle();
+		std::vector<eButtonHandlerState> result = take_reports();
+		check((result.size() == 1) && (result[0] == press.expected), press.text);
+
+		timestamp += 1000000000LL;
+	}
+
+	//Glitch - pressed and released within the debounce time
+	line->inject(true, timestamp);
+	line->inject(false, timestamp + 1000000);
+	settle();
+	check(take_reports().empty() == true, "Glitch shorter than debounce time is ignored");
+
+	button.stop_events();
+	check(line->get_dropped() == 0, "No injected edges dropped");
+
+	//Failing edge events - the button is polled afterwards
+	GPIOButton broken(new GPIOLineBroken());
+	check(broken.start_events(button_handler) == eSuccess, "Event thread with failing line started");
+	settle();
+	check(broken.is_edge_triggered() == false, "Failing line falls back to polling");
+	check(broken.get_state() == Handler_ButtonReleased, "Polled button is released");
+	broken.stop_events();
+
+	return (failures == 0) ? 0 : 1;
+}
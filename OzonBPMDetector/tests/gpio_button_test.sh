@@ -0,0 +1,3 @@
+#!/bin/bash
+#Test of the edge triggered button with a simulated line - run from this directory
+g++ gpio_button_test.cpp ../GPIOButton.cpp ../GPIOListener.cpp ../GPIOLine.cpp ../GPIOPin.cpp ../SplitConsole.cpp -I.. -o gpio_button_test -std=c++11 -lpthread -lwiringPi && ./gpio_button_test
@@ -0,0 +1,132 @@
+//Purpose: Test and benchmark of the display refresh with the mock backend (GPIOBackendMock)
+//The backend records the pin state after every bank operation. For a known frame,
+//each phase has to end with the address pin of its digit and the segment pins of
+//its pattern (on) or with all pins low (off) - with one direct print cycle and with
+//the refresh thread. Afterwards the refresh thread runs for REFRESH_MS and the
+//refresh report is printed.
+
+#include <cstdio>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include "bpm_globals.hpp"
+#include "bpm_param.hpp"
+#include "SplitConsole.hpp"
+#include "GPIOWriter.hpp"
+#include "GPIOBackend.hpp"
+
+//Running time of the refresh thread in the benchmark
+#define REFRESH_MS 2000
+//Running time of the refresh thread for the mask check
+#define CHECK_MS 200
+
+SplitConsole my_console;
+ParamList param_list;
+
+//Mock backend which records the pin state after every bank operation
+//Only read after the refresh thread has been joined
+class GPIOBackendRecorder : public GPIOBackendMock
+{
+public:
+	void set_bank(unsigned int mask) { GPIOBackendMock::set_bank(mask); record(); }
+	void clear_bank(unsigned int mask) { GPIOBackendMock::clear_bank(mask); record(); }
+
+	bool recording = false;
+	std::vector<unsigned int> states;
+
+private:
+	void record()
+	{
+		if (this->recording == true)
+			this->states.push_back(read_bank());
+	}
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* text)
+{
+	printf("%-60s - %s\n", text, (ok == true) ? "ok" : "FAILED");
+	if (ok == false)
+		failures++;
+}
+
+//Bank mask of a segment pattern (bit 0..7 = segment 1..8)
+static unsigned int segment_mask(unsigned char pattern)
+{
+	const int pins[8] = { SEGMENT_PIN_1, SEGMENT_PIN_2, SEGMENT_PIN_3, SEGMENT_PIN_4,
+			      SEGMENT_PIN_5, SEGMENT_PIN_6, SEGMENT_PIN_7, SEGMENT_PIN_8 };
+	unsigned int mask = 0;
+	for (int i = 0; i < 8; i++)
+		if ((pattern & (1 << i)) != 0)
+			mask |= 1u << pins[i];
+	return mask;
+}
+
+//Every phase has two bank operations - the state after the second one is the state of the phase
+//Returns the number of complete cycles, -1 if a phase has a wrong state
+static long check_phases(const std::vector<unsigned int>& states, const unsigned int* expected)
+{
+	long phases = (long)states.size() / 2;
+	for (long i = 0; i < phases; i++)
+	{
+		if (states[2 * i + 1] != expected[i % DISPLAY_PHASES])
+			return -1;
+	}
+	return phases / DISPLAY_PHASES;
+}
+
+int main()
+{
+	GPIOBackendRecorder* backend = new GPIOBackendRecorder();
+	GPIOWriter writer(backend);
+
+	unsigned int all_addresses = (1u << ADDRESS_PIN_1) | (1u << ADDRESS_PIN_2) | (1u << ADDRESS_PIN_3) | (1u << ADDRESS_PIN_4);
+	unsigned int all_pins = all_addresses | segment_mask(0xFF);
+	check(backend->get_outputs() == all_pins, "Address and segment pins configured as outputs");
+	check(backend->read_bank() == 0, "All pins low after init");
+
+	//Known frame 128.5 - segment patterns of '1', '2', '8' with dot and '5'
+	const unsigned int addresses[DISPLAY_DIGITS] = { 1u << ADDRESS_PIN_1, 1u << ADDRESS_PIN_2, 1u << ADDRESS_PIN_3, 1u << ADDRESS_PIN_4 };
+	const unsigned char patterns[DISPLAY_DIGITS] = { 6, 91, 127 | 0x80, 109 };
+	unsigned int expected[DISPLAY_PHASES];
+	for (int digit = 0; digit < DISPLAY_DIGITS; digit++)
+	{
+		expected[2 * digit] = addresses[digit] | segment_mask(patterns[digit]);
+		expected[2 * digit + 1] = 0;
+	}
+
+	//Without refresh thread - one cycle is printed directly
+	backend->recording = true;
+	writer.print_number(128.5f);
+	backend->recording = false;
+	check((backend->states.size() == 2 * DISPLAY_PHASES) && (check_phases(backend->states, expected) == 1), "Direct print: bank masks of frame 128.5");
+
+	//With refresh thread - the frame is already set, so recording starts with phase 0
+	backend->states.clear();
+	backend->states.reserve(1 << 16);
+	backend->recording = true;
+	check(writer.start_refresh() == eSuccess, "Refresh thread started");
+	std::this_thread::sleep_for(std::chrono::milliseconds(CHECK_MS));
+	writer.stop_refresh();
+	backend->recording = false;
+	//Last operation is the final clear of all pins
+	backend->states.pop_back();
+	long cycles = check_phases(backend->states, expected);
+	printf("Refresh thread: %ld cycles recorded in %d ms\n", cycles, CHECK_MS);
+	check(cycles > 0, "Refresh thread: bank masks of frame 128.5");
+	check(backend->read_bank() == 0, "All pins low after stop");
+
+	//Benchmark - refresh statistics of the thread with the mock backend
+	writer.reset_statistics();
+	unsigned long writes = backend->get_writes();
+	writer.start_refresh();
+	std::this_thread::sleep_for(std::chrono::milliseconds(REFRESH_MS));
+	writer.stop_refresh();
+	writes = backend->get_writes() - writes;
+	printf("%s", writer.get_refresh_report("\n").c_str());
+	printf("bank operations: %lu (%.0f/s)\n", writes, writes * 1000.0 / REFRESH_MS);
+	check(writer.get_cycles() > 0, "Refresh thread completed cycles");
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,3 @@
+#!/bin/bash
+#Test and benchmark of the display refresh with the mock backend - run from this directory
+g++ gpio_writer_test.cpp ../GPIOWriter.cpp ../GPIOBackend.cpp ../GPIOPin.cpp ../BPMTiming.cpp ../SplitConsole.cpp -I.. -o gpio_writer_test -std=c++11 -lpthread -lwiringPi -O2 && ./gpio_writer_test
@@ -0,0 +1,177 @@
+//Purpose: Regression test for the precision policies of algorithm 1 (Precision.hpp)
+//Synthetic captures (kick and offbeat hihat, noise and a tone) run through the
+//passband filters of coeffs_L2.txt / coeffs_H2.txt. The bpm value of the float,
+//Q15 and Q31 chains has to stay within TOLERANCE_BPM of the double path, for the
+//full lag grid and for the coarse to fine search.
+//Usage: precision_test [directory of the coefficient files, default ..]
+
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <fstream>
+#include "bpm_globals.hpp"
+#include "bpm_param.hpp"
+#include "SplitConsole.hpp"
+#include "PEAKS.hpp"
+#include "Precision.hpp"
+
+//Maximum deviation from the double path - accuracy required for a precision policy
+#define TOLERANCE_BPM 0.1
+//Number of synthetic captures
+#define CAPTURES 20
+
+SplitConsole my_console;
+ParamList param_list;
+
+//Pseudo random numbers - same sequence on all platforms
+static uint32_t seed = 12345;
+static double random_value()
+{
+	seed = seed * 1664525u + 1013904223u;
+	return (double)(seed >> 8) / 16777216.0;
+}
+
+static void create_capture(buffer<short>& capture, double bpm)
+{
+	double period = 60.0 / bpm * PCM_SAMPLE_RATE;
+	double offset = random_value() * period;
+	for (long k = 0; k < capture.get_size(); k++)
+	{
+		double t_kick = fmod(k + offset, period);
+		double t_hihat = fmod(k + offset + period / 2, period);
+		double value = 2000.0 * (random_value() - 0.5);
+		value += 16000.0 * exp(-t_kick / 3000.0) * sin(2 * M_PI * 50.0 * t_kick / PCM_SAMPLE_RATE);
+		value += 6000.0 * exp(-t_hihat / 800.0) * (random_value() - 0.5);
+		value += 4000.0 * sin(2 * M_PI * 440.0 * k / PCM_SAMPLE_RATE);
+		capture[k] = (short)value;
+	}
+}
+
+static bool load_filters(const std::string& dir, BiquadCascade& passband_L, BiquadCascade& passband_H)
+{
+	std::ifstream coeff_file_L(dir + "/" + FN_COEFFS_L, std::ios_base::in);
+	std::ifstream coeff_file_H(dir + "/" + FN_COEFFS_H, std::ios_base::in);
+	if ((coeff_file_L.is_open() == false) || (coeff_file_H.is_open() == false))
+		return false;
+	passband_L.get_param(coeff_file_L);
+	passband_H.get_param(coeff_file_H);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	std::string dir = (argc > 1) ? argv[1] : "..";
+	const char* names[] = { "double", "float", "Q15", "Q31" };
+
+	long size = PCM_BUF_SIZE / PCM_CHANNELS;
+	long sample_rate_DS = PCM_SAMPLE_RATE / DOWNSAMPLE_FACTOR;
+	long size_DS = size / DOWNSAMPLE_FACTOR;
+
+	double bpm_min = param_list.get<double>(eParamBPMMin);
+	double bpm_max = param_list.get<double>(eParamBPMMax);
+	double env_filt_rec = param_list.get<double>(eParamEnvFiltRec);
+	std::vector<double> widths(2, param_list.get<double>(eParamPeakWidth));
+	std::vector<double> thres(2, param_list.get<double>(eParamPeakThreshold));
+	PEAKS::params bpm_params(bpm_min, bpm_max, widths, thres, DSP::weight, (unsigned int)param_list.get<double>(eParamPeakAdjacence));
+	PEAKS::scratch work;
+
+	buffer<short> capture;
+	capture.init_buffer(size, PCM_SAMPLE_RATE);
+	buffer<double> biquad_L, biquad_H, ds_L, ds_H, env, autocorr_L, autocorr_H;
+	biquad_L.init_buffer(size, PCM_SAMPLE_RATE);
+	biquad_H.init_buffer(size, PCM_SAMPLE_RATE);
+	ds_L.init_buffer(size_DS, sample_rate_DS);
+	ds_H.init_buffer(size_DS, sample_rate_DS);
+	env.init_buffer(size_DS, sample_rate_DS);
+	autocorr_L.init_buffer(AUTOCORR_RES, sample_rate_DS);
+	autocorr_H.init_buffer(AUTOCORR_RES, sample_rate_DS);
+	std::vector<buffer<double>*> buffers;
+	buffers.push_back(&autocorr_L);
+	buffers.push_back(&autocorr_H);
+
+	double max_dev[2][4] = { };
+	for (int c = 0; c < CAPTURES; c++)
+	{
+		double bpm = bpm_min + 5.0 + random_value() * (bpm_max - bpm_min - 10.0);
+		create_capture(capture, bpm);
+
+		for (int search = 0; search < 2; search++)
+		{
+			double bpm_double = 0.0;
+			for (int precision = ePrecisionDouble; precision <= ePrecisionQ31; precision++)
+			{
+				//Fresh filters for every run, like a restart of the analyzer
+				BiquadCascade passband_L(BIQ_FILT_ORDER), passband_H(BIQ_FILT_ORDER);
+				if (load_filters(dir, passband_L, passband_H) == false)
+				{
+					printf("Coefficient files not found in %s.\n", dir.c_str());
+					return 2;
+				}
+
+				if (precision == ePrecisionDouble)
+				{
+					//Reference - same steps as BPMAnalyze::get_bpm_value_1
+					for (long i = 0; i < size; i++)
+					{
+						biquad_L[i] = passband_L.process((double)capture[i]);
+						biquad_H[i] = passband_H.process((double)capture[i]);
+					}
+					DSP::downsample_buffer(biquad_L, ds_L, DOWNSAMPLE_FACTOR);
+					DSP::downsample_buffer(biquad_H, ds_H, DOWNSAMPLE_FACTOR);
+					DSP::envelope_filter(ds_L, env, env_filt_rec);
+					if (search == 1)
+						DSP::build_autocorr_array_search(env, autocorr_L, bpm_min, bpm_max, AUTOCORR_COARSE_STEP, AUTOCORR_CANDIDATES);
+					else
+						DSP::build_autocorr_array(env, autocorr_L, bpm_min, bpm_max);
+					DSP::envelope_filter(ds_H, env, env_filt_rec);
+					if (search == 1)
+						DSP::build_autocorr_array_search(env, autocorr_H, bpm_min, bpm_max, AUTOCORR_COARSE_STEP, AUTOCORR_CANDIDATES);
+					else
+						DSP::build_autocorr_array(env, autocorr_H, bpm_min, bpm_max);
+				}
+				else
+				{
+					PrecisionChainBase* chain_L = create_precision_chain((ePrecision)precision, size_DS, sample_rate_DS, DOWNSAMPLE_FACTOR);
+					PrecisionChainBase* chain_H = create_precision_chain((ePrecision)precision, size_DS, sample_rate_DS, DOWNSAMPLE_FACTOR);
+					chain_L->filter(capture, passband_L);
+					chain_H->filter(capture, passband_H);
+					chain_L->envelope(env_filt_rec);
+					chain_H->envelope(env_filt_rec);
+					if (search == 1)
+					{
+						chain_L->autocorr_search(autocorr_L, bpm_min, bpm_max, AUTOCORR_COARSE_STEP, AUTOCORR_CANDIDATES);
+						chain_H->autocorr_search(autocorr_H, bpm_min, bpm_max, AUTOCORR_COARSE_STEP, AUTOCORR_CANDIDATES);
+					}
+					else
+					{
+						chain_L->autocorr(autocorr_L, bpm_min, bpm_max);
+						chain_H->autocorr(autocorr_H, bpm_min, bpm_max);
+					}
+					delete chain_L;
+					delete chain_H;
+				}
+
+				double bpm_value = PEAKS::extract_bpm_value(buffers, bpm_params, work);
+				if (precision == ePrecisionDouble)
+					bpm_double = bpm_value;
+				max_dev[search][precision] = std::max(max_dev[search][precision], fabs(bpm_value - bpm_double));
+			}
+		}
+	}
+
+	//Result
+	bool passed = true;
+	for (int search = 0; search < 2; search++)
+	{
+		for (int precision = ePrecisionFloat; precision <= ePrecisionQ31; precision++)
+		{
+			bool ok = (max_dev[search][precision] <= TOLERANCE_BPM);
+			printf("%-6s %-6s max deviation %.4f bpm - %s\n", names[precision], (search == 1) ? "search" : "full", max_dev[search][precision], (ok == true) ? "ok" : "FAILED");
+			if (ok == false)
+				passed = false;
+		}
+	}
+
+	return (passed == true) ? 0 : 1;
+}
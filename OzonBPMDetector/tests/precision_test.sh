@@ -0,0 +1,3 @@
+#!/bin/bash
+#Regression test for the precision policies - run from this directory
+g++ precision_test.cpp ../Biquad.cpp ../BiquadCascade.cpp ../SplitConsole.cpp -I.. -o precision_test -std=c++11 -lpthread -O2 && ./precision_test ..
@@ -0,0 +1,221 @@
+//Purpose: Test of the wav reader (WAVReader.hpp) with synthetic files
+//RIFF and RF64 files with extra chunks of odd size, the extensible format and
+//cut off data are written to the working directory and streamed through chunks().
+//Every sample has to arrive once and in order, the last chunk may be shorter.
+//Invalid files (RF64 without ds64, 8 bit samples, no data chunk) have to be rejected.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "bpm_globals.hpp"
+#include "bpm_param.hpp"
+#include "SplitConsole.hpp"
+#include "WAVReader.hpp"
+
+//Frames per chunk when streaming
+#define CHUNK_FRAMES 1000
+
+SplitConsole my_console;
+ParamList param_list;
+
+static int failures = 0;
+
+static void check(bool ok, const std::string& text)
+{
+	printf("%-60s - %s\n", text.c_str(), (ok == true) ? "ok" : "FAILED");
+	if (ok == false)
+		failures++;
+}
+
+//Little endian file content
+class WAVWriter
+{
+public:
+	void bytes(const char* text) { this->data.insert(this->data.end(), text, text + strlen(text)); }
+	void u16(unsigned int value) { put(value, 2); }
+	void u32(unsigned long long value) { put(value, 4); }
+	void u64(unsigned long long value) { put(value, 8); }
+	void chunk(const char* id, unsigned long long size) { bytes(id); u32(size); }
+
+	//Chunk with size bytes of filler, padded to an even size
+	void filler(const char* id, unsigned int size)
+	{
+		chunk(id, size);
+		this->data.insert(this->data.end(), size + (size & 1), 'x');
+	}
+
+	//Format chunk - extensible format has the sub format after the standard fields
+	void fmt(unsigned int channels, unsigned int bits, bool extensible)
+	{
+		chunk("fmt ", extensible ? 40 : 16);
+		u16(extensible ? WAV_FORMAT_EXTENSIBLE : WAV_FORMAT_PCM);
+		u16(channels);
+		u32(44100);
+		u32(44100 * channels * bits / 8);
+		u16(channels * bits / 8);
+		u16(bits);
+		if (extensible == true)
+		{
+			u16(22);
+			u16(bits);
+			u32(0);
+			//Sub format GUID - only the first two bytes (format tag) are used
+			u16(WAV_FORMAT_PCM);
+			this->data.insert(this->data.end(), 14, 0);
+		}
+	}
+
+	//Samples - sample n has the value sample_value(n)
+	void samples(long count)
+	{
+		for (long n = 0; n < count; n++)
+			u16((unsigned short)sample_value(n));
+	}
+
+	bool save(const std::string& filename)
+	{
+		FILE* file = fopen(filename.c_str(), "wb");
+		if (file == nullptr)
+			return false;
+		bool ok = (fwrite(this->data.data(), 1, this->data.size(), file) == this->data.size());
+		fclose(file);
+		return ok;
+	}
+
+	static short sample_value(long n) { return (short)((n * 7919) % 65536 - 32768); }
+
+private:
+	std::vector<char> data;
+
+	void put(unsigned long long value, int bytes)
+	{
+		for (int i = 0; i < bytes; i++)
+			this->data.push_back((char)((value >> (8 * i)) & 0xFF));
+	}
+};
+
+//Stream the file in chunks and compare every sample
+static void check_stream(const std::string& name, const std::string& filename, unsigned int channels, long frames, bool rf64)
+{
+	WAVReader reader;
+	eError result = reader.open(filename);
+	check(result == eSuccess, name + ": opened");
+	if (result != eSuccess)
+		return;
+
+	check((reader.get_frames() == (unsigned long long)frames) && (reader.get_format().num_channels == channels) && (reader.get_format().rf64 == rf64), name + ": format and frame count");
+
+	long n = 0;
+	long chunks = 0;
+	bool values_ok = true;
+	bool sizes_ok = true;
+	for (buffer_view<short> chunk : reader.chunks(CHUNK_FRAMES))
+	{
+		long expected = frames - chunks * CHUNK_FRAMES;
+		if (expected > CHUNK_FRAMES)
+			expected = CHUNK_FRAMES;
+		if (chunk.get_size() != expected * (long)channels)
+			sizes_ok = false;
+		for (long i = 0; i < chunk.get_size(); i++)
+		{
+			if (chunk[i] != WAVWriter::sample_value(n++))
+				values_ok = false;
+		}
+		chunks++;
+	}
+	check((sizes_ok == true) && (chunks == (frames + CHUNK_FRAMES - 1) / CHUNK_FRAMES), name + ": chunk sizes, last chunk shorter");
+	check((values_ok == true) && (n == frames * (long)channels), name + ": all samples streamed in order");
+}
+
+static void check_invalid(const std::string& name, WAVWriter& wav, const std::string& filename)
+{
+	wav.save(filename);
+	WAVReader reader;
+	check(reader.open(filename) == eAudio_InvalidWavFile, name + ": rejected");
+	remove(filename.c_str());
+}
+
+int main()
+{
+	//RIFF, mono, LIST chunk of odd size before fmt and after it
+	{
+		const long frames = 10500;
+		WAVWriter wav;
+		wav.chunk("RIFF", 4 + 8 + 17 + 1 + 8 + 16 + 8 + 3 + 1 + 8 + frames * 2);
+		wav.bytes("WAVE");
+		wav.filler("LIST", 17);
+		wav.fmt(1, 16, false);
+		wav.filler("fact", 3);
+		wav.chunk("data", frames * 2);
+		wav.samples(frames);
+		wav.save("test_riff.wav");
+		check_stream("RIFF mono, odd chunks", "test_riff.wav", 1, frames, false);
+		remove("test_riff.wav");
+	}
+
+	//RF64, stereo, extensible format - sizes only in the ds64 chunk
+	{
+		const long frames = 4321;
+		WAVWriter wav;
+		wav.chunk("RF64", WAV_RF64_SIZE);
+		wav.bytes("WAVE");
+		wav.chunk("ds64", 28);
+		wav.u64(4 + 36 + 48 + 8 + frames * 4);
+		wav.u64(frames * 4);
+		wav.u64(frames);
+		wav.u32(0);
+		wav.fmt(2, 16, true);
+		wav.chunk("data", WAV_RF64_SIZE);
+		wav.samples(frames * 2);
+		wav.save("test_rf64.wav");
+		check_stream("RF64 stereo, extensible", "test_rf64.wav", 2, frames, true);
+		remove("test_rf64.wav");
+	}
+
+	//RIFF which has been cut off while recording - data size is larger than the file
+	{
+		const long frames = 2500;
+		WAVWriter wav;
+		wav.chunk("RIFF", 0);
+		wav.bytes("WAVE");
+		wav.fmt(1, 16, false);
+		wav.chunk("data", 1000000);
+		wav.samples(frames);
+		wav.save("test_cut.wav");
+		check_stream("RIFF cut off", "test_cut.wav", 1, frames, false);
+		remove("test_cut.wav");
+	}
+
+	//RF64 without ds64 chunk - data size is unknown
+	{
+		WAVWriter wav;
+		wav.chunk("RF64", WAV_RF64_SIZE);
+		wav.bytes("WAVE");
+		wav.fmt(1, 16, false);
+		wav.chunk("data", WAV_RF64_SIZE);
+		wav.samples(100);
+		check_invalid("RF64 without ds64", wav, "test_invalid.wav");
+	}
+
+	//8 bit samples can't be viewed as short
+	{
+		WAVWriter wav;
+		wav.chunk("RIFF", 4 + 24 + 8 + 100);
+		wav.bytes("WAVE");
+		wav.fmt(1, 8, false);
+		wav.filler("data", 100);
+		check_invalid("8 bit PCM", wav, "test_invalid.wav");
+	}
+
+	//No data chunk
+	{
+		WAVWriter wav;
+		wav.chunk("RIFF", 4 + 24);
+		wav.bytes("WAVE");
+		wav.fmt(1, 16, false);
+		check_invalid("No data chunk", wav, "test_invalid.wav");
+	}
+
+	return (failures == 0) ? 0 : 1;
+}
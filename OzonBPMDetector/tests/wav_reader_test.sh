@@ -0,0 +1,3 @@
+#!/bin/bash
+#Test of the wav reader with synthetic RIFF and RF64 files - run from this directory
+g++ wav_reader_test.cpp ../WAVReader.cpp ../SplitConsole.cpp -I.. -o wav_reader_test -std=c++11 -lpthread -D_FILE_OFFSET_BITS=64 && ./wav_reader_test
@@ -0,0 +1,77 @@
+#ifndef _SAMPLE_RING_H
+#define _SAMPLE_RING_H
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+//Ring for audio samples with one writer and one reader thread
+//Neither side takes a lock or waits: if the ring is full, the writer
+//drops the samples which don't fit (and counts them), if there are not
+//enough samples, the reader gets nothing and retries later.
+template <typename T>
+class SampleRing
+{
+public:
+	//Capacity is rounded up to a power of 2
+	explicit SampleRing(size_t capacity)
+	{
+		size_t size = 1;
+		while (size < capacity)
+			size <<= 1;
+		this->data.resize(size);
+		this->mask = size - 1;
+		this->head = 0;
+		this->tail = 0;
+		this->dropped = 0;
+	}
+
+	//Writer: store samples, returns number of samples stored
+	size_t write(const T* values, size_t n)
+	{
+		size_t head = this->head.load(std::memory_order_relaxed);
+		size_t tail = this->tail.load(std::memory_order_acquire);
+		size_t space = this->data.size() - (head - tail);
+		if (n > space)
+		{
+			this->dropped.fetch_add(n - space, std::memory_order_relaxed);
+			n = space;
+		}
+		for (size_t i = 0; i < n; i++)
+			this->data[(head + i) & this->mask] = values[i];
+		this->head.store(head + n, std::memory_order_release);
+		return n;
+	}
+
+	//Reader: get exactly n samples - returns false if not enough samples are available
+	bool read(T* values, size_t n)
+	{
+		size_t tail = this->tail.load(std::memory_order_relaxed);
+		size_t head = this->head.load(std::memory_order_acquire);
+		if (head - tail < n)
+			return false;
+		for (size_t i = 0; i < n; i++)
+			values[i] = this->data[(tail + i) & this->mask];
+		this->tail.store(tail + n, std::memory_order_release);
+		return true;
+	}
+
+	//Number of samples ready for reading
+	size_t available()
+	{
+		return this->head.load(std::memory_order_acquire) - this->tail.load(std::memory_order_acquire);
+	}
+
+	//Number of samples lost because the reader was too slow
+	size_t get_dropped() { return this->dropped.load(std::memory_order_relaxed); }
+
+private:
+	std::vector<T> data;
+	size_t mask;
+	//Positions count up, the slot is position & mask
+	std::atomic<size_t> head;
+	std::atomic<size_t> tail;
+	std::atomic<size_t> dropped;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include "SlidingSTFT.hpp"
+
+SlidingSTFT::SlidingSTFT(const SlidingSTFTParam_t& param)
+{
+	this->param = param;
+
+	//History must hold all segments which are averaged, plus the samples of an incomplete hop
+	unsigned long span = param.segment_size + param.segments * param.hop_size;
+	span = std::max(span, (unsigned long)param.history_size);
+	unsigned long size = 1;
+	while (size < span)
+		size <<= 1;
+	this->history.resize(size);
+	this->mask = size - 1;
+
+	this->window.assign(param.segment_size, 1.0);
+	this->spectra.assign(param.segments, std::vector<double>(param.bins, 0.0));
+	this->spectrum.assign(param.bins, 0.0);
+	this->work.resize(param.fft_size);
+
+	this->clear();
+}
+
+void SlidingSTFT::clear()
+{
+	std::fill(this->history.begin(), this->history.end(), 0.0);
+	this->position = 0;
+	this->hop_count = 0;
+	this->newest = 0;
+	this->valid = 0;
+	this->spectrum_valid = false;
+}
+
+void SlidingSTFT::set_window(SlidingSTFTWindow_t f)
+{
+	for (int i = 0; i < this->param.segment_size; i++)
+		this->window[i] = (f != nullptr) ? f((double)i, (double)this->param.segment_size) : 1.0;
+
+	//Spectra of older segments were calculated with the old window
+	for (int k = 0; k < this->valid; k++)
+	{
+		int slot = (this->newest - k + this->param.segments) % this->param.segments;
+		transform(this->position - this->hop_count - k * this->param.hop_size, slot);
+	}
+	this->spectrum_valid = false;
+}
+
+bool SlidingSTFT::push(const buffer<double>& values)
+{
+	bool transformed = false;
+	long size = values.get_size();
+
+	for (long i = 0; i < size; i++)
+	{
+		this->history[this->position & this->mask] = values[i];
+		this->position++;
+		this->hop_count++;
+
+		//First segment is transformed when it is complete
+		if (this->position < (unsigned long)this->param.segment_size)
+			continue;
+		if ((this->position != (unsigned long)this->param.segment_size) && (this->hop_count < this->param.hop_size))
+			continue;
+
+		//Replace oldest segment
+		this->newest = (this->newest + 1) % this->param.segments;
+		transform(this->position, this->newest);
+		if (this->valid < this->param.segments)
+			this->valid++;
+		this->hop_count = 0;
+		this->spectrum_valid = false;
+		transformed = true;
+	}
+
+	return transformed;
+}
+
+bool SlidingSTFT::ready() const
+{
+	return (this->valid == this->param.segments) && (this->position >= (unsigned long)this->param.history_size);
+}
+
+void SlidingSTFT::get_history(buffer<double>& out, SlidingSTFTWindow_t f) const
+{
+	int size = this->param.history_size;
+	unsigned long start = this->position - size;
+
+	for (int i = 0; i < size; i++)
+	{
+		double value = this->history[(start + i) & this->mask];
+		out[i] = (f != nullptr) ? value * f((double)i, (double)size) : value;
+	}
+}
+
+const std::vector<double>& SlidingSTFT::get_spectrum()
+{
+	if (this->spectrum_valid == true)
+		return this->spectrum;
+
+	//Welch average of the cached segments
+	std::fill(this->spectrum.begin(), this->spectrum.end(), 0.0);
+	if (this->valid > 0)
+	{
+		for (int k = 0; k < this->valid; k++)
+		{
+			const std::vector<double>& s = this->spectra[(this->newest - k + this->param.segments) % this->param.segments];
+			for (size_t b = 0; b < this->spectrum.size(); b++)
+				this->spectrum[b] += s[b];
+		}
+		for (size_t b = 0; b < this->spectrum.size(); b++)
+			this->spectrum[b] /= this->valid;
+	}
+
+	this->spectrum_valid = true;
+	return this->spectrum;
+}
+
+void SlidingSTFT::transform(unsigned long end, int slot)
+{
+	int n = this->param.segment_size;
+	unsigned long start = end - n;
+
+	//Window straight out of the history - zero padding is done by the pruned FFT
+	for (int i = 0; i < n; i++)
+		this->work[i] = complex(this->history[(start + i) & this->mask] * this->window[i], 0.0);
+
+	CFFT::ForwardPruned(this->work.data(), this->param.fft_size, n, this->param.bins);
+
+	std::vector<double>& s = this->spectra[slot];
+	for (size_t b = 0; b < s.size(); b++)
+		s[b] = std::norm(this->work[b]) / n;
+}
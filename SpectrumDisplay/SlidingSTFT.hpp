@@ -0,0 +1,89 @@
+#ifndef _SLIDING_STFT_H
+#define _SLIDING_STFT_H
+
+#include <vector>
+#include <functional>
+#include "buffer.hpp"
+#include "CFFT.hpp"
+
+//Window function f(index, size) - same signature as DSP::apply_window
+typedef std::function<double(double, double)> SlidingSTFTWindow_t;
+
+//Parameters for the sliding STFT
+//With the default values, the spectrum is the average of the last 4 segments
+//of 256 samples, each zero padded to 1024 samples (no overlap).
+struct SlidingSTFTParam_t
+{
+	//Samples per segment
+	int segment_size = 256;
+	//Samples between two segments - overlap is segment_size - hop_size
+	int hop_size = 256;
+	//Number of segments averaged (Welch)
+	int segments = 4;
+	//FFT length, segments are zero padded (power of 2, >= segment_size)
+	int fft_size = 1024;
+	//Samples kept for get_history
+	int history_size = 1024;
+	//Number of spectrum bins needed (<= fft_size / 2) - the FFT skips the others
+	int bins = 512;
+};
+
+//Streaming STFT with Welch averaging
+//Samples are stored in a circular history, nothing is shifted. Every hop_size
+//samples, only the newest segment is windowed (directly from the history) and
+//transformed, the spectra of the older segments are taken from the cache.
+//The FFT skips the zero padding and the bins which are not needed.
+class SlidingSTFT
+{
+public:
+	SlidingSTFT(const SlidingSTFTParam_t& param = SlidingSTFTParam_t());
+
+	//Set window for the segments - nullptr for rectangular window
+	//Cached spectra are recalculated from the history
+	void set_window(SlidingSTFTWindow_t f);
+
+	//Add samples - returns true if at least one new segment has been transformed
+	bool push(const buffer<double>& values);
+	//History and all segments are filled
+	bool ready() const;
+	//Reset history and cache
+	void clear();
+
+	//Copy the last history_size samples (oldest first) to out, optionally windowed
+	//out must have history_size samples
+	void get_history(buffer<double>& out, SlidingSTFTWindow_t f = nullptr) const;
+	//Averaged power spectrum with bins entries, |X|^2 / segment_size
+	const std::vector<double>& get_spectrum();
+
+	const SlidingSTFTParam_t& get_param() const { return this->param; }
+
+private:
+	SlidingSTFTParam_t param;
+
+	//Circular history - positions count up, the slot is position & mask
+	std::vector<double> history;
+	unsigned long mask;
+	unsigned long position;
+	//Samples since last segment
+	int hop_count;
+
+	//Window coefficients for one segment
+	std::vector<double> window;
+
+	//Cached power spectra of the last segments (ring of segments entries)
+	std::vector<std::vector<double>> spectra;
+	int newest;
+	int valid;
+
+	//Averaged spectrum and flag if it has to be recalculated
+	std::vector<double> spectrum;
+	bool spectrum_valid;
+
+	//FFT work buffer
+	std::vector<complex> work;
+
+	//Transform segment ending at position end into cache slot
+	void transform(unsigned long end, int slot);
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef _TRIPLE_BUFFER_H
+#define _TRIPLE_BUFFER_H
+
+#include <atomic>
+
+//Handoff of frames from one writer to one reader thread
+//The writer always has a free buffer to fill and the reader always
+//gets the newest complete frame - nobody waits, older frames are skipped.
+template <typename T>
+class TripleBuffer
+{
+public:
+	TripleBuffer()
+	{
+		this->back_index = 0;
+		this->middle = 1;
+		this->front_index = 2;
+	}
+
+	//Writer: buffer to fill
+	T& back() { return this->buffers[this->back_index]; }
+	//Writer: hand filled buffer over to the reader
+	void publish()
+	{
+		int old = this->middle.exchange(this->back_index | NEW_FRAME, std::memory_order_acq_rel);
+		this->back_index = old & INDEX_MASK;
+	}
+
+	//Reader: take newest frame if there is one - returns false if nothing new has been published
+	bool update()
+	{
+		if ((this->middle.load(std::memory_order_acquire) & NEW_FRAME) == 0)
+			return false;
+		int old = this->middle.exchange(this->front_index, std::memory_order_acq_rel);
+		this->front_index = old & INDEX_MASK;
+		return true;
+	}
+	//Reader: frame taken with last update
+	const T& front() { return this->buffers[this->front_index]; }
+
+private:
+	static const int INDEX_MASK = 3;
+	static const int NEW_FRAME = 4;
+
+	T buffers[3];
+	//Buffer between writer and reader, flag marks unread frame
+	std::atomic<int> middle;
+	//Owned by writer and reader
+	int back_index;
+	int front_index;
+};
+
+#endif
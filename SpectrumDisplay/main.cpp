@@ -2,6 +2,10 @@
 #include <vector>
 #include <string>
 #include <cmath> 
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
 #include <alsa/asoundlib.h>
 
 #include "DSP.hpp"
@@ -11,6 +15,11 @@
 #include "FCWindowLabel.hpp"
 #include "buffer.hpp"
 #include "CFFT.hpp"
+#include "SampleRing.hpp"
+#include "TripleBuffer.hpp"
+#include "SlidingSTFT.hpp"
+#include "SlidingDFT.hpp"
+#include "Filterbank.hpp"
 
 //Global data for audio capture
 snd_pcm_t *capture_handle;
@@ -22,21 +31,42 @@ unsigned int num_frames_rec = 256;
 //Number of bins considered in calculation
 const int fft_bins = 120;
 //Number of bins displayed in graph
-int fft_bars = 11;
-
-//Buffer for audio data
-short* buf = (short*)malloc(num_frames_rec * sizeof(short));
+const int fft_bars = 11;
+//Upper band limits of the bars
+const double bar_freqs[fft_bars] = { 50, 100, 200, 300, 500, 1000, 2000, 3000, 5000, 10000, 20000 };
+
+//Capacity of sample ring between capture and analysis (~0.75s)
+const size_t ring_size = 32768;
+//Wait time of capture thread - stop flag is checked in between
+const int capture_wait_ms = 100;
+//Wait time of analysis and display loops if there is nothing to do
+const int idle_wait_ms = 1;
+
+//Pipeline: capture thread -> sample ring -> analysis thread -> triple buffer -> main thread (windows)
+SampleRing<short> sample_ring(ring_size);
+
+//Spectrum frame handed over to the windows
+struct SpectrumFrame_t
+{
+	double values[fft_bins];
+	int key1;
+	int key2;
+};
+TripleBuffer<SpectrumFrame_t> frames;
 
-//Different buffers for average fft calculation
-buffer<double> b1, b2, b3, b4;
-buffer<double> c1, c2, c3, c4;
-buffer<double> f1, f2, f3, f4;
+//Threads keep running while flag is set
+std::atomic<bool> running(true);
+//Number of xruns recovered by capture thread
+std::atomic<int> xruns(0);
 
 //Window size information
 FCWindowSpectrumSize_t size_param;
-//Window key information
-int key1 = 0;
-int key2 = 0;
+//Window key information - set by GLUT thread, read by analysis thread
+//Key 1 selects the analysis mode (-1: pruned FFT, 0: FFT, 1: STFT, 2: bands, 3: STFT filterbank)
+const int key1_min = -1;
+const int key1_max = 3;
+std::atomic<int> key1(0);
+std::atomic<int> key2(0);
 
 //Keyboard callback
 void keyboard_callback(unsigned char key, int x, int y)
@@ -71,10 +101,12 @@ void keyboard_callback(unsigned char key, int x, int y)
 			break;
 
 		case 'f':
-			key1++;
+			if (key1.load() < key1_max)
+				key1++;
 			break;
 		case 'F':
-			key1--;
+			if (key1.load() > key1_min)
+				key1--;
 			break;
 		case 'w':
 			key2++;
@@ -86,11 +118,11 @@ void keyboard_callback(unsigned char key, int x, int y)
 }
 
 //Capture callback
-int capture_callback (snd_pcm_sframes_t nframes)
+int capture_callback (short* buf, snd_pcm_sframes_t nframes)
 {
 	int err;
 	if ((err = snd_pcm_readi(capture_handle, buf, nframes)) < 0) {
-		std::cout << "write failed " << snd_strerror(err) << std::endl;
+		std::cout << "read failed " << snd_strerror(err) << std::endl;
 	}
 	return err;
 }
@@ -120,33 +152,22 @@ public:
     }
 };
 
-void process_array(double* in_array, double* out_array)
+//Filterbank for the bars - bins are averaged over the bands of bar_freqs
+Filterbank bar_filterbank()
 {
-	//Use logarithmic spacing
-	double fvalues[fft_bars] = { 50, 100, 200, 300, 500, 1000, 2000, 3000, 5000, 10000, 20000 };
-	double fmax = (double)sample_rate / 2;
-	double freq_res = sample_rate / num_frames_tot;
-
-	int act_index = 0;
-	int count = 0;
-	int avg_count = 1;
-	for (int i = 0; i < fft_bins; i++)
-	{
-		double act_freq = i * freq_res;
-		if (act_freq >= fvalues[count])
-		{
-			count++;
-			avg_count = 1;
-			out_array[count] = in_array[i];
-		}
-		else
-		{
-			out_array[count] = out_array[count] * avg_count;
-			out_array[count] += in_array[i];
-			avg_count++;
-			out_array[count] /= avg_count;
-		}
-	}
+	std::vector<double> edges(1, 0.0);
+	edges.insert(edges.end(), bar_freqs, bar_freqs + fft_bars);
+
+	Filterbank bank;
+	bank.build(edges, num_frames_tot, sample_rate, eFilterbankRect, fft_bins);
+	return bank;
+}
+
+void process_array(const double* in_array, double* out_array)
+{
+	//Weights are calculated with the first call
+	static Filterbank bank = bar_filterbank();
+	bank.apply(in_array, out_array);
 }
 
 void init_audio()
@@ -246,81 +267,44 @@ void init_audio()
 	}
 }
 
-void average_window(buffer<double>& buf, int option, double par = 0.5)
+//Window function for key 2 option - nullptr for rectangular window
+SlidingSTFTWindow_t window_function(int option, double par = 0.5)
 {
 	if (option == 1)
-	{
-		DSP::apply_window(buf, DSP::hanning);
-	}
+		return [](double x, double N) { return DSP::hanning(x, N); };
 	if (option == 2)
-	{	
-		DSP::apply_window(buf, DSP::hamming, par);
-	}
+		return [par](double x, double N) { return DSP::hamming(x, N, par); };
 	if (option == 3)
-	{	
-		DSP::apply_window(buf, DSP::blackman, par);
-	}
+		return [par](double x, double N) { return DSP::blackman(x, N, par); };
 	if (option == 4)
-	{	
-		DSP::apply_window(buf, DSP::blackman_harris);
-	}
+		return [](double x, double N) { return DSP::blackman_harris(x, N); };
 	if (option == 5)
-	{	
-		DSP::apply_window(buf, DSP::flat_top);
-	}
+		return [](double x, double N) { return DSP::flat_top(x, N); };
 	if (option == 6)
-	{	
-		DSP::apply_window(buf, DSP::tukey, par);
-	}
+		return [par](double x, double N) { return DSP::tukey(x, N, par); };
+	return nullptr;
 }
 
-void average_fft(buffer<double>& in, buffer<double>& out, int option)
+//Create one sliding DFT bin per bar band (only bands within the displayed
+//range) and assign each spectrum bar to its band
+void init_bands(SlidingDFT& bands, int* bar_band)
 {
-	long s = in.get_size();
-	long N = s / 4;
-
-	for (long i = 0; i < s; i++)
-	{
-		if (i < N)
-			b1[i] = in[i];
-		else if (i < 2*N)
-			b2[i - N] = in[i];
-		else if (i < 3*N)
-			b3[i - 2*N] = in[i];
-		else 
-			b4[i - 3*N] = in[i];
-	}
+	double freq_res = (double)sample_rate / num_frames_tot;
+	double freq_max = fft_bins * freq_res;
 
-	static int option_old = 0;
-	if (option_old != option)
+	double freq_low = 0.0;
+	for (int b = 0; b < fft_bars && freq_low < freq_max; b++)
 	{
-		std::cout << "option = " << option << std::endl;
-		option_old = option;
+		bands.add_band(freq_low, bar_freqs[b]);
+		freq_low = bar_freqs[b];
 	}
 
-	average_window(b1, option);
-	average_window(b2, option);
-	average_window(b3, option);
-	average_window(b4, option);
-
-	DSP::zero_padding(b1, c1);
-	DSP::zero_padding(b2, c2);
-	DSP::zero_padding(b3, c3);
-	DSP::zero_padding(b4, c4);
-
-	DSP::perform_fft(c1, f1, +1);
-	DSP::perform_fft(c2, f2, +1);
-	DSP::perform_fft(c3, f3, +1);
-	DSP::perform_fft(c4, f4, +1);
-
-	for (long i = 0; i < s * 2; i += 2)
+	for (int i = 0; i < fft_bins; i++)
 	{
-		double val1 = 4.0 / num_frames_tot * (f1[i]*f1[i] + f1[i+1]*f1[i+1]);
-		double val2 = 4.0 / num_frames_tot * (f2[i]*f2[i] + f2[i+1]*f2[i+1]);
-		double val3 = 4.0 / num_frames_tot * (f3[i]*f3[i] + f3[i+1]*f3[i+1]);
-		double val4 = 4.0 / num_frames_tot * (f4[i]*f4[i] + f4[i+1]*f4[i+1]);
-		
-		out[i / 2] = (val1 + val2 + val3 + val4) / 4.0; 
+		int b = 0;
+		while ((b < bands.get_bins() - 1) && (i * freq_res >= bar_freqs[b]))
+			b++;
+		bar_band[i] = b;
 	}
 }
 
@@ -336,28 +320,222 @@ void env_array(double* buffer_old, double* buffer_new, int size, double rec)
 	}
 }
 	      
-int main (int argc, char **argv)
+//Capture thread - only reads the device and feeds the ring
+//Never waits for analysis or rendering, xruns are recovered
+void capture_loop()
 {
-	//Clear screen
-	std::cout << "\033[2J\033[1;1H";
+	int err;
+	snd_pcm_sframes_t frames_to_deliver;
+	short* buf = new short[num_frames_rec];
+
+	while (running.load() == true)
+	{
+		/* wait till the interface is ready for data, or the
+		   wait time has elapsed.
+		*/
+	
+		if ((err = snd_pcm_wait(capture_handle, capture_wait_ms)) < 0) {
+			//Overrun or suspend - restart the device and go on
+			xruns++;
+			if (snd_pcm_recover(capture_handle, err, 1) < 0) {
+				std::cout << "poll failed " << snd_strerror(err) << std::endl;
+				break;
+			}
+			continue;
+		}
+		if (err == 0)
+			continue;
+	
+		/* find out how much data is available */
+	
+		if ((frames_to_deliver = snd_pcm_avail_update(capture_handle)) < 0) {
+			xruns++;
+			if (snd_pcm_recover(capture_handle, frames_to_deliver, 1) < 0) {
+				std::cout << "unknown ALSA avail update return value" << std::endl;
+				break;
+			}
+			continue;
+		}
+	
+		frames_to_deliver = frames_to_deliver > num_frames_rec ? num_frames_rec : frames_to_deliver;
+	
+		/* deliver the data */
+
+		if ((err = capture_callback(buf, frames_to_deliver)) < 0) {
+			xruns++;
+			if (snd_pcm_recover(capture_handle, err, 1) < 0)
+				break;
+			continue;
+		}
 
+		//If analysis can't keep up, the ring drops the samples
+		sample_ring.write(buf, err);
+	}
+
+	delete[] buf;
+}
+
+//Analysis thread - takes blocks of num_frames_rec samples from the ring
+//and publishes a spectrum frame for each block
+void analysis_loop()
+{
 	//Initialize buffers
 	buffer<double> data_rec; //256
 	buffer<double> data_nor; //256
 	buffer<double> data_tot; //1024
-	buffer<double> data_avg; //1024
 	data_rec.init_buffer(num_frames_rec, sample_rate);
 	data_nor.init_buffer(num_frames_rec, sample_rate);
 	data_tot.init_buffer(num_frames_tot, sample_rate);
-	data_avg.init_buffer(num_frames_tot, sample_rate);
 
 	buffer<double> fft; //2048
 	fft.init_buffer(num_frames_tot * 2, sample_rate);
-	buffer<double> fft2; //1024
-	fft2.init_buffer(num_frames_tot, sample_rate);
 
 	static double sarray[fft_bins] = { };
 
+	//Sliding STFT - history of num_frames_tot samples, Welch average of
+	//4 segments with num_frames_rec samples each, zero padded to num_frames_tot
+	SlidingSTFTParam_t stft_param;
+	stft_param.segment_size = num_frames_rec;
+	stft_param.hop_size = num_frames_rec;
+	stft_param.segments = num_frames_tot / num_frames_rec;
+	stft_param.fft_size = num_frames_tot;
+	stft_param.history_size = num_frames_tot;
+	stft_param.bins = fft_bins;
+	SlidingSTFT stft(stft_param);
+	int window_option = 0;
+
+	//Band energy mode (key 1 = 2) - sliding DFT bin for each band,
+	//cost per sample depends on the number of bands, not on the FFT size
+	SlidingDFT bands(sample_rate);
+	int bar_band[fft_bins];
+	init_bands(bands, bar_band);
+
+	complex* pSignal = new complex[num_frames_tot];
+	short* buf = new short[num_frames_rec];
+
+	while (running.load() == true)
+	{
+		//Wait for next block
+		if (sample_ring.read(buf, num_frames_rec) == false)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(idle_wait_ms));
+			continue;
+		}
+
+		//Keys may change while processing - use one value per block
+		int k1 = key1.load();
+		int k2 = key2.load();
+		
+		//Start spectrum analysis
+		double maxval = -std::numeric_limits<short>::min();
+		for (unsigned int i = 0; i < num_frames_rec; i++)
+			data_rec[i] = (double)buf[i] / maxval;
+
+		DSP::cut_dc_offset(data_rec, data_nor);
+
+		//Window of the segments has changed - the cached spectra are recalculated
+		if (window_option != k2)
+		{
+			std::cout << "option = " << k2 << std::endl;
+			stft.set_window(window_function(k2));
+			window_option = k2;
+		}
+
+		if (k1 == 2)
+		{
+			//Only the band bins are updated - no FFT
+			bands.process(data_nor);
+		}
+		else
+		{
+			//Add block to history - the first blocks only fill the history
+			stft.push(data_nor);
+			if (stft.ready() == false)
+				continue;
+		}
+
+		if (k1 == -1)
+		{
+			stft.get_history(data_tot);
+			for (long i = 0; i < num_frames_tot; i++)
+			{
+				pSignal[i].real(data_tot[i]);
+				pSignal[i].imag(0.0);
+			}
+		
+			//Only the displayed bins are calculated
+			CFFT::ForwardPruned(pSignal, num_frames_tot, num_frames_tot, fft_bins);
+			for (long i = 0; i < num_frames_tot; i++)
+			{
+				fft[2 * i] = pSignal[i].real();
+				fft[2 * i + 1] = pSignal[i].imag();
+			}
+		}
+
+		if (k1 == 0)
+		{
+			//Whole history with window
+			stft.get_history(data_tot, window_function(k2));
+			DSP::perform_fft(data_tot, fft, +1);
+		}
+
+		//Create spectrum frame in the free buffer - the buffer still holds an old frame
+		SpectrumFrame_t& frame = frames.back();
+		double* array = frame.values;
+		std::fill(array, array + fft_bins, 0.0);
+
+		if (k1 == 0 || k1 == -1)
+		{
+			//Power of the displayed bins
+			for (int i = 0; i < fft_bins; i++)
+			{
+				double val = 1.0 / (double)num_frames_tot * (fft[2 * i] * fft[2 * i] + fft[2 * i + 1] * fft[2 * i + 1]);
+				array[i] = 10 * log10(val);
+			}
+		}
+		if (k1 == 1)
+		{
+			//Averaged spectrum of the segments
+			const std::vector<double>& spectrum = stft.get_spectrum();
+			for (int i = 0; i < fft_bins; i++)
+				array[i] = 10 * log10(spectrum[i]);
+		}				
+		if (k1 == 2)
+		{
+			//All bars of a band show the band energy
+			for (int i = 0; i < fft_bins; i++)
+				array[i] = 10 * log10(bands.get_power(bar_band[i]));
+		}
+		if (k1 == 3)
+		{
+			//Averaged spectrum reduced to the bars by the filterbank,
+			//all bins of a bar show the bar value
+			double bars[fft_bars] = { };
+			process_array(stft.get_spectrum().data(), bars);
+			for (int i = 0; i < fft_bins; i++)
+				array[i] = 10 * log10(bars[bar_band[i]]);
+		}
+
+		//Envelope for spectrum values (looks smoother)
+		env_array(sarray, array, fft_bins, 0.05);
+		for (int i = 0; i < fft_bins; i++)
+			sarray[i] = array[i];
+
+		//Hand over to display - the display always takes the newest frame
+		frame.key1 = k1;
+		frame.key2 = k2;
+		frames.publish();
+	}
+
+	delete[] buf;
+	delete[] pSignal;
+}
+	      
+int main (int argc, char **argv)
+{
+	//Clear screen
+	std::cout << "\033[2J\033[1;1H";
+
 	size_param.max_value = 0.0;
 	size_param.min_value = -100.0;
 	
@@ -387,174 +565,54 @@ int main (int argc, char **argv)
 	//Set additional callback for keys
 	window->set_keyboard_callback(keyboard_callback);
 	
-
 	init_audio();
 
-	int err;
-	snd_pcm_sframes_t frames_to_deliver;
-
-	b1.init_buffer(num_frames_rec, sample_rate);
-	b2.init_buffer(num_frames_rec, sample_rate);
-	b3.init_buffer(num_frames_rec, sample_rate);
-	b4.init_buffer(num_frames_rec, sample_rate);
-	c1.init_buffer(num_frames_tot, sample_rate);
-	c2.init_buffer(num_frames_tot, sample_rate);
-	c3.init_buffer(num_frames_tot, sample_rate);
-	c4.init_buffer(num_frames_tot, sample_rate);
-	
-	f1.init_buffer(num_frames_tot * 2, sample_rate);
-	f2.init_buffer(num_frames_tot * 2, sample_rate);
-	f3.init_buffer(num_frames_tot * 2, sample_rate);
-	f4.init_buffer(num_frames_tot * 2, sample_rate);
+	//Start pipeline
+	std::thread capture_thread(capture_loop);
+	std::thread analysis_thread(analysis_loop);
 
-	complex* pSignal = new complex[num_frames_tot];
-	
-	while(1) 
+	//Display loop - hands the newest spectrum frame to the windows
+	FCWindowSpectrumData_t win_data;
+	win_data.values.resize(fft_bins);
+	while (window->get_quit() == false)
 	{
-	
-		/* wait till the interface is ready for data, or 1 second
-		   has elapsed.
-		*/
-	
-		if ((err = snd_pcm_wait(capture_handle, 1000)) < 0) {
-		        std::cout << "poll failed " << snd_strerror(err) << std::endl;
-		        break;
-		}	           
-	
-		/* find out how much space is available for playback data */
-	
-		if ((frames_to_deliver = snd_pcm_avail_update(capture_handle)) < 0) {
-			if (frames_to_deliver == -EPIPE) {
-				std::cout << "an xrun occured" << std::endl;
-				break;
-			} else {
-				std::cout << "unknown ALSA avail update return value" << std::endl;
-				break;
-			}
-		}
-
-		//std::cout << "Frames to deliver: " << frames_to_deliver << std::endl;
-	
-		frames_to_deliver = frames_to_deliver > num_frames_rec ? num_frames_rec : frames_to_deliver;
-	
-		/* deliver the data */
-	
-		if (capture_callback(frames_to_deliver) != frames_to_deliver) {
-		        std::cout << "capture callback failed" << std::endl;
-			break;
-		}
-		
-		//Start spectrum analysis
-		double maxval = -std::numeric_limits<short>::min();
-		for (unsigned int i = 0; i < num_frames_rec; i++)
-			data_rec[i] = (double)buf[i] / maxval;
-
-		DSP::cut_dc_offset(data_rec, data_nor);
-
-		//Number of recorded frames -> z
-		//For the first recorded frames, we have to fill the
-		//buffer with frames, before it can be moved (slide)
-		static unsigned int z = 0;
-
-		if (z < 4)
-		{
-			for (long i = 0; i < num_frames_rec; i++)
-				data_tot[z * num_frames_rec + i] = data_nor[i];
-		}
-		else
+		if (frames.update() == false)
 		{
-			DSP::sliding_window(data_nor, data_tot);
-
-			if (key1 == -1)
-			{
-				for (long i = 0; i < num_frames_tot; i++)
-				{
-					pSignal[i].real(data_tot[i]);
-					pSignal[i].imag(0.0);
-				}
-			
-				CFFT::Forward(pSignal, num_frames_tot);
-				for (long i = 0; i < num_frames_tot; i++)
-				{
-					fft[2 * i] = pSignal[i].real();
-					fft[2 * i + 1] = pSignal[i].imag();
-				}
-			}
-
-			if (key1 == 0)
-			{
-				//DSP::apply_window(data_tot, DSP::hanning);
-				average_window(data_tot, key2);
-				DSP::perform_fft(data_tot, fft, +1);
-			}
-			if (key1 == 1)
-			{
-				average_fft(data_tot, fft2, key2);
-			}
-
-			double freq_res = sample_rate / num_frames_tot;
-	
-			std::vector<std::pair<double, double>> fft_values;
-			for (long i = 0; i < fft.get_size() / 2; i+=2)
-			{
-				double val = 1.0 / (double)num_frames_tot * (fft[i] * fft[i] + fft[i + 1] * fft[i + 1]);
-				fft_values.push_back(std::pair<double, double>((double)i / 2 * freq_res, val));
-			}
-
-			//Create data for spectrum window
-			FCWindowSpectrumData_t win_data;
-			double array[fft_bins] = { };
-
-			if (key1 == 0 || key1 == -1)
-			{
-				for (int i = 0; i < fft_bins; i++)
-					array[i] = 10 * log10(fft_values.at(i).second);
-			}
-			if (key1 == 1)
-			{
-				for (int i = 0; i < fft_bins; i++)
-					array[i] = 10 * log10(fft2[i]);
-			}				
-
-			//double arr[fft_bars] = { };
-			//process_array(array, arr);	
-	
-			//Envelope for spectrum values (looks smoother)
-			env_array(sarray, array, fft_bins, 0.05);
-			for (int i = 0; i < fft_bins; i++)
-			{
-				sarray[i] = array[i];
-				win_data.values.push_back(array[i]);
-			}
-			//Update spectrum data
-			window->update(&win_data);
-			
-			//Create data for second window
-			FCWindowLabelData_t label_data;
-			FCWindowLabelDataItem_t label_items;
-			label_items.text = "Key 1: " + std::to_string(key1);
-			label_data.items.push_back(label_items);
-			label_items.y = 150;
-			label_items.text = "Key 2: " + std::to_string(key2);
-			label_data.items.push_back(label_items);
-			//Update label data
-			window2->update(&label_data);
+			std::this_thread::sleep_for(std::chrono::milliseconds(idle_wait_ms));
+			continue;
 		}
+		const SpectrumFrame_t& frame = frames.front();
 
-		z++;
-	
-		//Check if quit issued
-		if (window->get_quit() == true)
-			break;
+		//Update spectrum data
+		for (int i = 0; i < fft_bins; i++)
+			win_data.values[i] = frame.values[i];
+		window->update(&win_data);
+		
+		//Create data for second window
+		FCWindowLabelData_t label_data;
+		FCWindowLabelDataItem_t label_items;
+		label_items.text = "Key 1: " + std::to_string(frame.key1);
+		label_data.items.push_back(label_items);
+		label_items.y = 150;
+		label_items.text = "Key 2: " + std::to_string(frame.key2);
+		label_data.items.push_back(label_items);
+		label_items.y = 200;
+		label_items.text = "Xruns: " + std::to_string(xruns.load()) + " Dropped: " + std::to_string(sample_ring.get_dropped());
+		label_data.items.push_back(label_items);
+		//Update label data
+		window2->update(&label_data);
 	}
+
+	//Stop pipeline
+	running.store(false);
+	capture_thread.join();
+	analysis_thread.join();
 	
 	FCWindowManager::stop();
 	std::this_thread::sleep_for(std::chrono::seconds(1));
 
 	delete window;
 	delete window2;
-
-	delete[] pSignal;
 	
 	snd_pcm_close(capture_handle);
 	return 0;